@@ -0,0 +1,127 @@
+#include <array>
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Compare access by chain of operator[] with direct operator() for Dimension 1..6
+
+namespace {
+
+constexpr size_t elements = 1 << 16;
+
+template <size_t Dimension>
+std::vector<std::array<size_t, Dimension>> random_indices(size_t count) {
+    std::mt19937_64 random{1};
+    std::vector<std::array<size_t, Dimension>> result(count);
+    for (auto &indices : result) {
+        for (auto &idx : indices) {
+            idx = random() % 1024;
+        }
+    }
+    return result;
+}
+
+/// Apply operator[] for each index starting from I
+template <size_t I, size_t Dimension>
+struct Chain {
+    template <typename Layout>
+    static auto apply(Layout &&layout, const std::array<size_t, Dimension> &indices) {
+        return Chain<I + 1, Dimension>::apply(layout[indices[I]], indices);
+    }
+};
+
+template <size_t Dimension>
+struct Chain<Dimension, Dimension> {
+    template <typename Layout>
+    static std::decay_t<Layout> apply(Layout &&layout, const std::array<size_t, Dimension> &) {
+        return std::forward<Layout>(layout);
+    }
+};
+
+template <typename MatrixType, size_t Dimension, size_t... I>
+auto direct(MatrixType &matrix, const std::array<size_t, Dimension> &indices,
+            std::index_sequence<I...>) {
+    return matrix(indices[I]...);
+}
+
+template <size_t Dimension>
+struct ByChain {
+    template <typename MatrixType>
+    static auto access(MatrixType &matrix, const std::array<size_t, Dimension> &indices) {
+        return Chain<0, Dimension>::apply(matrix, indices);
+    }
+};
+
+template <size_t Dimension>
+struct ByCall {
+    template <typename MatrixType>
+    static auto access(MatrixType &matrix, const std::array<size_t, Dimension> &indices) {
+        return direct(matrix, indices, std::make_index_sequence<Dimension>{});
+    }
+};
+
+template <size_t Dimension, template <size_t> class Access>
+void BM_Read(benchmark::State &state) {
+    const auto indices = random_indices<Dimension>(elements);
+    otus::Matrix<int, 0, Dimension> matrix;
+    for (size_t i = 0; i < indices.size(); i += 2) {
+        Access<Dimension>::access(matrix, indices[i]) = 1;
+    }
+    const auto &const_matrix = matrix;
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto &idx : indices) {
+            sum += Access<Dimension>::access(const_matrix, idx);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.counters["per_access"] = benchmark::Counter(
+        static_cast<double>(elements),
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+template <size_t Dimension, template <size_t> class Access>
+void BM_Write(benchmark::State &state) {
+    const auto indices = random_indices<Dimension>(elements);
+    otus::Matrix<int, 0, Dimension> matrix;
+    for (auto _ : state) {
+        int value = 0;
+        for (const auto &idx : indices) {
+            Access<Dimension>::access(matrix, idx) = value++ & 1;
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.counters["per_access"] = benchmark::Counter(
+        static_cast<double>(elements),
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Read, 1, ByChain);
+BENCHMARK_TEMPLATE(BM_Read, 1, ByCall);
+BENCHMARK_TEMPLATE(BM_Read, 2, ByChain);
+BENCHMARK_TEMPLATE(BM_Read, 2, ByCall);
+BENCHMARK_TEMPLATE(BM_Read, 3, ByChain);
+BENCHMARK_TEMPLATE(BM_Read, 3, ByCall);
+BENCHMARK_TEMPLATE(BM_Read, 4, ByChain);
+BENCHMARK_TEMPLATE(BM_Read, 4, ByCall);
+BENCHMARK_TEMPLATE(BM_Read, 5, ByChain);
+BENCHMARK_TEMPLATE(BM_Read, 5, ByCall);
+BENCHMARK_TEMPLATE(BM_Read, 6, ByChain);
+BENCHMARK_TEMPLATE(BM_Read, 6, ByCall);
+BENCHMARK_TEMPLATE(BM_Write, 1, ByChain);
+BENCHMARK_TEMPLATE(BM_Write, 1, ByCall);
+BENCHMARK_TEMPLATE(BM_Write, 2, ByChain);
+BENCHMARK_TEMPLATE(BM_Write, 2, ByCall);
+BENCHMARK_TEMPLATE(BM_Write, 3, ByChain);
+BENCHMARK_TEMPLATE(BM_Write, 3, ByCall);
+BENCHMARK_TEMPLATE(BM_Write, 4, ByChain);
+BENCHMARK_TEMPLATE(BM_Write, 4, ByCall);
+BENCHMARK_TEMPLATE(BM_Write, 5, ByChain);
+BENCHMARK_TEMPLATE(BM_Write, 5, ByCall);
+BENCHMARK_TEMPLATE(BM_Write, 6, ByChain);
+BENCHMARK_TEMPLATE(BM_Write, 6, ByCall);
@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+#include <otus/arena.hpp>
+#include <otus/matrix.hpp>
+#include <cstddef>
+#include <memory>
+
+// Build and destroy a request-scoped matrix: count of heap allocations and time
+// with the default allocator, the arena and std::pmr resources
+
+namespace {
+
+size_t heap_allocations = 0;
+
+/// std::allocator which counts allocations
+template <typename T>
+struct CountingAllocator : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+        using other = CountingAllocator<U>;
+    };
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U> &) noexcept {} // NOLINT
+
+    T *allocate(size_t count) {
+        ++heap_allocations;
+        return std::allocator<T>::allocate(count);
+    }
+};
+
+template <typename MatrixType, typename... Args>
+size_t fill(size_t count, Args &&... args) {
+    MatrixType matrix(std::forward<Args>(args)...);
+    for (size_t i = 0; i < count; ++i) {
+        matrix[i % 1024][i / 1024] = static_cast<long>(i) + 1;
+    }
+    return matrix.size();
+}
+
+template <typename Storage>
+void BM_AllocatorDefault(benchmark::State &state) {
+    using MatrixType =
+        otus::Matrix<long, 0, 2, Storage, otus::StorageAllocator<CountingAllocator<char>>>;
+    heap_allocations = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fill<MatrixType>(static_cast<size_t>(state.range(0))));
+    }
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(heap_allocations), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Storage>
+void BM_AllocatorArena(benchmark::State &state) {
+    using Allocator = otus::ArenaAllocator<char>;
+    using MatrixType = otus::Matrix<long, 0, 2, Storage, otus::StorageAllocator<Allocator>>;
+    size_t allocations = 0;
+    for (auto _ : state) {
+        otus::Arena arena;
+        benchmark::DoNotOptimize(
+            fill<MatrixType>(static_cast<size_t>(state.range(0)), Allocator(arena)));
+        allocations += arena.allocations();
+    }
+    state.counters["allocations"] = benchmark::Counter(static_cast<double>(allocations),
+                                                       benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#if defined(OTUS_MATRIX_HAS_PMR)
+/// Upstream resource which counts allocations
+class CountingResource : public std::pmr::memory_resource {
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        ++heap_allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *pointer, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+template <typename Storage, typename Resource>
+void BM_AllocatorPmr(benchmark::State &state) {
+    using MatrixType = otus::Matrix<long, 0, 2, Storage, otus::PmrAllocator>;
+    CountingResource upstream;
+    heap_allocations = 0;
+    for (auto _ : state) {
+        Resource resource(&upstream);
+        benchmark::DoNotOptimize(fill<MatrixType>(static_cast<size_t>(state.range(0)),
+                                                  typename MatrixType::allocator_type(&resource)));
+    }
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(heap_allocations), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+#endif
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_AllocatorDefault, otus::UnorderedStorage)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_AllocatorArena, otus::UnorderedStorage)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_AllocatorDefault, otus::FlatStorage)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_AllocatorArena, otus::FlatStorage)->Range(1 << 10, 1 << 18);
+#if defined(OTUS_MATRIX_HAS_PMR)
+BENCHMARK_TEMPLATE(BM_AllocatorPmr, otus::UnorderedStorage, std::pmr::monotonic_buffer_resource)
+    ->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_AllocatorPmr, otus::UnorderedStorage,
+                   std::pmr::unsynchronized_pool_resource)
+    ->Range(1 << 10, 1 << 18);
+#endif
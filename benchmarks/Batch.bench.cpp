@@ -0,0 +1,139 @@
+#include <array>
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <random>
+#include <vector>
+
+// Batched lookups get_many()/set_many() with prefetching vs one element at a time by
+// operator[]. The matrix holds 8M elements (far more than caches), the argument is the
+// count of scattered keys per batch. Each iteration takes the next batch from 4M keys,
+// so batches do not find their elements in caches. Half of keys are absent for reads,
+// all keys are present for writes, so writes update values and keep the matrix.
+
+namespace {
+
+constexpr size_t elements = 1 << 23;
+constexpr size_t pool = 1 << 22;
+
+using Indices = std::array<size_t, 2>;
+
+template <typename Storage>
+using MatrixType = otus::Matrix<long, 0, 2, Storage, otus::MixHash>;
+
+template <typename Storage>
+MatrixType<Storage> &shared_matrix() {
+    static MatrixType<Storage> matrix = [] {
+        MatrixType<Storage> result;
+        result.reserve(elements);
+        for (size_t i = 0; i < elements; ++i) {
+            result[i][i * 7 % elements] = static_cast<long>(i + 1);
+        }
+        return result;
+    }();
+    return matrix;
+}
+
+std::vector<Indices> random_keys(bool present) {
+    std::mt19937_64 random{1};
+    std::vector<Indices> result(pool);
+    for (auto &indices : result) {
+        const size_t i = random() % elements;
+        indices = {{i, present || random() % 2 == 0 ? i * 7 % elements : i + 1}};
+    }
+    return result;
+}
+
+/// Batches of keys taken one after another from the pool
+class Batches {
+    std::vector<Indices> keys_;
+    size_t size_;
+    size_t next_{0};
+
+  public:
+    Batches(bool present, int64_t size)
+        : keys_(random_keys(present)), size_(static_cast<size_t>(size)) {}
+
+    std::vector<Indices>::const_iterator next() {
+        if (next_ + size_ > keys_.size()) {
+            next_ = 0;
+        }
+        next_ += size_;
+        return keys_.cbegin() + static_cast<ptrdiff_t>(next_ - size_);
+    }
+    size_t size() const noexcept { return size_; }
+};
+
+template <typename Storage>
+void BM_BatchGetByElement(benchmark::State &state) {
+    const auto &matrix = shared_matrix<Storage>();
+    Batches batches(false, state.range(0));
+    std::vector<long> values(batches.size());
+    for (auto _ : state) {
+        auto keys = batches.next();
+        for (size_t i = 0; i < values.size(); ++i, ++keys) {
+            values[i] = matrix[(*keys)[0]][(*keys)[1]];
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batches.size()));
+}
+
+template <typename Storage>
+void BM_BatchGetMany(benchmark::State &state) {
+    const auto &matrix = shared_matrix<Storage>();
+    Batches batches(false, state.range(0));
+    std::vector<long> values(batches.size());
+    for (auto _ : state) {
+        const auto keys = batches.next();
+        matrix.get_many(keys, keys + static_cast<ptrdiff_t>(values.size()), values.begin());
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batches.size()));
+}
+
+template <typename Storage>
+void BM_BatchSetByElement(benchmark::State &state) {
+    auto &matrix = shared_matrix<Storage>();
+    Batches batches(true, state.range(0));
+    for (auto _ : state) {
+        auto keys = batches.next();
+        for (size_t i = 0; i < batches.size(); ++i, ++keys) {
+            matrix[(*keys)[0]][(*keys)[1]] = static_cast<long>(i + 1);
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batches.size()));
+}
+
+template <typename Storage>
+void BM_BatchSetMany(benchmark::State &state) {
+    auto &matrix = shared_matrix<Storage>();
+    Batches batches(true, state.range(0));
+    std::vector<long> values(batches.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<long>(i + 1);
+    }
+    for (auto _ : state) {
+        const auto keys = batches.next();
+        matrix.set_many(keys, keys + static_cast<ptrdiff_t>(values.size()), values.cbegin());
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batches.size()));
+}
+
+void batch_sizes(benchmark::internal::Benchmark *benchmark) {
+    for (const int64_t size : {1000, 10000, 100000}) {
+        benchmark->Arg(size);
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_BatchGetByElement, otus::UnorderedStorage)->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(BM_BatchGetMany, otus::UnorderedStorage)->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(BM_BatchGetByElement, otus::FlatStorage)->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(BM_BatchGetMany, otus::FlatStorage)->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(BM_BatchSetByElement, otus::UnorderedStorage)->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(BM_BatchSetMany, otus::UnorderedStorage)->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(BM_BatchSetByElement, otus::FlatStorage)->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(BM_BatchSetMany, otus::FlatStorage)->Apply(batch_sizes);
@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <random>
+#include <tuple>
+#include <vector>
+
+// Loading of the matrix: assignment of each element vs insert_bulk with presizing
+
+namespace {
+
+using Triplet = std::tuple<size_t, size_t, int>;
+
+std::vector<Triplet> random_triplets(size_t count) {
+    std::mt19937_64 random{1};
+    std::vector<Triplet> result(count);
+    for (auto &triplet : result) {
+        triplet = Triplet{random() % (1u << 20), random() % (1u << 20), 1};
+    }
+    return result;
+}
+
+template <typename Storage>
+void BM_LoadByAssign(benchmark::State &state) {
+    const auto triplets = random_triplets(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        otus::Matrix<int, 0, 2, Storage> matrix;
+        for (const auto &triplet : triplets) {
+            matrix[std::get<0>(triplet)][std::get<1>(triplet)] = std::get<2>(triplet);
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Storage>
+void BM_LoadBulk(benchmark::State &state) {
+    const auto triplets = random_triplets(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto matrix =
+            otus::Matrix<int, 0, 2, Storage>::from_triplets(triplets.begin(), triplets.end());
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_LoadByAssign, otus::UnorderedStorage)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_LoadBulk, otus::UnorderedStorage)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_LoadByAssign, otus::FlatStorage)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_LoadBulk, otus::FlatStorage)->Range(1 << 12, 1 << 20);
@@ -0,0 +1,154 @@
+#include <benchmark/benchmark.h>
+#include <otus/compressed_matrix.hpp>
+#include <otus/compressed_tensor.hpp>
+#include <random>
+#include <tuple>
+#include <vector>
+
+// Compare the mutable Matrix with its frozen CSR/CSF snapshot on scans and lookups
+
+namespace {
+
+constexpr size_t rows = 1024;
+constexpr size_t columns = 1 << 16;
+
+using MatrixType = otus::Matrix<int, 0>;
+using CsrType = otus::CsrMatrix<int, 0>;
+
+MatrixType make_matrix(size_t count) {
+    std::mt19937_64 random{1};
+    MatrixType matrix;
+    while (matrix.size() < count) {
+        matrix[random() % rows][random() % columns] = 1;
+    }
+    return matrix;
+}
+
+void BM_RowScanMatrix(benchmark::State &state) {
+    const auto matrix = make_matrix(static_cast<size_t>(state.range(0)));
+    size_t row = 0;
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto element : matrix) {
+            if (std::get<0>(element) == row) {
+                sum += std::get<2>(element);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+        row = (row + 1) % rows;
+    }
+}
+
+void BM_RowScanCsr(benchmark::State &state) {
+    const CsrType csr = make_matrix(static_cast<size_t>(state.range(0))).freeze();
+    size_t row = 0;
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto element : csr.row(row)) {
+            sum += element.second;
+        }
+        benchmark::DoNotOptimize(sum);
+        row = (row + 1) % rows;
+    }
+}
+
+template <typename Container>
+void iterate(benchmark::State &state, const Container &container) {
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto element : container) {
+            sum += std::get<2>(element);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_IterateMatrix(benchmark::State &state) {
+    iterate(state, make_matrix(static_cast<size_t>(state.range(0))));
+}
+
+void BM_IterateCsr(benchmark::State &state) {
+    iterate(state, make_matrix(static_cast<size_t>(state.range(0))).freeze());
+}
+
+template <typename Container>
+void lookup(benchmark::State &state, const Container &container) {
+    std::mt19937_64 random{2};
+    std::vector<std::tuple<size_t, size_t>> keys(1 << 12);
+    for (auto &key : keys) {
+        key = std::make_tuple(random() % rows, random() % columns);
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto &key : keys) {
+            sum += container[std::get<0>(key)][std::get<1>(key)];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(keys.size()));
+}
+
+void BM_LookupMatrix(benchmark::State &state) {
+    const auto matrix = make_matrix(static_cast<size_t>(state.range(0)));
+    lookup(state, matrix);
+}
+
+void BM_LookupCsr(benchmark::State &state) {
+    const CsrType csr = make_matrix(static_cast<size_t>(state.range(0))).freeze();
+    lookup(state, csr);
+    const size_t bytes = csr.line_count() * 2 * sizeof(size_t) +
+                         csr.size() * (sizeof(size_t) + sizeof(int));
+    state.counters["bytes_per_element"] =
+        static_cast<double>(bytes) / static_cast<double>(csr.size());
+}
+
+using TensorType = otus::Matrix<int, 0, 3>;
+
+TensorType make_tensor(size_t count) {
+    std::mt19937_64 random{1};
+    TensorType tensor;
+    while (tensor.size() < count) {
+        tensor[random() % 64][random() % 64][random() % columns] = 1;
+    }
+    return tensor;
+}
+
+void BM_SliceScanMatrix3D(benchmark::State &state) {
+    const auto tensor = make_tensor(static_cast<size_t>(state.range(0)));
+    size_t i = 0;
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto element : tensor) {
+            if (std::get<0>(element) == i % 64 && std::get<1>(element) == i / 64 % 64) {
+                sum += std::get<3>(element);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+        ++i;
+    }
+}
+
+void BM_SliceScanCsf(benchmark::State &state) {
+    const auto csf = make_tensor(static_cast<size_t>(state.range(0))).freeze();
+    size_t i = 0;
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto element : csf[i % 64][i / 64 % 64]) {
+            sum += std::get<3>(element);
+        }
+        benchmark::DoNotOptimize(sum);
+        ++i;
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_RowScanMatrix)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK(BM_RowScanCsr)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK(BM_IterateMatrix)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK(BM_IterateCsr)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK(BM_LookupMatrix)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK(BM_LookupCsr)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK(BM_SliceScanMatrix3D)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK(BM_SliceScanCsf)->Arg(1 << 12)->Arg(1 << 16);
@@ -0,0 +1,60 @@
+#include <array>
+#include <benchmark/benchmark.h>
+#include <mutex>
+#include <otus/concurrent_matrix.hpp>
+#include <random>
+
+// Compare ConcurrentMatrix with one Matrix behind one mutex for 1..64 threads
+
+namespace {
+
+constexpr size_t keys = 1 << 16;
+
+/// One Matrix behind one mutex: the baseline
+class LockedMatrix {
+    std::mutex mutex_;
+    otus::Matrix<int, 0> matrix_;
+
+  public:
+    int get(const std::array<size_t, 2> &indices) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return matrix_.at(indices);
+    }
+    void set(const std::array<size_t, 2> &indices, int value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        matrix_.at(indices) = value;
+    }
+};
+
+LockedMatrix locked_matrix;
+otus::ConcurrentMatrix<int, 0> concurrent_matrix;
+
+/// Mixed workload: one write per `state.range(0)` operations
+template <typename MatrixType>
+void run(benchmark::State &state, MatrixType &matrix) {
+    std::mt19937_64 random{static_cast<uint64_t>(state.thread_index()) + 1};
+    const auto writes = static_cast<uint64_t>(state.range(0));
+    for (auto _ : state) {
+        const uint64_t value = random();
+        const std::array<size_t, 2> indices{{value % 256, (value >> 8) % (keys / 256)}};
+        if (value % writes == 0) {
+            matrix.set(indices, static_cast<int>(value >> 32));
+        } else {
+            benchmark::DoNotOptimize(matrix.get(indices));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_LockedMatrix(benchmark::State &state) { run(state, locked_matrix); }
+void BM_ConcurrentMatrix(benchmark::State &state) { run(state, concurrent_matrix); }
+
+
+void threads(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgName("write_every")->Arg(2)->Arg(10)->ThreadRange(1, 64)->UseRealTime();
+}
+
+} // namespace
+
+BENCHMARK(BM_LockedMatrix)->Apply(threads);
+BENCHMARK(BM_ConcurrentMatrix)->Apply(threads);
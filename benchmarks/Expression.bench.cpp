@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <random>
+#include <tuple>
+
+// C = A + B * 2: expression in one pass vs loops over elements of operands with temporaries
+
+namespace {
+
+template <typename MatrixType>
+MatrixType random_matrix(size_t count, uint64_t seed) {
+    std::mt19937_64 random{seed};
+    MatrixType matrix;
+    while (matrix.size() < count) {
+        // operands overlap in about half of elements
+        matrix[random() % 2048][random() % 2048] = static_cast<long>(random() % 100) + 1;
+    }
+    return matrix;
+}
+
+template <typename... Options>
+void BM_ExpressionLoops(benchmark::State &state) {
+    using MatrixType = otus::Matrix<long, 0, 2, Options...>;
+    const auto a = random_matrix<MatrixType>(static_cast<size_t>(state.range(0)), 1);
+    const auto b = random_matrix<MatrixType>(static_cast<size_t>(state.range(0)), 2);
+    for (auto _ : state) {
+        MatrixType scaled;
+        for (const auto element : b) {
+            size_t x, y;
+            long v;
+            std::tie(x, y, v) = element;
+            scaled[x][y] = v * 2;
+        }
+        MatrixType c = a;
+        for (const auto element : scaled) {
+            size_t x, y;
+            long v;
+            std::tie(x, y, v) = element;
+            c[x][y] += v;
+        }
+        benchmark::DoNotOptimize(c.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+template <typename... Options>
+void BM_ExpressionTemplate(benchmark::State &state) {
+    using MatrixType = otus::Matrix<long, 0, 2, Options...>;
+    const auto a = random_matrix<MatrixType>(static_cast<size_t>(state.range(0)), 1);
+    const auto b = random_matrix<MatrixType>(static_cast<size_t>(state.range(0)), 2);
+    for (auto _ : state) {
+        MatrixType c = a + b * 2;
+        benchmark::DoNotOptimize(c.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_ExpressionLoops, otus::UnorderedStorage)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_ExpressionTemplate, otus::UnorderedStorage)->Range(1 << 10, 1 << 20);
+// tuple hash of dense coordinates collides too much for open addressing
+BENCHMARK_TEMPLATE(BM_ExpressionLoops, otus::FlatStorage, otus::MixHash)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_ExpressionTemplate, otus::FlatStorage, otus::MixHash)
+    ->Range(1 << 10, 1 << 20);
@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <cstddef>
+#include <random>
+#include <tuple>
+
+// Tracked fingerprints of elements: the cost of tracking by writes, operator== of matrices
+// which differ in one element and diff() of matrices which differ in 1% of elements.
+// The argument is the count of elements.
+
+namespace {
+
+using Plain = otus::Matrix<long, 0, 2, otus::FlatStorage, otus::MixHash>;
+using Tracked = otus::Matrix<long, 0, 2, otus::FlatStorage, otus::MixHash, otus::TrackFingerprint>;
+
+template <typename MatrixType>
+MatrixType random_matrix(size_t count) {
+    std::mt19937_64 random{1};
+    MatrixType matrix;
+    matrix.reserve(count);
+    while (matrix.size() < count) {
+        matrix[random() % (count * 4)][random() % 1024] = static_cast<long>(random() % 100 + 1);
+    }
+    return matrix;
+}
+
+template <typename MatrixType>
+void BM_FingerprintWrite(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(random_matrix<MatrixType>(count).size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+template <typename MatrixType>
+void BM_FingerprintUnequal(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto lhs = random_matrix<MatrixType>(count);
+    auto rhs = lhs;
+    // the last element in the order of the walk, so the walk finds the difference last
+    size_t row = 0, column = 0;
+    for (const auto element : lhs) {
+        row = std::get<0>(element);
+        column = std::get<1>(element);
+    }
+    rhs[row][column] += 1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+void BM_FingerprintDiff(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto from = random_matrix<Plain>(count);
+    auto to = from;
+    std::mt19937_64 random{2};
+    for (size_t i = 0; i < count / 100; ++i) {
+        to[random() % (count * 4)][random() % 1024] = static_cast<long>(random() % 3);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(otus::diff(from, to).size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (from.size() + to.size())));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_FingerprintWrite, Plain)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_FingerprintWrite, Tracked)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_FingerprintUnequal, Plain)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_FingerprintUnequal, Tracked)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_FingerprintDiff)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20);
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Matrices with compile-time extents: the dense array selected for small extents vs hash
+// storages of the same 64x64 matrix. The argument is the percentage of filled cells.
+
+namespace {
+
+constexpr size_t extent = 64;
+
+using Dense = otus::FixedMatrix<long, 0, otus::Extents<extent, extent>>;
+using Unordered = otus::Matrix<long, 0, 2, otus::UnorderedStorage, otus::MixHash>;
+using Flat = otus::Matrix<long, 0, 2, otus::FlatStorage, otus::MixHash>;
+
+using Coordinates = std::vector<std::pair<size_t, size_t>>;
+
+Coordinates random_coordinates(int percent) {
+    std::mt19937_64 random{1};
+    Coordinates result;
+    for (size_t i = 0; i < extent * extent; ++i) {
+        if (static_cast<int>(random() % 100) < percent) {
+            result.emplace_back(i / extent, i % extent);
+        }
+    }
+    std::shuffle(result.begin(), result.end(), random);
+    return result;
+}
+
+template <typename MatrixType>
+void BM_FixedWrite(benchmark::State &state) {
+    const auto coordinates = random_coordinates(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        MatrixType matrix;
+        for (const auto &coordinate : coordinates) {
+            matrix[coordinate.first][coordinate.second] = 1;
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * coordinates.size()));
+}
+
+template <typename MatrixType>
+void BM_FixedRead(benchmark::State &state) {
+    const auto coordinates = random_coordinates(static_cast<int>(state.range(0)));
+    MatrixType matrix;
+    for (const auto &coordinate : coordinates) {
+        matrix[coordinate.first][coordinate.second] = 1;
+    }
+    // read all cells: present and absent ones
+    for (auto _ : state) {
+        long sum = 0;
+        for (size_t row = 0; row < extent; ++row) {
+            for (size_t column = 0; column < extent; ++column) {
+                sum += matrix[row][column];
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * extent * extent));
+}
+
+template <typename MatrixType>
+void BM_FixedIterate(benchmark::State &state) {
+    const auto coordinates = random_coordinates(static_cast<int>(state.range(0)));
+    MatrixType matrix;
+    for (const auto &coordinate : coordinates) {
+        matrix[coordinate.first][coordinate.second] = 1;
+    }
+    for (auto _ : state) {
+        long sum = 0;
+        for (const auto element : matrix) {
+            sum += std::get<2>(element);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * coordinates.size()));
+}
+
+void densities(benchmark::internal::Benchmark *benchmark) {
+    for (const int percent : {10, 50, 100}) {
+        benchmark->Arg(percent);
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_FixedWrite, Dense)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_FixedWrite, Unordered)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_FixedWrite, Flat)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_FixedRead, Dense)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_FixedRead, Unordered)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_FixedRead, Flat)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_FixedIterate, Dense)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_FixedIterate, Unordered)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_FixedIterate, Flat)->Apply(densities);
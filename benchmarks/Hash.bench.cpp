@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Compare hash policies on diagonal, row-major and random key distributions
+
+namespace {
+
+using Key = std::tuple<size_t, size_t>;
+
+enum Distribution { diagonal, row_major, random_keys };
+
+std::vector<Key> make_keys(Distribution distribution, size_t count) {
+    std::vector<Key> keys(count);
+    std::mt19937_64 random{1};
+    const size_t columns = 1024;
+    for (size_t i = 0; i < count; ++i) {
+        switch (distribution) {
+        case diagonal:
+            keys[i] = Key{i, i};
+            break;
+        case row_major:
+            keys[i] = Key{i / columns, i % columns};
+            break;
+        case random_keys:
+            keys[i] = Key{random() % (1u << 24), random() % (1u << 24)};
+            break;
+        }
+    }
+    return keys;
+}
+
+/// Probe statistics of std::unordered_map: mean length of a bucket chain per element
+template <typename Hash>
+void collision_counters(benchmark::State &state, const std::vector<Key> &keys) {
+    std::unordered_map<Key, int, Hash> map;
+    for (const auto &key : keys) {
+        map.emplace(key, 1);
+    }
+    double probes = 0;
+    size_t longest = 0;
+    for (size_t bucket = 0; bucket < map.bucket_count(); ++bucket) {
+        const size_t length = map.bucket_size(bucket);
+        probes += static_cast<double>(length * (length + 1)) / 2;
+        longest = std::max(longest, length);
+    }
+    state.counters["mean_probe"] = probes / static_cast<double>(map.size());
+    state.counters["max_chain"] = static_cast<double>(longest);
+}
+
+template <typename Hash, typename Storage>
+void BM_HashLookup(benchmark::State &state) {
+    const auto keys =
+        make_keys(static_cast<Distribution>(state.range(0)), static_cast<size_t>(state.range(1)));
+    otus::Matrix<int, 0, 2, Hash, Storage> matrix;
+    for (const auto &key : keys) {
+        matrix[std::get<0>(key)][std::get<1>(key)] = 1;
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto &key : keys) {
+            sum += matrix[std::get<0>(key)][std::get<1>(key)];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+    collision_counters<Hash>(state, keys);
+}
+
+void distributions(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgNames({"distribution", "count"});
+    for (int distribution : {diagonal, row_major, random_keys}) {
+        for (int count : {1 << 12, 1 << 16, 1 << 20}) {
+            benchmark->Args({distribution, count});
+        }
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_HashLookup, otus::TupleHash, otus::UnorderedStorage)->Apply(distributions);
+BENCHMARK_TEMPLATE(BM_HashLookup, otus::MixHash, otus::UnorderedStorage)->Apply(distributions);
+BENCHMARK_TEMPLATE(BM_HashLookup, otus::TupleHash, otus::FlatStorage)->Apply(distributions);
+BENCHMARK_TEMPLATE(BM_HashLookup, otus::MixHash, otus::FlatStorage)->Apply(distributions);
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <random>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+// Cost of the change journal: mutations without the journal (the pointer check only)
+// and with it, and refresh of the replica by the delta vs by the full copy
+
+namespace {
+
+using MatrixType = otus::Matrix<long, 0, 2, otus::FlatStorage, otus::MixHash>;
+
+std::vector<std::pair<size_t, size_t>> random_cells(size_t count) {
+    std::mt19937_64 random{1};
+    std::vector<std::pair<size_t, size_t>> result(count);
+    for (auto &cell : result) {
+        cell = {random() % 1024, random() % 1024};
+    }
+    return result;
+}
+
+/// Assign, update and remove elements, every 8th cell is set to the default value
+void mutate(MatrixType &matrix, const std::vector<std::pair<size_t, size_t>> &cells) {
+    long value = 0;
+    for (const auto &cell : cells) {
+        if (++value % 8 == 0) {
+            matrix[cell.first][cell.second] = 0;
+        } else {
+            matrix[cell.first][cell.second] += value;
+        }
+    }
+}
+
+template <bool Journaled>
+void BM_Mutate(benchmark::State &state) {
+    const auto cells = random_cells(static_cast<size_t>(state.range(0)));
+    MatrixType::Journal journal;
+    for (auto _ : state) {
+        MatrixType matrix;
+        matrix.reserve(cells.size());
+        if (Journaled) {
+            matrix.attach(&journal);
+        }
+        mutate(matrix, cells);
+        benchmark::DoNotOptimize(matrix.size());
+        journal.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Replica of 1M elements gets changes of range(0) cells by the serialized delta
+void BM_RefreshByDelta(benchmark::State &state) {
+    MatrixType primary;
+    mutate(primary, random_cells(1 << 20));
+    MatrixType replica = primary;
+    MatrixType::Journal journal;
+    primary.attach(&journal);
+    const auto cells = random_cells(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        mutate(primary, cells);
+        std::stringstream stream;
+        journal.drain().serialize(stream);
+        MatrixType::Journal::deserialize(stream).replay(replica);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Replica of 1M elements gets changes of range(0) cells by the full copy
+void BM_RefreshBySnapshot(benchmark::State &state) {
+    MatrixType primary;
+    mutate(primary, random_cells(1 << 20));
+    MatrixType replica;
+    const auto cells = random_cells(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        mutate(primary, cells);
+        replica = primary;
+        benchmark::DoNotOptimize(replica.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Mutate, false)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Mutate, true)->Range(1 << 12, 1 << 20);
+BENCHMARK(BM_RefreshByDelta)->Range(1 << 8, 1 << 16);
+BENCHMARK(BM_RefreshBySnapshot)->Range(1 << 8, 1 << 16);
@@ -0,0 +1,92 @@
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <otus/matrix.hpp>
+#include <random>
+#include <vector>
+
+// Compare key policies of the matrix: tuple of size_t vs packed coordinates
+
+namespace {
+
+template <size_t Dimension>
+std::vector<std::array<size_t, Dimension>> random_indices(size_t count, uint64_t seed) {
+    std::mt19937_64 random{seed};
+    std::uniform_int_distribution<size_t> index{0, 1u << 20};
+    std::vector<std::array<size_t, Dimension>> result(count);
+    for (auto &indices : result) {
+        for (auto &idx : indices) {
+            idx = index(random);
+        }
+    }
+    return result;
+}
+
+template <typename MatrixType>
+void assign(MatrixType &matrix, const std::array<size_t, 2> &idx, int value) {
+    matrix[idx[0]][idx[1]] = value;
+}
+template <typename MatrixType>
+void assign(MatrixType &matrix, const std::array<size_t, 3> &idx, int value) {
+    matrix[idx[0]][idx[1]][idx[2]] = value;
+}
+template <typename MatrixType>
+int read(const MatrixType &matrix, const std::array<size_t, 2> &idx) {
+    return matrix[idx[0]][idx[1]];
+}
+template <typename MatrixType>
+int read(const MatrixType &matrix, const std::array<size_t, 3> &idx) {
+    return matrix[idx[0]][idx[1]][idx[2]];
+}
+
+template <typename MatrixType, size_t Dimension>
+void BM_KeyInsert(benchmark::State &state) {
+    const auto indices = random_indices<Dimension>(static_cast<size_t>(state.range(0)), 1);
+    for (auto _ : state) {
+        MatrixType matrix;
+        for (const auto &idx : indices) {
+            assign(matrix, idx, 1);
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename MatrixType, size_t Dimension>
+void BM_KeyLookup(benchmark::State &state) {
+    const auto indices = random_indices<Dimension>(static_cast<size_t>(state.range(0)), 1);
+    MatrixType matrix;
+    for (const auto &idx : indices) {
+        assign(matrix, idx, 1);
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto &idx : indices) {
+            sum += read(matrix, idx);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using Tuple2D = otus::Matrix<int, 0, 2, otus::FlatStorage>;
+using Packed2D = otus::Matrix<int, 0, 2, otus::FlatStorage, otus::PackedKeys<uint32_t>>;
+using Tuple3D = otus::Matrix<int, 0, 3, otus::FlatStorage>;
+using Packed3D = otus::Matrix<int, 0, 3, otus::FlatStorage, otus::PackedKeys<uint32_t>>;
+using UnorderedTuple2D = otus::Matrix<int, 0, 2>;
+using UnorderedPacked2D = otus::Matrix<int, 0, 2, otus::PackedKeys<uint32_t>>;
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_KeyInsert, Tuple2D, 2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_KeyInsert, Packed2D, 2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_KeyInsert, Tuple3D, 3)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_KeyInsert, Packed3D, 3)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_KeyInsert, UnorderedTuple2D, 2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_KeyInsert, UnorderedPacked2D, 2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_KeyLookup, Tuple2D, 2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_KeyLookup, Packed2D, 2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_KeyLookup, Tuple3D, 3)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_KeyLookup, Packed3D, 3)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_KeyLookup, UnorderedTuple2D, 2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_KeyLookup, UnorderedPacked2D, 2)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,151 @@
+#include <benchmark/benchmark.h>
+#include <otus/mapped_matrix.hpp>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#if defined(__linux__)
+#include <malloc.h>
+#include <unistd.h>
+#endif
+
+// Reload of the saved matrix: text triplets vs binary file vs mapped view.
+// Files are read once before measurement to be in the page cache, the counter rss_mb
+// shows the resident memory taken by the loaded matrix or by touched pages of the view.
+
+namespace {
+
+using MatrixType = otus::Matrix<long, 0>;
+using MappedType = otus::MappedMatrix<long, 0>;
+
+/// Files saved once per size and removed at exit
+class Files {
+    std::map<long, std::pair<std::string, std::string>> paths_;
+
+  public:
+    ~Files() {
+        for (const auto &paths : paths_) {
+            std::remove(paths.second.first.c_str());
+            std::remove(paths.second.second.c_str());
+        }
+    }
+
+    const std::pair<std::string, std::string> &get(long count) {
+        auto iter = paths_.find(count);
+        if (iter != paths_.end()) {
+            return iter->second;
+        }
+        const std::string name = "otus_matrix_bench_" + std::to_string(count);
+        MatrixType matrix;
+        matrix.reserve(static_cast<size_t>(count));
+        std::ofstream text(name + ".txt");
+        for (long i = 0; i < count; ++i) {
+            const auto row = static_cast<size_t>(i % 4096), column = static_cast<size_t>(i / 4096);
+            matrix[row][column] = i + 1;
+            text << row << ' ' << column << ' ' << i + 1 << '\n';
+        }
+        otus::save(matrix, name + ".bin");
+        return paths_[count] = {name + ".txt", name + ".bin"};
+    }
+};
+
+/// Read the file to put it into the page cache
+void warm(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> buffer(1 << 20);
+    while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+    }
+}
+
+Files files;
+
+/// Get resident memory of the process in bytes after the heap returns freed memory
+double resident() {
+#if defined(__linux__)
+    malloc_trim(0);
+    std::ifstream statm("/proc/self/statm");
+    size_t size = 0, pages = 0;
+    statm >> size >> pages;
+    return static_cast<double>(pages) * static_cast<double>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+void BM_LoadText(benchmark::State &state) {
+    const auto &path = files.get(state.range(0)).first;
+    warm(path);
+    double memory = 0;
+    for (auto _ : state) {
+        const double before = resident();
+        std::vector<std::tuple<size_t, size_t, long>> triplets;
+        triplets.reserve(static_cast<size_t>(state.range(0)));
+        std::ifstream text(path);
+        size_t row, column;
+        long value;
+        while (text >> row >> column >> value) {
+            triplets.emplace_back(row, column, value);
+        }
+        MatrixType matrix;
+        matrix.insert_bulk(triplets.begin(), triplets.end());
+        decltype(triplets)().swap(triplets);
+        memory = resident() - before;
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.counters["rss_mb"] = memory / (1 << 20);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_LoadBinary(benchmark::State &state) {
+    const auto &path = files.get(state.range(0)).second;
+    warm(path);
+    double memory = 0;
+    for (auto _ : state) {
+        const double before = resident();
+        const auto matrix = otus::load<MatrixType>(path);
+        memory = resident() - before;
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.counters["rss_mb"] = memory / (1 << 20);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Open the mapped view and read one element
+void BM_MapFile(benchmark::State &state) {
+    const auto &path = files.get(state.range(0)).second;
+    warm(path);
+    double memory = 0;
+    for (auto _ : state) {
+        const double before = resident();
+        const MappedType matrix(path);
+        benchmark::DoNotOptimize(matrix[4095][0]);
+        memory = resident() - before;
+    }
+    state.counters["rss_mb"] = memory / (1 << 20);
+}
+
+/// Random lookups in the mapped view
+void BM_MappedLookup(benchmark::State &state) {
+    const auto &path = files.get(state.range(0)).second;
+    warm(path);
+    const MappedType matrix(path);
+    const auto columns = static_cast<size_t>(state.range(0)) / 4096;
+    std::mt19937_64 random{1};
+    const double before = resident();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(matrix[random() % 4096][random() % columns]);
+    }
+    state.counters["rss_mb"] = (resident() - before) / (1 << 20);
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_LoadText)->Arg(1 << 20)->Arg(10 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadBinary)->Arg(1 << 20)->Arg(10 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapFile)->Arg(1 << 20)->Arg(10 << 20);
+BENCHMARK(BM_MappedLookup)->Arg(1 << 20)->Arg(10 << 20);
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <otus/multiply.hpp>
+#include <random>
+#include <vector>
+
+// Sparse matrix by vector and by matrix on power-law and banded matrices
+
+namespace {
+
+using MatrixType = otus::Matrix<long, 0>;
+
+constexpr size_t size = 1 << 14;
+
+/// Lengths of rows follow power law: few long rows and many short rows
+MatrixType power_law_matrix() {
+    std::mt19937_64 random{1};
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    MatrixType matrix;
+    for (size_t row = 0; row < size; ++row) {
+        const auto length = static_cast<size_t>(std::pow(uniform(random), -0.8));
+        for (size_t i = 0; i < std::min(length, size); ++i) {
+            matrix(row, random() % size) = 1;
+        }
+    }
+    return matrix;
+}
+
+MatrixType banded_matrix(size_t band) {
+    MatrixType matrix;
+    for (size_t row = 0; row < size; ++row) {
+        for (size_t column = row > band ? row - band : 0; column <= std::min(row + band, size - 1);
+             ++column) {
+            matrix(row, column) = 1;
+        }
+    }
+    return matrix;
+}
+
+void run_spmv(benchmark::State &state, const MatrixType &matrix) {
+    otus::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    const auto csr = matrix.freeze();
+    const std::vector<long> x(size, 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(otus::multiply(csr, x, size, pool));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(csr.size()));
+}
+
+void BM_SpMV_PowerLaw(benchmark::State &state) { run_spmv(state, power_law_matrix()); }
+void BM_SpMV_Banded(benchmark::State &state) { run_spmv(state, banded_matrix(8)); }
+
+void BM_SpGEMM_Banded(benchmark::State &state) {
+    otus::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    const auto csr = banded_matrix(4).freeze();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(otus::multiply(csr, csr, size, size, size, pool));
+    }
+}
+
+void BM_SpGEMM_PowerLaw(benchmark::State &state) {
+    otus::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    const auto csr = power_law_matrix().freeze();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(otus::multiply(csr, csr, size, size, size, pool));
+    }
+}
+
+/// Count of workers of the pool, the caller thread is also used
+void workers(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgName("workers")->Arg(0)->Arg(3)->Arg(7)->UseRealTime();
+}
+
+} // namespace
+
+BENCHMARK(BM_SpMV_PowerLaw)->Apply(workers);
+BENCHMARK(BM_SpMV_Banded)->Apply(workers);
+BENCHMARK(BM_SpGEMM_PowerLaw)->Apply(workers);
+BENCHMARK(BM_SpGEMM_Banded)->Apply(workers);
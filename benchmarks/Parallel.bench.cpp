@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <tuple>
+#include <vector>
+
+// Scaling of parallel aggregations over all elements by count of workers of the pool,
+// the sequential loop over the iterator is the baseline
+
+namespace {
+
+constexpr size_t count = 1 << 20;
+
+template <typename Storage>
+const otus::Matrix<long, 0, 2, Storage, otus::MixHash> &random_matrix() {
+    static const auto matrix = [] {
+        std::mt19937_64 random{1};
+        otus::Matrix<long, 0, 2, Storage, otus::MixHash> result;
+        result.reserve(count);
+        while (result.size() < count) {
+            result[random() % 8192][random() % 8192] = static_cast<long>(random() % 1000) + 1;
+        }
+        return result;
+    }();
+    return matrix;
+}
+
+template <typename Storage>
+void BM_SumSequential(benchmark::State &state) {
+    const auto &matrix = random_matrix<Storage>();
+    for (auto _ : state) {
+        long sum = 0;
+        for (const auto element : matrix) {
+            sum += std::get<2>(element);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+template <typename Storage>
+void BM_SumParallel(benchmark::State &state) {
+    const auto &matrix = random_matrix<Storage>();
+    otus::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(matrix.parallel_reduce(0L, std::plus<>(), pool));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+/// Histogram of values by 16 bins
+template <typename Storage>
+void BM_HistogramParallel(benchmark::State &state) {
+    using Histogram = std::vector<size_t>;
+    const auto &matrix = random_matrix<Storage>();
+    otus::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(matrix.parallel_reduce(
+            Histogram(16),
+            [](Histogram result, const auto &element) {
+                ++result[static_cast<size_t>(std::get<2>(element)) % 16];
+                return result;
+            },
+            [](Histogram lhs, const Histogram &rhs) {
+                std::transform(lhs.begin(), lhs.end(), rhs.begin(), lhs.begin(), std::plus<>());
+                return lhs;
+            },
+            pool));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+/// Count of workers of the pool, the caller thread is also used
+void workers(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgName("workers")->Arg(0)->Arg(1)->Arg(3)->Arg(7)->UseRealTime();
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_SumSequential, otus::UnorderedStorage)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SumParallel, otus::UnorderedStorage)->Apply(workers);
+BENCHMARK_TEMPLATE(BM_HistogramParallel, otus::UnorderedStorage)->Apply(workers);
+BENCHMARK_TEMPLATE(BM_SumSequential, otus::FlatStorage)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SumParallel, otus::FlatStorage)->Apply(workers);
+BENCHMARK_TEMPLATE(BM_HistogramParallel, otus::FlatStorage)->Apply(workers);
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Transposed view of the matrix vs its transposed copy: the copy made by materialize()
+// (like copying elements with permuted indices by hand), iteration over the view and
+// reads of elements through the view and directly. The argument is the count of elements.
+
+namespace {
+
+using MatrixType = otus::Matrix<long, 0, 2, otus::FlatStorage, otus::MixHash>;
+using Coordinates = std::vector<std::pair<size_t, size_t>>;
+
+std::pair<MatrixType, Coordinates> random_matrix(size_t count) {
+    std::mt19937_64 random{1};
+    std::pair<MatrixType, Coordinates> result;
+    result.first.reserve(count);
+    while (result.first.size() < count) {
+        const size_t row = random() % (count * 4), column = random() % 1024;
+        result.first[row][column] = static_cast<long>(random() % 100 + 1);
+        result.second.emplace_back(row, column);
+    }
+    std::shuffle(result.second.begin(), result.second.end(), random);
+    return result;
+}
+
+void BM_PermuteMaterialize(benchmark::State &state) {
+    const auto matrix = random_matrix(static_cast<size_t>(state.range(0))).first;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(matrix.transpose().materialize().size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * matrix.size()));
+}
+
+void BM_PermuteIterateView(benchmark::State &state) {
+    const auto matrix = random_matrix(static_cast<size_t>(state.range(0))).first;
+    for (auto _ : state) {
+        size_t sum = 0;
+        for (const auto element : matrix.transpose()) {
+            sum += std::get<0>(element) * static_cast<size_t>(std::get<2>(element));
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * matrix.size()));
+}
+
+template <bool Transposed>
+void BM_PermuteRead(benchmark::State &state) {
+    const auto random = random_matrix(static_cast<size_t>(state.range(0)));
+    const auto &matrix = random.first;
+    const auto view = matrix.transpose();
+    for (auto _ : state) {
+        long sum = 0;
+        for (const auto &coordinate : random.second) {
+            sum += Transposed ? view[coordinate.second][coordinate.first]
+                              : matrix[coordinate.first][coordinate.second];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * random.second.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_PermuteMaterialize)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_PermuteIterateView)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PermuteRead, false)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PermuteRead, true)->Arg(1 << 16)->Arg(1 << 20);
@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <random>
+#include <tuple>
+#include <vector>
+
+// Measure the cost of otus::OrderedIndex on inserts and its gain on slices and ranges
+
+namespace {
+
+constexpr size_t rows = 1024;
+constexpr size_t columns = 1 << 16;
+
+std::vector<std::tuple<size_t, size_t>> make_keys(size_t count) {
+    std::mt19937_64 random{1};
+    std::vector<std::tuple<size_t, size_t>> keys(count);
+    for (auto &key : keys) {
+        key = std::make_tuple(random() % rows, random() % columns);
+    }
+    return keys;
+}
+
+template <typename Index>
+void BM_Insert(benchmark::State &state) {
+    const auto keys = make_keys(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        otus::Matrix<int, 0, 2, Index> matrix;
+        for (const auto &key : keys) {
+            matrix[std::get<0>(key)][std::get<1>(key)] = 1;
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Index>
+void BM_InsertErase(benchmark::State &state) {
+    const auto keys = make_keys(static_cast<size_t>(state.range(0)));
+    otus::Matrix<int, 0, 2, Index> matrix;
+    for (auto _ : state) {
+        for (const auto &key : keys) {
+            matrix[std::get<0>(key)][std::get<1>(key)] = 1;
+        }
+        for (const auto &key : keys) {
+            matrix[std::get<0>(key)][std::get<1>(key)] = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+template <typename Index>
+void BM_RowSlice(benchmark::State &state) {
+    const auto keys = make_keys(static_cast<size_t>(state.range(0)));
+    otus::Matrix<int, 0, 2, Index> matrix;
+    for (const auto &key : keys) {
+        matrix[std::get<0>(key)][std::get<1>(key)] = 1;
+    }
+    size_t row = 0;
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto element : matrix[row]) {
+            sum += std::get<2>(element);
+        }
+        benchmark::DoNotOptimize(sum);
+        row = (row + 1) % rows;
+    }
+}
+
+template <typename Index>
+void BM_BoxRange(benchmark::State &state) {
+    const auto keys = make_keys(static_cast<size_t>(state.range(0)));
+    otus::Matrix<int, 0, 2, Index> matrix;
+    for (const auto &key : keys) {
+        matrix[std::get<0>(key)][std::get<1>(key)] = 1;
+    }
+    size_t row = 0;
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto element : matrix.range({row, 0}, {row + 15, columns / 16})) {
+            sum += std::get<2>(element);
+        }
+        benchmark::DoNotOptimize(sum);
+        row = (row + 16) % rows;
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Insert, otus::NoIndex)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_Insert, otus::OrderedIndex)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_InsertErase, otus::NoIndex)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_InsertErase, otus::OrderedIndex)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_RowSlice, otus::NoIndex)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_RowSlice, otus::OrderedIndex)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_BoxRange, otus::NoIndex)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_BoxRange, otus::OrderedIndex)->Arg(1 << 12)->Arg(1 << 16);
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <mutex>
+#include <otus/snapshot_matrix.hpp>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Latency percentiles of reads while a writer refreshes the matrix in bursts:
+// SnapshotMatrix readers against Matrix behind one mutex
+
+namespace {
+
+using Indices = std::array<size_t, 2>;
+
+constexpr size_t keys = 1 << 14;
+constexpr size_t burst = 256;
+
+Indices make_indices(uint64_t value) { return Indices{{value % 128, (value >> 7) % (keys / 128)}}; }
+
+class LockedMatrix {
+    std::mutex mutex_;
+    otus::Matrix<int, 0> matrix_;
+
+  public:
+    int get(const Indices &indices) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return matrix_.at(indices);
+    }
+    void write_burst(std::mt19937_64 &random) {
+        for (size_t i = 0; i < burst; ++i) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            matrix_.at(make_indices(random())) = static_cast<int>(i + 1);
+        }
+    }
+};
+
+class SnapshotReader {
+    otus::SnapshotMatrix<int, 0> matrix_;
+    decltype(matrix_.reader()) reader_ = matrix_.reader();
+
+  public:
+    int get(const Indices &indices) { return reader_.get(indices); }
+    void write_burst(std::mt19937_64 &random) {
+        for (size_t i = 0; i < burst; ++i) {
+            matrix_.set(make_indices(random()), static_cast<int>(i + 1));
+        }
+        matrix_.publish();
+    }
+};
+
+template <typename Store>
+void BM_ReadLatency(benchmark::State &state) {
+    Store store;
+    std::mt19937_64 random{1};
+    for (size_t i = 0; i < keys / burst; ++i) {
+        store.write_burst(random);
+    }
+
+    std::atomic<bool> done{false};
+    std::thread writer([&store, &done] {
+        std::mt19937_64 random{2};
+        while (!done.load()) {
+            store.write_burst(random);
+            std::this_thread::yield();
+        }
+    });
+
+    std::vector<double> latencies;
+    latencies.reserve(1 << 20);
+    for (auto _ : state) {
+        const auto indices = make_indices(random());
+        const auto start = std::chrono::steady_clock::now();
+        benchmark::DoNotOptimize(store.get(indices));
+        const auto finish = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::nano>(finish - start).count());
+    }
+    done.store(true);
+    writer.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double rank) {
+        return latencies[static_cast<size_t>(rank * static_cast<double>(latencies.size() - 1))];
+    };
+    state.counters["p50_ns"] = percentile(0.5);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p999_ns"] = percentile(0.999);
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_ReadLatency, LockedMatrix)->Iterations(1 << 20);
+BENCHMARK_TEMPLATE(BM_ReadLatency, SnapshotReader)->Iterations(1 << 20);
@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Compare storage policies of the matrix: std::unordered_map vs otus::FlatHashMap
+
+namespace {
+
+using Coordinates = std::vector<std::pair<size_t, size_t>>;
+
+Coordinates random_coordinates(size_t count, uint64_t seed) {
+    std::mt19937_64 random{seed};
+    std::uniform_int_distribution<size_t> index{0, 1u << 20};
+    Coordinates result(count);
+    for (auto &coordinate : result) {
+        coordinate = {index(random), index(random)};
+    }
+    return result;
+}
+
+template <typename MatrixType>
+MatrixType make_matrix(const Coordinates &coordinates) {
+    MatrixType matrix;
+    for (const auto &coordinate : coordinates) {
+        matrix[coordinate.first][coordinate.second] = 1;
+    }
+    return matrix;
+}
+
+template <typename MatrixType>
+void BM_Insert(benchmark::State &state) {
+    const auto coordinates = random_coordinates(static_cast<size_t>(state.range(0)), 1);
+    for (auto _ : state) {
+        MatrixType matrix;
+        for (const auto &coordinate : coordinates) {
+            matrix[coordinate.first][coordinate.second] = 1;
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename MatrixType>
+void BM_LookupHit(benchmark::State &state) {
+    const auto coordinates = random_coordinates(static_cast<size_t>(state.range(0)), 1);
+    const auto matrix = make_matrix<MatrixType>(coordinates);
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto &coordinate : coordinates) {
+            sum += matrix[coordinate.first][coordinate.second];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename MatrixType>
+void BM_LookupMiss(benchmark::State &state) {
+    const auto matrix =
+        make_matrix<MatrixType>(random_coordinates(static_cast<size_t>(state.range(0)), 1));
+    const auto misses = random_coordinates(static_cast<size_t>(state.range(0)), 2);
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto &coordinate : misses) {
+            sum += matrix[coordinate.first][coordinate.second];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename MatrixType>
+void BM_EraseByDefault(benchmark::State &state) {
+    const auto coordinates = random_coordinates(static_cast<size_t>(state.range(0)), 1);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto matrix = make_matrix<MatrixType>(coordinates);
+        state.ResumeTiming();
+        for (const auto &coordinate : coordinates) {
+            matrix[coordinate.first][coordinate.second] = 0;
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename MatrixType>
+void BM_Iterate(benchmark::State &state) {
+    const auto matrix =
+        make_matrix<MatrixType>(random_coordinates(static_cast<size_t>(state.range(0)), 1));
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto element : matrix) {
+            sum += std::get<2>(element);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using UnorderedMatrix = otus::Matrix<int, 0, 2, otus::UnorderedStorage>;
+using FlatMatrix = otus::Matrix<int, 0, 2, otus::FlatStorage>;
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Insert, UnorderedMatrix)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Insert, FlatMatrix)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_LookupHit, UnorderedMatrix)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_LookupHit, FlatMatrix)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_LookupMiss, UnorderedMatrix)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_LookupMiss, FlatMatrix)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_EraseByDefault, UnorderedMatrix)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_EraseByDefault, FlatMatrix)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Iterate, UnorderedMatrix)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Iterate, FlatMatrix)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,378 @@
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <otus/matrix.hpp>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// The suite of basic operations of the default matrix (Layout chains and TupleHash) for
+// Dimension 1..5 and value types int, int8_t and int64_t (the other types only with cells in
+// random order). Arguments are the count of cells of the index space from 1K to 50M and the
+// percentage of cells holding elements. Read and write the same cells in row-major order,
+// in random order and along diagonals.
+//
+// Run `cmake --build build --target otus_matrix_bench_json` to keep results in JSON.
+
+namespace {
+
+using Cells = std::vector<size_t>;
+
+/// Extent of every axis of the cube holding at least `cells` cells
+size_t cube_extent(size_t cells, size_t dimension) {
+    size_t extent = 1;
+    for (;; ++extent) {
+        size_t volume = 1;
+        for (size_t axis = 0; axis < dimension && volume < cells; ++axis) {
+            volume *= extent;
+        }
+        if (volume >= cells) {
+            return extent;
+        }
+    }
+}
+
+template <size_t Dimension>
+using Indices = std::array<size_t, Dimension>;
+
+template <size_t Dimension>
+struct Space {
+    size_t extent;
+    size_t elements;
+    size_t step;
+
+    Space(int64_t cells, int64_t percent)
+        : extent(cube_extent(static_cast<size_t>(cells), Dimension)),
+          elements(std::max<size_t>(1, static_cast<size_t>(cells * percent / 100))),
+          step(std::max<size_t>(1, static_cast<size_t>(100 / percent))) {}
+
+    /// Indices of the cell with the offset in row-major order
+    Indices<Dimension> decode(size_t offset) const {
+        Indices<Dimension> indices;
+        for (size_t axis = Dimension; axis-- > 0; offset /= extent) {
+            indices[axis] = offset % extent;
+        }
+        return indices;
+    }
+};
+
+/// Every step-th cell in row-major order
+struct Sequential {
+    template <size_t Dimension>
+    static std::vector<Indices<Dimension>> make(const Space<Dimension> &space) {
+        std::vector<Indices<Dimension>> result(space.elements);
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i] = space.decode(i * space.step);
+        }
+        return result;
+    }
+};
+
+/// The same cells as Sequential in random order
+struct Random {
+    template <size_t Dimension>
+    static std::vector<Indices<Dimension>> make(const Space<Dimension> &space) {
+        auto result = Sequential::make(space);
+        std::shuffle(result.begin(), result.end(), std::mt19937_64{1});
+        return result;
+    }
+};
+
+/// The main diagonal and diagonals shifted from it along axes 1..Dimension-1
+struct Diagonal {
+    template <size_t Dimension>
+    static std::vector<Indices<Dimension>> make(const Space<Dimension> &space) {
+        std::vector<Indices<Dimension>> result(space.elements);
+        for (size_t i = 0; i < result.size(); ++i) {
+            const size_t position = i % space.extent;
+            size_t shift = i / space.extent;
+            result[i].fill(position);
+            for (size_t axis = 1; axis < Dimension; ++axis, shift /= space.extent) {
+                result[i][axis] = (position + shift % space.extent) % space.extent;
+            }
+        }
+        return result;
+    }
+};
+
+template <size_t I, size_t Dimension>
+struct Chain {
+    template <typename Layout>
+    static auto apply(Layout &&layout, const Indices<Dimension> &indices) {
+        return Chain<I + 1, Dimension>::apply(layout[indices[I]], indices);
+    }
+};
+
+template <size_t Dimension>
+struct Chain<Dimension, Dimension> {
+    template <typename Layout>
+    static std::decay_t<Layout> apply(Layout &&layout, const Indices<Dimension> &) {
+        return std::forward<Layout>(layout);
+    }
+};
+
+/// Access the cell by the chain of operator[] as users do
+template <typename MatrixType, size_t Dimension>
+auto cell(MatrixType &matrix, const Indices<Dimension> &indices) {
+    return Chain<0, Dimension>::apply(matrix, indices);
+}
+
+template <typename T, size_t Dimension>
+using MatrixType = otus::Matrix<T, 0, Dimension>;
+
+template <typename T, size_t Dimension>
+MatrixType<T, Dimension> make_matrix(const std::vector<Indices<Dimension>> &indices) {
+    MatrixType<T, Dimension> matrix;
+    for (size_t i = 0; i < indices.size(); ++i) {
+        cell(matrix, indices[i]) = static_cast<T>(i % 100 + 1);
+    }
+    return matrix;
+}
+
+void report(benchmark::State &state, size_t elements) {
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * elements));
+    state.counters["elements"] = static_cast<double>(elements);
+}
+
+template <typename Pattern, size_t Dimension, typename T>
+void BM_SuiteWrite(benchmark::State &state) {
+    const auto indices = Pattern::make(Space<Dimension>(state.range(0), state.range(1)));
+    for (auto _ : state) {
+        auto matrix = make_matrix<T>(indices);
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    report(state, indices.size());
+}
+
+template <typename Pattern, size_t Dimension, typename T>
+void BM_SuiteRead(benchmark::State &state) {
+    const auto indices = Pattern::make(Space<Dimension>(state.range(0), state.range(1)));
+    const auto matrix = make_matrix<T>(indices);
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const auto &idx : indices) {
+            sum += cell(matrix, idx);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state, indices.size());
+}
+
+template <typename Pattern, size_t Dimension, typename T>
+void BM_SuiteEraseByDefault(benchmark::State &state) {
+    const auto indices = Pattern::make(Space<Dimension>(state.range(0), state.range(1)));
+    auto matrix = make_matrix<T>(indices);
+    // elements are written back after erasing, so every iteration starts with the same
+    // matrix without copying it; items are erasures and writes together
+    for (auto _ : state) {
+        for (const auto &idx : indices) {
+            cell(matrix, idx) = 0;
+        }
+        benchmark::DoNotOptimize(matrix.size());
+        for (size_t i = 0; i < indices.size(); ++i) {
+            cell(matrix, indices[i]) = static_cast<T>(i % 100 + 1);
+        }
+    }
+    report(state, indices.size());
+    state.SetItemsProcessed(2 * state.items_processed());
+}
+
+template <size_t Dimension, typename T>
+void BM_SuiteIterate(benchmark::State &state) {
+    const auto matrix =
+        make_matrix<T>(Random::make(Space<Dimension>(state.range(0), state.range(1))));
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const auto element : matrix) {
+            sum += std::get<Dimension>(element);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state, matrix.size());
+}
+
+template <size_t Dimension, typename T>
+void BM_SuiteCopy(benchmark::State &state) {
+    const auto matrix =
+        make_matrix<T>(Random::make(Space<Dimension>(state.range(0), state.range(1))));
+    for (auto _ : state) {
+        auto copy = matrix;
+        benchmark::DoNotOptimize(copy.size());
+    }
+    report(state, matrix.size());
+}
+
+template <size_t Dimension, typename T>
+void BM_SuiteMove(benchmark::State &state) {
+    auto matrix = make_matrix<T>(Random::make(Space<Dimension>(state.range(0), state.range(1))));
+    const size_t elements = matrix.size();
+    for (auto _ : state) {
+        auto moved = std::move(matrix);
+        matrix = std::move(moved);
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    // moves do not depend on the count of elements, so it is not a rate
+    state.counters["elements"] = static_cast<double>(elements);
+}
+
+template <size_t Dimension, typename T>
+void BM_SuiteEqual(benchmark::State &state) {
+    const auto matrix =
+        make_matrix<T>(Random::make(Space<Dimension>(state.range(0), state.range(1))));
+    const auto copy = matrix;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(matrix == copy);
+    }
+    report(state, matrix.size());
+}
+
+void sizes(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgNames({"cells", "percent"});
+    for (const int64_t cells : {1 << 10, 1 << 16, 1 << 20}) {
+        benchmark->Args({cells, 10});
+    }
+    benchmark->Args({1 << 20, 1});
+    benchmark->Args({50000000, 1});
+    benchmark->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Sequential, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Sequential, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Sequential, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Sequential, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Sequential, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Diagonal, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Diagonal, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Diagonal, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Diagonal, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Diagonal, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 1, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 2, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 3, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 4, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 5, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 1, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 2, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 3, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 4, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteWrite, Random, 5, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Sequential, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Sequential, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Sequential, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Sequential, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Sequential, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Diagonal, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Diagonal, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Diagonal, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Diagonal, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Diagonal, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 1, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 2, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 3, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 4, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 5, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 1, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 2, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 3, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 4, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteRead, Random, 5, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Sequential, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Sequential, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Sequential, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Sequential, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Sequential, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Diagonal, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Diagonal, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Diagonal, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Diagonal, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Diagonal, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 1, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 2, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 3, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 4, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 5, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 1, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 2, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 3, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 4, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEraseByDefault, Random, 5, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 1, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 2, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 3, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 4, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 5, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 1, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 2, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 3, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 4, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteIterate, 5, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 1, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 2, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 3, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 4, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 5, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 1, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 2, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 3, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 4, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteCopy, 5, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 1, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 2, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 3, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 4, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 5, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 1, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 2, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 3, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 4, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteMove, 5, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 1, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 2, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 3, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 4, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 5, int)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 1, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 2, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 3, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 4, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 5, int8_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 1, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 2, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 3, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 4, int64_t)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_SuiteEqual, 5, int64_t)->Apply(sizes);
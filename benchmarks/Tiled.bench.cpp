@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Block-dense matrices: tiled storage vs hash storages at several densities of blocks.
+// Elements fill 64x64 blocks scattered over the matrix, the argument is the percentage
+// of filled cells in blocks. Counter "bytes" is the heap memory held per element.
+
+namespace {
+
+constexpr size_t count = 1 << 18;
+constexpr size_t block = 64;
+
+size_t live_bytes = 0;
+
+/// std::allocator which counts allocated bytes
+template <typename T>
+struct BytesAllocator : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+        using other = BytesAllocator<U>;
+    };
+
+    BytesAllocator() = default;
+    template <typename U>
+    BytesAllocator(const BytesAllocator<U> &) noexcept {} // NOLINT
+
+    T *allocate(size_t n) {
+        live_bytes += n * sizeof(T);
+        return std::allocator<T>::allocate(n);
+    }
+    void deallocate(T *pointer, size_t n) {
+        live_bytes -= n * sizeof(T);
+        std::allocator<T>::deallocate(pointer, n);
+    }
+};
+
+using Coordinates = std::vector<std::pair<size_t, size_t>>;
+
+Coordinates block_coordinates(int percent) {
+    std::mt19937_64 random{1};
+    std::bernoulli_distribution filled{percent / 100.0};
+    Coordinates result;
+    result.reserve(count);
+    while (result.size() < count) {
+        const size_t row = random() % (1 << 14) * block;
+        const size_t column = random() % (1 << 14) * block;
+        for (size_t i = 0; i < block * block && result.size() < count; ++i) {
+            if (filled(random)) {
+                result.emplace_back(row + i / block, column + i % block);
+            }
+        }
+    }
+    return result;
+}
+
+template <typename Storage>
+using MatrixType =
+    otus::Matrix<int, 0, 2, Storage, otus::MixHash, otus::StorageAllocator<BytesAllocator<char>>>;
+
+template <typename Storage>
+MatrixType<Storage> make_matrix(const Coordinates &coordinates) {
+    MatrixType<Storage> matrix;
+    for (const auto &coordinate : coordinates) {
+        matrix[coordinate.first][coordinate.second] = 1;
+    }
+    return matrix;
+}
+
+template <typename Storage>
+void BM_TiledInsert(benchmark::State &state) {
+    const auto coordinates = block_coordinates(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        const size_t before = live_bytes;
+        auto matrix = make_matrix<Storage>(coordinates);
+        state.counters["bytes"] = static_cast<double>(live_bytes - before) / matrix.size();
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+template <typename Storage>
+void BM_TiledLookup(benchmark::State &state) {
+    auto coordinates = block_coordinates(static_cast<int>(state.range(0)));
+    const auto matrix = make_matrix<Storage>(coordinates);
+    std::shuffle(coordinates.begin(), coordinates.end(), std::mt19937_64{2});
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto &coordinate : coordinates) {
+            sum += matrix[coordinate.first][coordinate.second];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+template <typename Storage>
+void BM_TiledIterate(benchmark::State &state) {
+    const auto matrix = make_matrix<Storage>(block_coordinates(static_cast<int>(state.range(0))));
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto element : matrix) {
+            sum += std::get<2>(element);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+void densities(benchmark::internal::Benchmark *benchmark) {
+    for (const int percent : {1, 10, 50, 90, 100}) {
+        benchmark->Arg(percent);
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_TiledInsert, otus::UnorderedStorage)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_TiledInsert, otus::FlatStorage)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_TiledInsert, otus::TiledStorage<>)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_TiledLookup, otus::UnorderedStorage)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_TiledLookup, otus::FlatStorage)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_TiledLookup, otus::TiledStorage<>)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_TiledIterate, otus::UnorderedStorage)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_TiledIterate, otus::FlatStorage)->Apply(densities);
+BENCHMARK_TEMPLATE(BM_TiledIterate, otus::TiledStorage<>)->Apply(densities);
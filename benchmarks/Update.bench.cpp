@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+#include <otus/matrix.hpp>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Accumulation of sparse counters: read and assign vs compound assignment vs update.
+// Change of all values: lookup of each element vs mutable iteration.
+
+namespace {
+
+std::vector<std::pair<size_t, size_t>> random_cells(size_t count) {
+    std::mt19937_64 random{1};
+    std::vector<std::pair<size_t, size_t>> result(count);
+    for (auto &cell : result) {
+        // few distinct cells, so most of updates hit existing counters
+        cell = {random() % 256, random() % 256};
+    }
+    return result;
+}
+
+template <typename Storage>
+void BM_CounterReadAssign(benchmark::State &state) {
+    const auto cells = random_cells(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        otus::Matrix<long, 0, 2, Storage> matrix;
+        for (const auto &cell : cells) {
+            matrix[cell.first][cell.second] = matrix[cell.first][cell.second] + 1;
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Storage>
+void BM_CounterCompound(benchmark::State &state) {
+    const auto cells = random_cells(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        otus::Matrix<long, 0, 2, Storage> matrix;
+        for (const auto &cell : cells) {
+            matrix[cell.first][cell.second] += 1;
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Storage>
+void BM_CounterUpdate(benchmark::State &state) {
+    const auto cells = random_cells(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        otus::Matrix<long, 0, 2, Storage> matrix;
+        for (const auto &cell : cells) {
+            matrix.update({cell.first, cell.second}, [](long value) { return value + 1; });
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Negate all values by the lookup of each element
+template <typename Storage>
+void BM_NegateByLookup(benchmark::State &state) {
+    otus::Matrix<long, 0, 2, Storage, otus::MixHash> matrix;
+    for (const auto &cell : random_cells(static_cast<size_t>(state.range(0)))) {
+        matrix[cell.first][cell.second] += 1;
+    }
+    const auto copy = matrix;
+    for (auto _ : state) {
+        for (const auto element : copy) {
+            matrix[std::get<0>(element)][std::get<1>(element)] *= -1;
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(matrix.size()));
+}
+
+/// Negate all values in place by the mutable iteration
+template <typename Storage>
+void BM_NegateInPlace(benchmark::State &state) {
+    otus::Matrix<long, 0, 2, Storage, otus::MixHash> matrix;
+    for (const auto &cell : random_cells(static_cast<size_t>(state.range(0)))) {
+        matrix[cell.first][cell.second] += 1;
+    }
+    for (auto _ : state) {
+        for (auto element : matrix.mutable_elements()) {
+            std::get<2>(element) *= -1;
+        }
+        benchmark::DoNotOptimize(matrix.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(matrix.size()));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_CounterReadAssign, otus::UnorderedStorage)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_CounterCompound, otus::UnorderedStorage)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_CounterUpdate, otus::UnorderedStorage)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_CounterReadAssign, otus::FlatStorage)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_CounterCompound, otus::FlatStorage)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_CounterUpdate, otus::FlatStorage)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_NegateByLookup, otus::UnorderedStorage)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_NegateInPlace, otus::UnorderedStorage)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_NegateByLookup, otus::FlatStorage)->Range(1 << 12, 1 << 20);
+BENCHMARK_TEMPLATE(BM_NegateInPlace, otus::FlatStorage)->Range(1 << 12, 1 << 20);
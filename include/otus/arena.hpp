@@ -0,0 +1,200 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    arena.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: The arena of memory for matrices which live in one scope.
+//
+
+#ifndef OTUS_ARENA_HPP
+#define OTUS_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+namespace otus {
+
+/// Arena of memory with pools of small blocks
+///
+/// Small blocks (nodes of containers) are cut from big chunks and freed blocks are kept
+/// in pools by size for reuse. Big blocks (tables of containers) take own chunks which
+/// are freed immediately. All chunks are returned to the heap by release() or by the
+/// destructor at once, so the matrix of one request leaves no fragments in the heap.
+/// The arena is not thread safe.
+class Arena {
+    /// Header of the chunk in the list of chunks
+    struct alignas(std::max_align_t) Chunk {
+        Chunk *prev;
+        Chunk *next;
+        size_t size;
+    };
+
+    /// Freed block in the pool
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    static constexpr size_t granularity = alignof(std::max_align_t);
+    static constexpr size_t pool_count = 32; // pools of blocks up to 32 * granularity bytes
+
+    Chunk head_{&head_, &head_, 0};
+    char *current_{nullptr};
+    char *end_{nullptr};
+    FreeBlock *pools_[pool_count]{};
+    size_t chunk_size_;
+    size_t chunks_{0};
+    size_t capacity_{0};
+    size_t allocations_{0};
+
+    static constexpr size_t max_pooled() noexcept { return pool_count * granularity; }
+
+    static size_t round_up(size_t bytes) noexcept {
+        return (std::max<size_t>(bytes, 1) + granularity - 1) / granularity * granularity;
+    }
+
+    Chunk *allocate_chunk(size_t size) {
+        auto *chunk = static_cast<Chunk *>(::operator new(sizeof(Chunk) + size));
+        chunk->size = size;
+        chunk->prev = &head_;
+        chunk->next = head_.next;
+        head_.next->prev = chunk;
+        head_.next = chunk;
+        ++chunks_;
+        ++allocations_;
+        capacity_ += size;
+        return chunk;
+    }
+
+    void free_chunk(Chunk *chunk) noexcept {
+        chunk->prev->next = chunk->next;
+        chunk->next->prev = chunk->prev;
+        --chunks_;
+        capacity_ -= chunk->size;
+        ::operator delete(chunk);
+    }
+
+  public:
+    /// Default size of chunks for small blocks
+    static constexpr size_t default_chunk_size = 64 * 1024;
+
+    explicit Arena(size_t chunk_size = default_chunk_size)
+        : chunk_size_(std::max(round_up(chunk_size), max_pooled())) {}
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena() { release(); }
+
+    /// Allocate block aligned at most to alignof(std::max_align_t)
+    /// @throw std::bad_alloc if the alignment is greater
+    void *allocate(size_t bytes, size_t alignment = granularity) {
+        if (alignment > granularity) {
+            throw std::bad_alloc();
+        }
+        const size_t size = round_up(bytes);
+        if (size > max_pooled()) {
+            return allocate_chunk(size) + 1;
+        }
+
+        FreeBlock *&pool = pools_[size / granularity - 1];
+        if (pool != nullptr) {
+            FreeBlock *block = pool;
+            pool = block->next;
+            return block;
+        }
+        if (static_cast<size_t>(end_ - current_) < size) {
+            Chunk *chunk = allocate_chunk(chunk_size_);
+            current_ = reinterpret_cast<char *>(chunk + 1);
+            end_ = current_ + chunk_size_;
+        }
+        void *block = current_;
+        current_ += size;
+        return block;
+    }
+
+    /// Return the block to the pool or free the own chunk of the big block
+    void deallocate(void *pointer, size_t bytes, size_t /*alignment*/ = granularity) noexcept {
+        const size_t size = round_up(bytes);
+        if (size > max_pooled()) {
+            free_chunk(static_cast<Chunk *>(pointer) - 1);
+            return;
+        }
+        auto *block = static_cast<FreeBlock *>(pointer);
+        FreeBlock *&pool = pools_[size / granularity - 1];
+        block->next = pool;
+        pool = block;
+    }
+
+    /// Free all memory of the arena, blocks allocated before are invalid
+    void release() noexcept {
+        while (head_.next != &head_) {
+            free_chunk(head_.next);
+        }
+        std::fill(std::begin(pools_), std::end(pools_), nullptr);
+        current_ = end_ = nullptr;
+    }
+
+    /// Get count of chunks allocated from the global heap now
+    size_t chunks() const noexcept { return chunks_; }
+
+    /// Get count of bytes allocated from the global heap
+    size_t capacity() const noexcept { return capacity_; }
+
+    /// Get count of allocations from the global heap during the life of the arena
+    size_t allocations() const noexcept { return allocations_; }
+};
+
+/// Allocator of the arena for containers, copies of the allocator share the arena
+template <typename T>
+class ArenaAllocator {
+    template <typename U>
+    friend class ArenaAllocator;
+
+    Arena *arena_;
+
+  public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator(Arena &arena) noexcept : arena_(&arena) {} // NOLINT
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept : arena_(other.arena_) {} // NOLINT
+
+    T *allocate(size_t count) {
+        if (count > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T *>(arena_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *pointer, size_t count) noexcept {
+        arena_->deallocate(pointer, count * sizeof(T), alignof(T));
+    }
+
+    Arena &arena() const noexcept { return *arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const noexcept {
+        return arena_ == other.arena_;
+    }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+} // namespace otus
+
+#endif // OTUS_ARENA_HPP
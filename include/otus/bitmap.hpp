@@ -0,0 +1,70 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    bitmap.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: Bitmaps of occupied cells of dense containers.
+//
+
+#ifndef OTUS_BITMAP_HPP
+#define OTUS_BITMAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace otus {
+
+namespace detail {
+
+inline size_t count_trailing_zeros(uint64_t word) noexcept {
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_ctzll(word));
+#else
+    size_t count = 0;
+    for (; (word & 1) == 0; word >>= 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/// Count of 64-bit words of the bitmap of `count` bits
+constexpr size_t bitmap_words(size_t count) noexcept { return (count + 63) / 64; }
+
+inline bool test_bit(const uint64_t *words, size_t bit) noexcept {
+    return (words[bit / 64] >> (bit % 64) & 1) != 0;
+}
+inline void set_bit(uint64_t *words, size_t bit) noexcept {
+    words[bit / 64] |= uint64_t{1} << (bit % 64);
+}
+inline void reset_bit(uint64_t *words, size_t bit) noexcept {
+    words[bit / 64] &= ~(uint64_t{1} << (bit % 64));
+}
+
+/// Find the first set bit at the position or after it in the bitmap of `count` bits
+/// @return Position of the bit or `count` if all following bits are clear
+inline size_t find_set_bit(const uint64_t *words, size_t count, size_t position) noexcept {
+    size_t word = position / 64;
+    if (position >= count) {
+        return count;
+    }
+    uint64_t bits = words[word] & (~uint64_t{0} << (position % 64));
+    while (bits == 0) {
+        if (++word == bitmap_words(count)) {
+            return count;
+        }
+        bits = words[word];
+    }
+    return word * 64 + count_trailing_zeros(bits);
+}
+
+} // namespace detail
+
+} // namespace otus
+
+#endif // OTUS_BITMAP_HPP
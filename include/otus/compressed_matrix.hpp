@@ -0,0 +1,276 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    compressed_matrix.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: The immutable two dimension sparse matrix in CSR/CSC format.
+//
+
+#ifndef OTUS_COMPRESSED_MATRIX_HPP
+#define OTUS_COMPRESSED_MATRIX_HPP
+
+#include <otus/matrix.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace otus {
+
+/// Class of the immutable two dimension sparse matrix in compressed format
+///
+/// Elements are grouped by lines: rows for StorageOrder::row_major (CSR) and columns
+/// for StorageOrder::column_major (CSC). Only non-empty lines are stored, so indices
+/// of the matrix may be sparse. Each line keeps sorted minor indices and values of its
+/// elements in contiguous arrays, so scan of a line is a sequential memory access and
+/// lookup of an element is a binary search.
+template <typename T, T DefaultValue, StorageOrder Order>
+class CompressedMatrix {
+  public:
+    /// View of the one line (row or column) of the matrix
+    class Line;
+    /// Iterator of all elements of the matrix in the storage order
+    class Iterator;
+
+  private:
+    /// Using this Layout for access to the element by operator[]
+    class Layout;
+
+    static constexpr T default_value_{DefaultValue};
+    static constexpr bool row_major = Order == StorageOrder::row_major;
+
+    std::vector<size_t> line_indices_; // sorted indices of non-empty lines
+    std::vector<size_t> offsets_;      // position of the first element of each line
+    std::vector<size_t> indices_;      // minor indices of elements
+    std::vector<T> values_;            // values of elements
+
+  public:
+    CompressedMatrix() : offsets_(1, 0) {}
+
+    template <typename... Options>
+    explicit CompressedMatrix(const Matrix<T, DefaultValue, 2, Options...> &matrix) {
+        std::vector<std::tuple<size_t, size_t, T>> elements;
+        elements.reserve(matrix.size());
+        for (const auto element : matrix) {
+            const size_t row = std::get<0>(element), column = std::get<1>(element);
+            elements.emplace_back(row_major ? row : column, row_major ? column : row,
+                                  std::get<2>(element));
+        }
+        std::sort(elements.begin(), elements.end(), [](const auto &lhs, const auto &rhs) {
+            return std::tie(std::get<0>(lhs), std::get<1>(lhs)) <
+                   std::tie(std::get<0>(rhs), std::get<1>(rhs));
+        });
+
+        indices_.reserve(elements.size());
+        values_.reserve(elements.size());
+        for (const auto &element : elements) {
+            if (line_indices_.empty() || line_indices_.back() != std::get<0>(element)) {
+                line_indices_.push_back(std::get<0>(element));
+                offsets_.push_back(indices_.size());
+            }
+            indices_.push_back(std::get<1>(element));
+            values_.push_back(std::get<2>(element));
+        }
+        offsets_.push_back(indices_.size());
+    }
+
+    bool operator==(const CompressedMatrix &other) const {
+        return line_indices_ == other.line_indices_ && offsets_ == other.offsets_ &&
+               indices_ == other.indices_ && values_ == other.values_;
+    }
+    bool operator!=(const CompressedMatrix &other) const { return !(*this == other); }
+
+    Layout operator[](size_t idx) const { return Layout(*this, idx); }
+
+    /// Get value of the element by binary search in its line
+    const T &get(size_t row, size_t column) const noexcept {
+        return line(row_major ? row : column)[row_major ? column : row];
+    }
+
+    /// Get the line by its index (the line is empty if there are no elements in it)
+    Line line(size_t index) const noexcept {
+        auto iter = std::lower_bound(line_indices_.cbegin(), line_indices_.cend(), index);
+        if (iter == line_indices_.cend() || *iter != index) {
+            return Line(index, nullptr, nullptr, 0);
+        }
+        return line_at(static_cast<size_t>(iter - line_indices_.cbegin()));
+    }
+
+    /// Get non-empty line by its position in the storage, position < line_count()
+    Line line_at(size_t position) const noexcept {
+        const size_t first = offsets_[position];
+        return Line(line_indices_[position], indices_.data() + first, values_.data() + first,
+                    offsets_[position + 1] - first);
+    }
+
+    /// Get the row of CSR matrix
+    Line row(size_t idx) const noexcept {
+        static_assert(row_major, "Rows are contiguous only in CSR matrix, use CSC for columns");
+        return line(idx);
+    }
+
+    /// Get the column of CSC matrix
+    Line column(size_t idx) const noexcept {
+        static_assert(!row_major, "Columns are contiguous only in CSC matrix, use CSR for rows");
+        return line(idx);
+    }
+
+    /// Get count of non-empty lines
+    size_t line_count() const noexcept { return line_indices_.size(); }
+
+    /// Return an iterator to the beginning
+    /// @return Iterator of tuples (row, column, value)
+    Iterator begin() const noexcept { return Iterator(this, 0, 0); }
+
+    /// Return an iterator to the end
+    Iterator end() const noexcept { return Iterator(this, line_count(), size()); }
+
+    /// Get real count of elements in matrix
+    size_t size() const noexcept { return values_.size(); }
+
+    /// Make mutable matrix with the same elements allocated by the allocator
+    template <typename... Options>
+    Matrix<T, DefaultValue, 2, Options...>
+    thaw(const typename Matrix<T, DefaultValue, 2, Options...>::allocator_type &allocator =
+             {}) const {
+        Matrix<T, DefaultValue, 2, Options...> matrix(allocator);
+        matrix.insert_bulk(begin(), end());
+        return matrix;
+    }
+};
+
+// ********************************
+// * Class CompressedMatrix::Line *
+// ********************************
+template <typename T, T DefaultValue, StorageOrder Order>
+class CompressedMatrix<T, DefaultValue, Order>::Line {
+    size_t index_;
+    const size_t *indices_;
+    const T *values_;
+    size_t size_;
+
+  public:
+    /// Iterator of pairs (minor index, value) of the line
+    class Iterator {
+        const size_t *index_;
+        const T *value_;
+
+      public:
+        using value_type = std::pair<size_t, const T &>;
+        using difference_type = ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+        using iterator_category = std::input_iterator_tag;
+
+        Iterator(const size_t *index, const T *value) : index_(index), value_(value) {}
+
+        Iterator &operator++() {
+            ++index_;
+            ++value_;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator retval = *this;
+            ++(*this);
+            return retval;
+        }
+        bool operator==(Iterator other) const { return index_ == other.index_; }
+        bool operator!=(Iterator other) const { return !(*this == other); }
+
+        value_type operator*() const { return value_type(*index_, *value_); }
+    };
+
+    Line(size_t index, const size_t *indices, const T *values, size_t size)
+        : index_(index), indices_(indices), values_(values), size_(size) {}
+
+    /// Get index of the line (row or column)
+    size_t index() const noexcept { return index_; }
+    /// Get count of elements in the line
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    /// Sorted minor indices of elements
+    const size_t *indices() const noexcept { return indices_; }
+    /// Values of elements in the order of indices()
+    const T *values() const noexcept { return values_; }
+
+    /// Get value of the element by binary search
+    const T &operator[](size_t idx) const noexcept {
+        const size_t *last = indices_ + size_;
+        const size_t *iter = std::lower_bound(indices_, last, idx);
+        return (iter != last && *iter == idx) ? values_[iter - indices_] : default_value_;
+    }
+
+    Iterator begin() const noexcept { return Iterator(indices_, values_); }
+    Iterator end() const noexcept { return Iterator(indices_ + size_, values_ + size_); }
+};
+
+// ************************************
+// * Class CompressedMatrix::Iterator *
+// ************************************
+template <typename T, T DefaultValue, StorageOrder Order>
+class CompressedMatrix<T, DefaultValue, Order>::Iterator {
+    const CompressedMatrix *matrix_;
+    size_t line_;
+    size_t position_;
+
+  public:
+    using value_type = std::tuple<size_t, size_t, const T &>;
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+    using iterator_category = std::input_iterator_tag;
+
+    Iterator(const CompressedMatrix *matrix, size_t line, size_t position)
+        : matrix_(matrix), line_(line), position_(position) {}
+
+    Iterator &operator++() {
+        if (++position_ == matrix_->offsets_[line_ + 1]) {
+            ++line_;
+        }
+        return *this;
+    }
+    Iterator operator++(int) {
+        Iterator retval = *this;
+        ++(*this);
+        return retval;
+    }
+    bool operator==(Iterator other) const { return position_ == other.position_; }
+    bool operator!=(Iterator other) const { return !(*this == other); }
+
+    value_type operator*() const {
+        const size_t major = matrix_->line_indices_[line_];
+        const size_t minor = matrix_->indices_[position_];
+        return value_type(row_major ? major : minor, row_major ? minor : major,
+                          matrix_->values_[position_]);
+    }
+};
+
+// **********************************
+// * Class CompressedMatrix::Layout *
+// **********************************
+template <typename T, T DefaultValue, StorageOrder Order>
+class CompressedMatrix<T, DefaultValue, Order>::Layout {
+    const CompressedMatrix &matrix_;
+    size_t row_;
+
+  public:
+    Layout(const CompressedMatrix &matrix, size_t row) : matrix_(matrix), row_(row) {}
+
+    const T &operator[](size_t column) const noexcept { return matrix_.get(row_, column); }
+};
+
+template <typename T, T DefaultValue, StorageOrder Order>
+constexpr T CompressedMatrix<T, DefaultValue, Order>::default_value_;
+
+} // namespace otus
+
+#endif // OTUS_COMPRESSED_MATRIX_HPP
@@ -0,0 +1,274 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    compressed_tensor.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: The immutable multi-dimensional sparse matrix in CSF format.
+//
+
+#ifndef OTUS_COMPRESSED_TENSOR_HPP
+#define OTUS_COMPRESSED_TENSOR_HPP
+
+#include <otus/matrix.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace otus {
+
+/// Class of the immutable multi-dimensional sparse matrix in compressed sparse fiber format
+///
+/// Elements are stored as a tree of sorted coordinates: level L keeps the coordinates on
+/// axis L of all distinct prefixes of length L + 1, and the children of node K of level L
+/// are the nodes [pointers[L][K], pointers[L][K + 1]) of level L + 1. Values are aligned
+/// with the nodes of the last level. So the elements of any slice m[i][j]... are a
+/// contiguous range of the last level.
+template <typename T, T DefaultValue, size_t Dimension>
+class CsfTensor {
+    static_assert(Dimension > 0, "Dimension of the tensor must be positive");
+
+  public:
+    using Indices = std::array<size_t, Dimension>;
+
+    /// Iterator of all elements of the tensor or its slice in lexicographic order
+    class Iterator;
+
+  private:
+    /// Using this Layout for resolve partial indices by operator[]
+    template <size_t N>
+    class Layout;
+
+    static constexpr T default_value_{DefaultValue};
+
+    std::array<std::vector<size_t>, Dimension> indices_;      // sorted coordinates per level
+    std::array<std::vector<size_t>, Dimension - 1> pointers_; // first child of each node
+    std::vector<T> values_;                                   // values of elements
+
+    template <typename Element, size_t... I>
+    static Indices make_indices(const Element &element, std::index_sequence<I...>) {
+        return Indices{{std::get<I>(element)...}};
+    }
+
+    /// Find coordinate in the nodes [first, last) of level
+    size_t find(size_t level, size_t first, size_t last, size_t idx) const noexcept {
+        const size_t *begin = indices_[level].data();
+        const size_t *iter = std::lower_bound(begin + first, begin + last, idx);
+        return (iter != begin + last && *iter == idx) ? static_cast<size_t>(iter - begin) : last;
+    }
+
+  public:
+    CsfTensor() { pointers_.fill(std::vector<size_t>(1, 0)); }
+
+    template <typename... Options>
+    explicit CsfTensor(const Matrix<T, DefaultValue, Dimension, Options...> &matrix) {
+        std::vector<std::pair<Indices, T>> elements;
+        elements.reserve(matrix.size());
+        for (const auto element : matrix) {
+            elements.emplace_back(make_indices(element, std::make_index_sequence<Dimension>{}),
+                                  std::get<Dimension>(element));
+        }
+        std::sort(elements.begin(), elements.end(),
+                  [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+
+        values_.reserve(elements.size());
+        indices_[Dimension - 1].reserve(elements.size());
+        const Indices *previous = nullptr;
+        for (const auto &element : elements) {
+            const Indices &indices = element.first;
+            // first level where the element leaves the branch of the previous element
+            size_t level = 0;
+            while (previous != nullptr && level + 1 < Dimension &&
+                   (*previous)[level] == indices[level]) {
+                ++level;
+            }
+            for (; level + 1 < Dimension; ++level) {
+                indices_[level].push_back(indices[level]);
+                pointers_[level].push_back(indices_[level + 1].size());
+            }
+            indices_[Dimension - 1].push_back(indices[Dimension - 1]);
+            values_.push_back(element.second);
+            previous = &indices;
+        }
+        for (size_t level = 0; level + 1 < Dimension; ++level) {
+            pointers_[level].push_back(indices_[level + 1].size());
+        }
+    }
+
+    bool operator==(const CsfTensor &other) const {
+        return indices_ == other.indices_ && pointers_ == other.pointers_ &&
+               values_ == other.values_;
+    }
+    bool operator!=(const CsfTensor &other) const { return !(*this == other); }
+
+    /// Get slice of the tensor by the first index
+    decltype(auto) operator[](size_t idx) const {
+        return Layout<Dimension>(*this, 0, nodes(0))[idx];
+    }
+
+    /// Get value of the element by binary search on each level
+    const T &get(const Indices &indices) const noexcept {
+        size_t first = 0, last = nodes(0);
+        for (size_t level = 0; level + 1 < Dimension; ++level) {
+            const size_t node = find(level, first, last, indices[level]);
+            if (node == last) {
+                return default_value_;
+            }
+            first = pointers_[level][node];
+            last = pointers_[level][node + 1];
+        }
+        const size_t node = find(Dimension - 1, first, last, indices[Dimension - 1]);
+        return node == last ? default_value_ : values_[node];
+    }
+
+    /// Get count of nodes on the level, nodes(Dimension - 1) == size()
+    size_t nodes(size_t level) const noexcept { return indices_[level].size(); }
+
+    /// Return an iterator to the beginning
+    /// @return Iterator of tuples (index 1, index 2, ..., value)
+    Iterator begin() const { return Iterator(this, 0); }
+
+    /// Return an iterator to the end
+    Iterator end() const { return Iterator(this, size()); }
+
+    /// Get real count of elements in tensor
+    size_t size() const noexcept { return values_.size(); }
+
+    /// Make mutable matrix with the same elements allocated by the allocator
+    template <typename... Options>
+    Matrix<T, DefaultValue, Dimension, Options...>
+    thaw(const typename Matrix<T, DefaultValue, Dimension, Options...>::allocator_type &allocator =
+             {}) const {
+        Matrix<T, DefaultValue, Dimension, Options...> matrix(allocator);
+        matrix.insert_bulk(begin(), end());
+        return matrix;
+    }
+};
+
+// ***************************
+// * Class CsfTensor::Layout *
+// ***************************
+template <typename T, T DefaultValue, size_t Dimension>
+template <size_t N>
+class CsfTensor<T, DefaultValue, Dimension>::Layout {
+    static constexpr size_t level_ = Dimension - N;
+
+    const CsfTensor &tensor_;
+    size_t first_; // nodes [first_, last_) of the level
+    size_t last_;
+
+    Layout<N - 1> next(size_t idx, std::false_type) const noexcept {
+        const size_t node = tensor_.find(level_, first_, last_, idx);
+        if (node == last_) {
+            return Layout<N - 1>(tensor_, 0, 0);
+        }
+        return Layout<N - 1>(tensor_, tensor_.pointers_[level_][node],
+                             tensor_.pointers_[level_][node + 1]);
+    }
+
+    const T &next(size_t idx, std::true_type) const noexcept {
+        const size_t node = tensor_.find(level_, first_, last_, idx);
+        return node == last_ ? default_value_ : tensor_.values_[node];
+    }
+
+    /// Range of the elements on the last level
+    std::pair<size_t, size_t> elements() const noexcept {
+        size_t first = first_, last = last_;
+        for (size_t level = level_; level + 1 < Dimension; ++level) {
+            first = tensor_.pointers_[level][first];
+            last = tensor_.pointers_[level][last];
+        }
+        return {first, last};
+    }
+
+  public:
+    Layout(const CsfTensor &tensor, size_t first, size_t last)
+        : tensor_(tensor), first_(first), last_(last) {}
+
+    /// Get slice by the next index or the value of the element by the last index
+    decltype(auto) operator[](size_t idx) const {
+        return next(idx, std::integral_constant<bool, N == 1>{});
+    }
+
+    /// Iterate over elements of the slice, contiguous range of the last level
+    Iterator begin() const { return Iterator(&tensor_, elements().first); }
+    Iterator end() const { return Iterator(&tensor_, elements().second); }
+
+    /// Get count of elements in the slice
+    size_t size() const noexcept {
+        const auto range = elements();
+        return range.second - range.first;
+    }
+    bool empty() const noexcept { return first_ == last_; }
+};
+
+// *****************************
+// * Class CsfTensor::Iterator *
+// *****************************
+template <typename T, T DefaultValue, size_t Dimension>
+class CsfTensor<T, DefaultValue, Dimension>::Iterator {
+    const CsfTensor *tensor_;
+    Indices nodes_; // current node on each level
+
+    template <size_t... I>
+    inline auto get_value(std::index_sequence<I...>) const {
+        return value_type(tensor_->indices_[I][nodes_[I]]..., tensor_->values_[nodes_.back()]);
+    }
+
+    using TupleKey = typename detail::generate_tuple_type<size_t, Dimension>::type;
+
+  public:
+    using value_type = decltype(
+        std::tuple_cat(std::declval<TupleKey>(), std::declval<std::tuple<const T &>>()));
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+    using iterator_category = std::input_iterator_tag;
+
+    Iterator(const CsfTensor *tensor, size_t position) : tensor_(tensor) {
+        nodes_.back() = position;
+        for (size_t level = Dimension - 1; level-- > 0;) {
+            const auto &pointers = tensor_->pointers_[level];
+            const auto iter =
+                std::upper_bound(pointers.cbegin(), pointers.cend(), nodes_[level + 1]);
+            nodes_[level] = static_cast<size_t>(iter - pointers.cbegin()) - 1;
+        }
+    }
+
+    Iterator &operator++() {
+        ++nodes_.back();
+        for (size_t level = Dimension - 1; level-- > 0;) {
+            if (nodes_[level + 1] != tensor_->pointers_[level][nodes_[level] + 1]) {
+                break;
+            }
+            ++nodes_[level];
+        }
+        return *this;
+    }
+    Iterator operator++(int) {
+        Iterator retval = *this;
+        ++(*this);
+        return retval;
+    }
+    bool operator==(const Iterator &other) const { return nodes_.back() == other.nodes_.back(); }
+    bool operator!=(const Iterator &other) const { return !(*this == other); }
+
+    value_type operator*() const { return get_value(std::make_index_sequence<Dimension>{}); }
+};
+
+template <typename T, T DefaultValue, size_t Dimension>
+constexpr T CsfTensor<T, DefaultValue, Dimension>::default_value_;
+
+} // namespace otus
+
+#endif // OTUS_COMPRESSED_TENSOR_HPP
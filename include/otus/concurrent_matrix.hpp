@@ -0,0 +1,134 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    concurrent_matrix.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: The multi-dimensional sparse matrix for concurrent access.
+//
+
+#ifndef OTUS_CONCURRENT_MATRIX_HPP
+#define OTUS_CONCURRENT_MATRIX_HPP
+
+#include <otus/matrix.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+namespace otus {
+
+/// Class of the multi-dimensional sparse matrix which may be shared between threads
+///
+/// Elements are partitioned across shards by hash of their indices. Each shard is an
+/// otus::Matrix with its own reader/writer lock, so threads which touch different shards
+/// do not wait for each other. Options are the same as for otus::Matrix of shards.
+template <typename T, T DefaultValue, size_t Dimension = 2, typename... Options>
+class ConcurrentMatrix {
+  public:
+    using Shard = Matrix<T, DefaultValue, Dimension, Options...>;
+    using Indices = typename Shard::Indices;
+
+    /// Default count of shards, enough for tens of threads
+    static constexpr size_t default_shards = 64;
+
+  private:
+    using KeyPolicy = detail::select_option_t<detail::key_option, TupleKeys, Options...>;
+    using KeyCodec = typename KeyPolicy::template codec<Dimension>;
+    using KeyHash =
+        detail::select_option_t<detail::hash_option, typename KeyCodec::hasher, Options...>;
+
+    struct LockedShard {
+        mutable std::shared_timed_mutex mutex;
+        Shard matrix;
+    };
+
+    size_t mask_;
+    std::unique_ptr<LockedShard[]> shards_;
+
+    LockedShard &shard(const Indices &indices) const {
+        // the container of the shard also uses the hash, so take other bits of it
+        const uint64_t hash = KeyHash{}(KeyCodec::encode(indices));
+        return shards_[static_cast<size_t>(detail::avalanche(hash)) & mask_];
+    }
+
+  public:
+    /// Make the matrix with count of shards rounded up to a power of two
+    explicit ConcurrentMatrix(size_t shards = default_shards) : mask_(1) {
+        while (mask_ < shards) {
+            mask_ <<= 1;
+        }
+        shards_ = std::make_unique<LockedShard[]>(mask_--);
+    }
+
+    ConcurrentMatrix(const ConcurrentMatrix &) = delete;
+    ConcurrentMatrix &operator=(const ConcurrentMatrix &) = delete;
+
+    /// Get value of the element
+    T get(const Indices &indices) const {
+        const auto &locked = shard(indices);
+        std::shared_lock<std::shared_timed_mutex> lock(locked.mutex);
+        return locked.matrix.at(indices);
+    }
+
+    /// Set value of the element, the element is removed if the value is default
+    void set(const Indices &indices, const T &value) {
+        auto &locked = shard(indices);
+        std::lock_guard<std::shared_timed_mutex> lock(locked.mutex);
+        locked.matrix.at(indices) = value;
+    }
+
+    /// Replace value of the element by result of `function(value)` atomically
+    /// @return New value of the element
+    template <typename Function>
+    T update(const Indices &indices, Function &&function) {
+        auto &locked = shard(indices);
+        std::lock_guard<std::shared_timed_mutex> lock(locked.mutex);
+        return locked.matrix.update(indices, std::forward<Function>(function));
+    }
+
+    /// Remove the element
+    /// @return count of removed elements
+    size_t erase(const Indices &indices) {
+        auto &locked = shard(indices);
+        std::lock_guard<std::shared_timed_mutex> lock(locked.mutex);
+        return locked.matrix.erase(indices);
+    }
+
+    /// Get count of elements, all shards are locked together for consistent result
+    size_t size() const {
+        for (size_t i = 0; i <= mask_; ++i) {
+            shards_[i].mutex.lock_shared();
+        }
+        size_t count = 0;
+        for (size_t i = 0; i <= mask_; ++i) {
+            count += shards_[i].matrix.size();
+            shards_[i].mutex.unlock_shared();
+        }
+        return count;
+    }
+
+    /// Get count of shards
+    size_t shards() const noexcept { return mask_ + 1; }
+
+    /// Remove all elements
+    void clear() {
+        for (size_t i = 0; i <= mask_; ++i) {
+            std::lock_guard<std::shared_timed_mutex> lock(shards_[i].mutex);
+            shards_[i].matrix.clear();
+        }
+    }
+};
+
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+constexpr size_t ConcurrentMatrix<T, DefaultValue, Dimension, Options...>::default_shards;
+
+} // namespace otus
+
+#endif // OTUS_CONCURRENT_MATRIX_HPP
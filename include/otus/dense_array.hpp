@@ -0,0 +1,335 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    dense_array.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: The map of offsets of cells kept as the plain array.
+//
+
+#ifndef OTUS_DENSE_ARRAY_HPP
+#define OTUS_DENSE_ARRAY_HPP
+
+#include <otus/bitmap.hpp>
+#include <otus/prefetch.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace otus {
+
+/// Map of offsets of cells [0, Size) kept as the array of all cells with the bitmap of
+/// occupied cells, so lookup is one load without hashing and probing
+///
+/// The array is allocated by the first insertion (or reserve) and kept by clear().
+/// Lookups of keys out of [0, Size) find nothing and insertions of them throw
+/// std::out_of_range. Iterators give std::pair<const Key, Value &>, which lives inside
+/// the iterator.
+template <typename Key, typename Value, size_t Size,
+          typename Allocator = std::allocator<std::pair<const Key, Value>>>
+class DenseArray {
+    static_assert(std::is_integral<Key>::value, "Keys of the dense array are offsets of cells");
+    static_assert(Size > 0, "The dense array must have cells");
+
+    template <typename T>
+    using rebind_t = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+    static constexpr size_t words = detail::bitmap_words(Size);
+
+    std::vector<Value, rebind_t<Value>> values_;
+    std::vector<uint64_t, rebind_t<uint64_t>> occupied_;
+    size_t size_{0};
+
+    template <typename V>
+    class CellIterator;
+
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value &>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using allocator_type = Allocator;
+    using iterator = CellIterator<Value>;
+    using const_iterator = CellIterator<const Value>;
+
+    DenseArray() = default;
+    explicit DenseArray(const allocator_type &allocator)
+        : values_(rebind_t<Value>(allocator)), occupied_(rebind_t<uint64_t>(allocator)) {}
+    DenseArray(const DenseArray &other, const allocator_type &allocator)
+        : values_(other.values_, rebind_t<Value>(allocator)),
+          occupied_(other.occupied_, rebind_t<uint64_t>(allocator)), size_(other.size_) {}
+    DenseArray(const DenseArray &) = default;
+    DenseArray(DenseArray &&other) noexcept
+        : values_(std::move(other.values_)), occupied_(std::move(other.occupied_)),
+          size_(other.size_) {
+        other.size_ = 0;
+    }
+
+    DenseArray &operator=(const DenseArray &) = default;
+    DenseArray &operator=(DenseArray &&other) noexcept(
+        std::allocator_traits<rebind_t<Value>>::propagate_on_container_move_assignment::value) {
+        if (this != &other) {
+            values_ = std::move(other.values_);
+            occupied_ = std::move(other.occupied_);
+            size_ = other.size_;
+            other.clear(); // vectors of other allocators may keep moved cells
+        }
+        return *this;
+    }
+
+    iterator begin() noexcept { return iterator(this, first_occupied(0)); }
+    const_iterator begin() const noexcept { return const_iterator(this, first_occupied(0)); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept { return iterator(this, Size); }
+    const_iterator end() const noexcept { return const_iterator(this, Size); }
+    const_iterator cend() const noexcept { return end(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    iterator find(const key_type &key) noexcept {
+        return iterator(this, contains(key) ? static_cast<size_t>(key) : Size);
+    }
+    const_iterator find(const key_type &key) const noexcept {
+        return const_iterator(this, contains(key) ? static_cast<size_t>(key) : Size);
+    }
+    size_type count(const key_type &key) const noexcept { return contains(key) ? 1 : 0; }
+
+    /// Load the cell and its word of the bitmap ahead of the following lookup of the key
+    void prefetch(const key_type &key) const noexcept {
+        if (!values_.empty() && static_cast<size_t>(key) < Size) {
+            detail::prefetch(values_.data() + static_cast<size_t>(key));
+            detail::prefetch(occupied_.data() + static_cast<size_t>(key) / 64);
+        }
+    }
+
+    /// Get the value of the cell or the fallback for the absent cell without iterators
+    const mapped_type &value_or(const key_type &key, const mapped_type &fallback) const noexcept {
+        const auto offset = static_cast<size_t>(key);
+        if (values_.empty() || offset >= Size) {
+            return fallback;
+        }
+        // select the address instead of branching: absent cells are unpredictable
+        const mapped_type *cells[] = {&fallback, &values_[offset]};
+        return *cells[detail::test_bit(occupied_.data(), offset)];
+    }
+
+    /// Insert a new element constructed from the arguments if the cell is absent
+    /// @return Iterator to the element with the key and true if insertion took place
+    /// @throw std::out_of_range if the key is not the offset of a cell
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type &key, Args &&... args) {
+        const auto offset = static_cast<size_t>(key);
+        if (offset >= Size) {
+            throw std::out_of_range("Offset of the cell is out of the dense array");
+        }
+        allocate();
+        if (detail::test_bit(occupied_.data(), offset)) {
+            return {iterator(this, offset), false};
+        }
+        values_[offset] = Value(std::forward<Args>(args)...);
+        detail::set_bit(occupied_.data(), offset);
+        ++size_;
+        return {iterator(this, offset), true};
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplace(K &&key, Args &&... args) {
+        return try_emplace(static_cast<key_type>(key), std::forward<Args>(args)...);
+    }
+
+    mapped_type &operator[](const key_type &key) { return try_emplace(key).first->second; }
+
+    /// Remove the element
+    /// @return Iterator to the element following the removed one
+    iterator erase(const_iterator position) {
+        detail::reset_bit(occupied_.data(), position.offset_);
+        values_[position.offset_] = Value();
+        --size_;
+        return iterator(this, first_occupied(position.offset_ + 1));
+    }
+    iterator erase(iterator position) { return erase(const_iterator(position)); }
+
+    size_type erase(const key_type &key) {
+        if (!contains(key)) {
+            return 0;
+        }
+        erase(find(key));
+        return 1;
+    }
+
+    void clear() noexcept {
+        std::fill(occupied_.begin(), occupied_.end(), 0);
+        size_ = 0;
+    }
+
+    /// Allocate the array, the count is not used: all cells have places
+    void reserve(size_type count) {
+        if (count > 0) {
+            allocate();
+        }
+    }
+
+    size_type bucket_count() const noexcept { return Size; }
+    size_type slot_count() const noexcept { return Size; }
+
+    float load_factor() const noexcept { return static_cast<float>(size_) / Size; }
+    /// The array never grows, so the maximum load factor is always 1
+    float max_load_factor() const noexcept { return 1.0f; }
+    void max_load_factor(float) noexcept {}
+
+    /// Get bytes of memory held by the array and the bitmap
+    size_type allocated_bytes() const noexcept {
+        return values_.capacity() * sizeof(Value) + occupied_.capacity() * sizeof(uint64_t);
+    }
+
+    allocator_type get_allocator() const { return allocator_type(values_.get_allocator()); }
+
+    /// Call `function(element)` for elements in cells [first, last), so threads may
+    /// visit disjoint ranges of cells of the same array
+    template <typename Function>
+    void for_each_in_slots(size_type first, size_type last, Function &&function) const {
+        last = std::min(last, Size);
+        if (size_ == 0 || first >= last) {
+            return;
+        }
+        // walk words of the bitmap clearing the lowest bit instead of searching every cell
+        for (size_t word = first / 64; word * 64 < last; ++word) {
+            uint64_t bits = occupied_[word];
+            if (word == first / 64) {
+                bits &= ~uint64_t{0} << (first % 64);
+            }
+            for (; bits != 0; bits &= bits - 1) {
+                const size_t offset = word * 64 + detail::count_trailing_zeros(bits);
+                if (offset >= last) {
+                    return;
+                }
+                const std::pair<const Key, const Value &> element(static_cast<Key>(offset),
+                                                                  values_[offset]);
+                function(element);
+            }
+        }
+    }
+
+    friend bool operator==(const DenseArray &lhs, const DenseArray &rhs) {
+        if (lhs.size_ != rhs.size_) {
+            return false;
+        }
+        for (size_t offset = lhs.first_occupied(0); offset != Size;
+             offset = lhs.first_occupied(offset + 1)) {
+            if (!rhs.contains(static_cast<Key>(offset)) ||
+                !(lhs.values_[offset] == rhs.values_[offset])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend bool operator!=(const DenseArray &lhs, const DenseArray &rhs) { return !(lhs == rhs); }
+
+  private:
+    bool contains(const key_type &key) const noexcept {
+        return size_ != 0 && static_cast<size_t>(key) < Size &&
+               detail::test_bit(occupied_.data(), static_cast<size_t>(key));
+    }
+
+    size_t first_occupied(size_t offset) const noexcept {
+        return size_ != 0 ? detail::find_set_bit(occupied_.data(), Size, offset) : Size;
+    }
+
+    void allocate() {
+        if (values_.empty()) {
+            values_.resize(Size);
+            occupied_.assign(words, 0);
+        }
+    }
+};
+
+// **********************************
+// * Class DenseArray::CellIterator *
+// **********************************
+template <typename Key, typename Value, size_t Size, typename Allocator>
+template <typename V>
+class DenseArray<Key, Value, Size, Allocator>::CellIterator {
+    friend class DenseArray;
+    template <typename OtherType>
+    friend class CellIterator;
+
+    using Array = std::conditional_t<std::is_const<V>::value, const DenseArray, DenseArray>;
+    using Entry = std::pair<const Key, V &>;
+
+    Array *array_{nullptr};
+    size_t offset_{Size};
+    // the pair with the reference is not assignable, so it is made again by every access
+    mutable typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type entry_;
+
+    const Entry *load() const noexcept {
+        return new (&entry_) Entry(static_cast<Key>(offset_), array_->values_[offset_]);
+    }
+
+  public:
+    // references to the entry in the iterator are invalidated by the next access, so
+    // iterators can not be forward ones
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Entry;
+    using difference_type = ptrdiff_t;
+    using pointer = const Entry *;
+    using reference = const Entry &;
+
+    CellIterator() = default;
+    CellIterator(Array *array, size_t offset) noexcept : array_(array), offset_(offset) {}
+    CellIterator(const CellIterator &other) noexcept
+        : array_(other.array_), offset_(other.offset_) {}
+    CellIterator &operator=(const CellIterator &other) noexcept {
+        array_ = other.array_;
+        offset_ = other.offset_;
+        return *this;
+    }
+
+    /// Iterator is implicitly converted to const_iterator
+    template <typename OtherType,
+              typename = std::enable_if_t<std::is_same<const OtherType, V>::value &&
+                                          !std::is_same<OtherType, V>::value>>
+    CellIterator(const CellIterator<OtherType> &other) noexcept // NOLINT
+        : array_(other.array_), offset_(other.offset_) {}
+
+    reference operator*() const noexcept { return *load(); }
+    pointer operator->() const noexcept { return load(); }
+
+    CellIterator &operator++() noexcept {
+        offset_ = array_->first_occupied(offset_ + 1);
+        return *this;
+    }
+    CellIterator operator++(int) noexcept {
+        CellIterator retval = *this;
+        ++(*this);
+        return retval;
+    }
+    template <typename OtherType>
+    bool operator==(const CellIterator<OtherType> &other) const noexcept {
+        return offset_ == other.offset_;
+    }
+    template <typename OtherType>
+    bool operator!=(const CellIterator<OtherType> &other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+template <typename Key, typename Value, size_t Size, typename Allocator>
+constexpr size_t DenseArray<Key, Value, Size, Allocator>::words;
+
+} // namespace otus
+
+#endif // OTUS_DENSE_ARRAY_HPP
@@ -0,0 +1,298 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    expression.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: Expression templates of element-wise operations with matrices.
+//
+
+#ifndef OTUS_EXPRESSION_HPP
+#define OTUS_EXPRESSION_HPP
+
+#include <otus/matrix.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace otus {
+
+namespace detail {
+
+template <typename Type>
+struct is_matrix_operand : std::false_type {};
+
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+struct is_matrix_operand<Matrix<T, DefaultValue, Dimension, Options...>> : std::true_type {};
+
+template <typename Operation, typename Lhs, typename Rhs>
+struct is_matrix_operand<Expression<Operation, Lhs, Rhs>> : std::true_type {};
+
+/// Operands of element-wise operation: two matrices or a matrix and a scalar
+template <typename Lhs, typename Rhs>
+using enable_if_operands =
+    std::enable_if_t<(is_matrix_operand<Lhs>::value &&
+                      (is_matrix_operand<Rhs>::value || std::is_arithmetic<Rhs>::value)) ||
+                     (std::is_arithmetic<Lhs>::value && is_matrix_operand<Rhs>::value)>;
+
+/// Leaf of the expression: reference to the matrix
+template <typename MatrixType>
+class MatrixLeaf {
+    const MatrixType &matrix_;
+
+  public:
+    using value_type = typename MatrixType::value_type;
+    using Indices = typename MatrixType::Indices;
+
+    explicit MatrixLeaf(const MatrixType &matrix) : matrix_(matrix) {}
+
+    /// Get value of the element which is `known` in the leaf number `position`.
+    /// Leaves before it do not contain the element (checked by contains()).
+    value_type value(const Indices &indices, ptrdiff_t &position, const value_type &known) const {
+        const ptrdiff_t leaf = position--;
+        if (leaf > 0) {
+            return MatrixType::default_value();
+        }
+        return (leaf == 0) ? known : static_cast<value_type>(matrix_.at(indices));
+    }
+    value_type default_value() const noexcept { return MatrixType::default_value(); }
+
+    /// Check that the element is stored in one of the first `count` leaves
+    bool contains(const Indices &indices, size_t &count) const {
+        if (count == 0) {
+            return false;
+        }
+        --count;
+        return matrix_.at(indices) != MatrixType::default_value();
+    }
+
+    template <typename Function>
+    void for_each_leaf(Function &&function) const {
+        function(matrix_);
+    }
+
+    /// Get allocator of the result from the matrix
+    template <typename Result>
+    typename Result::allocator_type allocator() const {
+        return detail::allocator_like<Result>(matrix_);
+    }
+
+    size_t max_size() const noexcept { return matrix_.size(); }
+};
+
+/// Leaf of the expression: scalar which is equal in all elements
+template <typename T, typename IndicesType>
+class ScalarLeaf {
+    T value_;
+
+  public:
+    using value_type = T;
+    using Indices = IndicesType;
+
+    explicit ScalarLeaf(T value) : value_(value) {}
+
+    value_type value(const Indices &, ptrdiff_t &, const value_type &) const noexcept {
+        return value_;
+    }
+    value_type default_value() const noexcept { return value_; }
+
+    bool contains(const Indices &, size_t &) const noexcept { return false; }
+
+    template <typename Function>
+    void for_each_leaf(Function &&) const {}
+
+    template <typename Result>
+    typename Result::allocator_type allocator() const {
+        return typename Result::allocator_type();
+    }
+
+    size_t max_size() const noexcept { return 0; }
+};
+
+/// Make node of the expression from the operand, the scalar gets type and indices of the other
+template <typename Other, typename Operand>
+auto make_node(const Operand &operand, std::true_type /*is_matrix_operand*/) {
+    return MatrixLeaf<Operand>(operand);
+}
+
+template <typename Other, typename Operation, typename Lhs, typename Rhs>
+auto make_node(const Expression<Operation, Lhs, Rhs> &operand, std::true_type) {
+    return operand;
+}
+
+template <typename Other, typename Scalar>
+auto make_node(const Scalar &scalar, std::false_type /*is_matrix_operand*/) {
+    using Leaf = decltype(make_node<void>(std::declval<const Other &>(), std::true_type{}));
+    return ScalarLeaf<typename Leaf::value_type, typename Leaf::Indices>(
+        static_cast<typename Leaf::value_type>(scalar));
+}
+
+template <typename Operation, typename Lhs, typename Rhs>
+auto make_expression(Operation operation, const Lhs &lhs, const Rhs &rhs) {
+    auto left = make_node<Rhs>(lhs, is_matrix_operand<Lhs>{});
+    auto right = make_node<Lhs>(rhs, is_matrix_operand<Rhs>{});
+    return Expression<Operation, decltype(left), decltype(right)>(operation, left, right);
+}
+
+template <typename Indices, typename Element, size_t... I>
+Indices element_indices(const Element &element, std::index_sequence<I...>) {
+    return Indices{{std::get<I>(element)...}};
+}
+
+} // namespace detail
+
+/// Class of the lazy element-wise operation with matrices, scalars or other expressions
+///
+/// The expression is evaluated when it is assigned to otus::Matrix: each element stored
+/// in any matrix of the expression is computed once with one lookup in each other matrix,
+/// all other elements are equal to the result of the operation with default values.
+template <typename Operation, typename Lhs, typename Rhs>
+class Expression {
+    static_assert(std::is_same<typename Lhs::value_type, typename Rhs::value_type>::value,
+                  "Operands of the expression must have the same type of values");
+    static_assert(std::is_same<typename Lhs::Indices, typename Rhs::Indices>::value,
+                  "Operands of the expression must have the same dimension");
+
+    Operation operation_;
+    Lhs lhs_;
+    Rhs rhs_;
+
+    // the scalar is the left operand only if the right one has a matrix
+    template <typename Result>
+    typename Result::allocator_type allocator(std::true_type /*scalar lhs*/) const {
+        return rhs_.template allocator<Result>();
+    }
+    template <typename Result>
+    typename Result::allocator_type allocator(std::false_type) const {
+        return lhs_.template allocator<Result>();
+    }
+
+  public:
+    using value_type = typename Lhs::value_type;
+    using Indices = typename Lhs::Indices;
+
+    Expression(Operation operation, const Lhs &lhs, const Rhs &rhs)
+        : operation_(operation), lhs_(lhs), rhs_(rhs) {}
+
+    value_type value(const Indices &indices, ptrdiff_t &position, const value_type &known) const {
+        // leaves are counted from left to right
+        const value_type lhs = lhs_.value(indices, position, known);
+        return operation_(lhs, rhs_.value(indices, position, known));
+    }
+
+    /// Get value of elements which are not stored in any matrix of the expression
+    value_type default_value() const {
+        return operation_(lhs_.default_value(), rhs_.default_value());
+    }
+
+    bool contains(const Indices &indices, size_t &count) const {
+        return lhs_.contains(indices, count) || rhs_.contains(indices, count);
+    }
+
+    template <typename Function>
+    void for_each_leaf(Function &&function) const {
+        lhs_.for_each_leaf(function);
+        rhs_.for_each_leaf(function);
+    }
+
+    /// Get allocator of the result from the first matrix of the expression
+    template <typename Result>
+    typename Result::allocator_type allocator() const {
+        return allocator<Result>(std::is_same<Lhs, detail::ScalarLeaf<value_type, Indices>>{});
+    }
+
+    /// Get upper bound of count of elements in the result
+    size_t max_size() const noexcept { return lhs_.max_size() + rhs_.max_size(); }
+
+    /// Evaluate the expression into new matrix, it allocates elements by the allocator of
+    /// the first matrix of the expression if the allocator is convertible
+    /// @throw std::domain_error if the value of not stored elements differs from
+    ///        DefaultValue of the result, so the result can not be sparse matrix
+    template <typename Result>
+    Result evaluate() const {
+        return evaluate<Result>(allocator<Result>());
+    }
+
+    /// Evaluate the expression into new matrix which allocates elements by the allocator
+    template <typename Result>
+    Result evaluate(const typename Result::allocator_type &allocator) const {
+        if (default_value() != Result::default_value()) {
+            throw std::domain_error("Result of the expression with default values is not equal "
+                                    "to DefaultValue of the matrix");
+        }
+
+        constexpr size_t N = std::tuple_size<Indices>::value;
+        Result result(allocator);
+        result.reserve(max_size());
+        size_t leaf = 0;
+        for_each_leaf([this, &result, &leaf](const auto &matrix) {
+            const size_t number = leaf++;
+            for (const auto element : matrix) {
+                const auto indices =
+                    detail::element_indices<Indices>(element, std::make_index_sequence<N>{});
+                // elements of previous leaves are already computed
+                size_t count = number;
+                if (contains(indices, count)) {
+                    continue;
+                }
+                auto position = static_cast<ptrdiff_t>(number);
+                const value_type value = this->value(indices, position, std::get<N>(element));
+                if (value != Result::default_value()) {
+                    result.at(indices) = value;
+                }
+            }
+        });
+        return result;
+    }
+};
+
+template <typename Lhs, typename Rhs, typename = detail::enable_if_operands<Lhs, Rhs>>
+auto operator+(const Lhs &lhs, const Rhs &rhs) {
+    return detail::make_expression(std::plus<>{}, lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = detail::enable_if_operands<Lhs, Rhs>>
+auto operator-(const Lhs &lhs, const Rhs &rhs) {
+    return detail::make_expression(std::minus<>{}, lhs, rhs);
+}
+
+template <typename Operand, typename = std::enable_if_t<detail::is_matrix_operand<Operand>::value>>
+auto operator-(const Operand &operand) {
+    return detail::make_expression(std::minus<>{}, 0, operand);
+}
+
+/// Multiply the matrix by the scalar, use otus::hadamard() for element-wise product of matrices
+template <typename Lhs, typename Rhs, typename = detail::enable_if_operands<Lhs, Rhs>,
+          typename = std::enable_if_t<std::is_arithmetic<Lhs>::value ||
+                                      std::is_arithmetic<Rhs>::value>>
+auto operator*(const Lhs &lhs, const Rhs &rhs) {
+    return detail::make_expression(std::multiplies<>{}, lhs, rhs);
+}
+
+/// Divide the matrix by the scalar
+template <typename Lhs, typename Rhs, typename = detail::enable_if_operands<Lhs, Rhs>,
+          typename = std::enable_if_t<std::is_arithmetic<Rhs>::value>>
+auto operator/(const Lhs &lhs, const Rhs &rhs) {
+    return detail::make_expression(std::divides<>{}, lhs, rhs);
+}
+
+/// Element-wise (Hadamard) product of matrices
+template <typename Lhs, typename Rhs,
+          typename = std::enable_if_t<detail::is_matrix_operand<Lhs>::value &&
+                                      detail::is_matrix_operand<Rhs>::value>>
+auto hadamard(const Lhs &lhs, const Rhs &rhs) {
+    return detail::make_expression(std::multiplies<>{}, lhs, rhs);
+}
+
+} // namespace otus
+
+#endif // OTUS_EXPRESSION_HPP
@@ -0,0 +1,102 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    fingerprint.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: Order-independent fingerprints of elements of the matrix.
+//
+
+#ifndef OTUS_FINGERPRINT_HPP
+#define OTUS_FINGERPRINT_HPP
+
+#include <otus/policies.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace otus {
+
+namespace detail {
+
+/// Fingerprint of one element. Indices are hashed instead of keys, so matrices with
+/// other key and storage policies get the same fingerprints of the same elements.
+template <typename T, size_t Dimension>
+uint64_t element_fingerprint(const std::array<size_t, Dimension> &indices,
+                             const T &value) noexcept {
+    uint64_t hash = avalanche(static_cast<uint64_t>(std::hash<T>()(value)));
+    for (const size_t index : indices) {
+        hash = avalanche(hash + 0x9e3779b97f4a7c15ull + static_cast<uint64_t>(index));
+    }
+    return hash;
+}
+
+} // namespace detail
+
+/// Do not track the fingerprint: Matrix::fingerprint() walks over all elements
+struct NoFingerprint {
+    using option_category = detail::fingerprint_option;
+
+    struct digest {
+        static constexpr bool tracked = false;
+
+        template <typename Indices, typename T>
+        void add(const Indices &, const T &) noexcept {}
+        template <typename Indices, typename T>
+        void remove(const Indices &, const T &) noexcept {}
+        template <typename Indices, typename T>
+        void replace(const Indices &, const T &, const T &) noexcept {}
+        void clear() noexcept {}
+        uint64_t value() const noexcept { return 0; }
+
+        friend bool operator==(const digest &, const digest &) noexcept { return true; }
+    };
+};
+
+/// Keep the fingerprint of elements up to date by every change of the matrix
+///
+/// The fingerprint is the sum of fingerprints of (indices, value) of elements modulo
+/// 2^64, so it does not depend on the order of elements and each insertion, update or
+/// removal changes it in O(1). Matrices with different fingerprints are not equal, so
+/// operator== of unequal matrices usually returns without the walk over elements.
+/// Each change costs hashing of the element, values must be hashable by std::hash.
+struct TrackFingerprint {
+    using option_category = detail::fingerprint_option;
+
+    class digest {
+        uint64_t sum_{0};
+
+      public:
+        static constexpr bool tracked = true;
+
+        template <typename Indices, typename T>
+        void add(const Indices &indices, const T &value) noexcept {
+            sum_ += detail::element_fingerprint(indices, value);
+        }
+        template <typename Indices, typename T>
+        void remove(const Indices &indices, const T &value) noexcept {
+            sum_ -= detail::element_fingerprint(indices, value);
+        }
+        template <typename Indices, typename T>
+        void replace(const Indices &indices, const T &old_value, const T &new_value) noexcept {
+            remove(indices, old_value);
+            add(indices, new_value);
+        }
+        void clear() noexcept { sum_ = 0; }
+        uint64_t value() const noexcept { return sum_; }
+
+        friend bool operator==(const digest &lhs, const digest &rhs) noexcept {
+            return lhs.sum_ == rhs.sum_;
+        }
+    };
+};
+
+} // namespace otus
+
+#endif // OTUS_FINGERPRINT_HPP
@@ -0,0 +1,657 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    flat_hash_map.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: The open addressing hash map for storage of the sparse matrix.
+//
+
+#ifndef OTUS_FLAT_HASH_MAP_HPP
+#define OTUS_FLAT_HASH_MAP_HPP
+
+#include <otus/prefetch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace otus {
+
+/// Hash map with open addressing (Robin Hood hashing with backward shift deletion)
+///
+/// Keys and values are stored together in one contiguous array of slots. The probe
+/// sequence never wraps around: the array has `max_lookups` extra slots at the end and
+/// the table grows when some element would be placed further than `max_lookups` from
+/// its desired slot. Because erase shifts the following elements back instead of
+/// leaving tombstones, erasing through an iterator during forward traversal never
+/// skips or repeats elements.
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<std::pair<Key, Value>>>
+class FlatHashMap {
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+
+  private:
+    /// Slot of the table: distance from the desired slot and storage for the element
+    struct Slot {
+        int8_t distance; // -1 for empty slot, 0 for the sentinel at the end of the table
+        typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage;
+
+        bool empty() const noexcept { return distance < 0; }
+        value_type &value() noexcept { return *reinterpret_cast<value_type *>(&storage); }
+        const value_type &value() const noexcept {
+            return *reinterpret_cast<const value_type *>(&storage);
+        }
+    };
+
+    template <typename ValueType>
+    class SlotIterator;
+
+    using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+    using SlotAllocatorTraits = std::allocator_traits<SlotAllocator>;
+
+    static constexpr int8_t empty_distance = -1;
+    static constexpr int8_t min_lookups = 4;
+    static constexpr size_type min_bucket_count = 4;
+
+    Slot *slots_;
+    size_type num_slots_;    // count of slots before the sentinel
+    size_type bucket_count_; // count of desired slots (power of two)
+    size_type max_size_;     // count of elements before the table grows
+    int shift_;              // shift for Fibonacci hashing
+    int8_t max_lookups_;
+    size_type size_{0};
+    float max_load_factor_{0.875f};
+
+    hasher hasher_;
+    key_equal equal_;
+    SlotAllocator allocator_;
+
+  public:
+    using iterator = SlotIterator<value_type>;
+    using const_iterator = SlotIterator<const value_type>;
+
+    FlatHashMap() noexcept { reset_to_empty_table(); }
+
+    explicit FlatHashMap(const allocator_type &allocator) noexcept : allocator_(allocator) {
+        reset_to_empty_table();
+    }
+
+    explicit FlatHashMap(size_type bucket_count, const hasher &hash = hasher(),
+                         const key_equal &equal = key_equal(),
+                         const allocator_type &allocator = allocator_type())
+        : hasher_(hash), equal_(equal), allocator_(allocator) {
+        reset_to_empty_table();
+        rehash(bucket_count);
+    }
+
+    FlatHashMap(const FlatHashMap &other)
+        : max_load_factor_(other.max_load_factor_), hasher_(other.hasher_),
+          equal_(other.equal_),
+          allocator_(SlotAllocatorTraits::select_on_container_copy_construction(
+              other.allocator_)) {
+        reset_to_empty_table();
+        copy_slots(other);
+    }
+
+    FlatHashMap(const FlatHashMap &other, const allocator_type &allocator)
+        : max_load_factor_(other.max_load_factor_), hasher_(other.hasher_),
+          equal_(other.equal_), allocator_(allocator) {
+        reset_to_empty_table();
+        copy_slots(other);
+    }
+
+    FlatHashMap(FlatHashMap &&other) noexcept
+        : max_load_factor_(other.max_load_factor_), hasher_(std::move(other.hasher_)),
+          equal_(std::move(other.equal_)), allocator_(std::move(other.allocator_)) {
+        reset_to_empty_table();
+        steal_slots(other);
+    }
+
+    /// Elements are moved one by one if the allocator differs from the allocator of other
+    FlatHashMap(FlatHashMap &&other, const allocator_type &allocator)
+        : max_load_factor_(other.max_load_factor_), hasher_(other.hasher_),
+          equal_(other.equal_), allocator_(allocator) {
+        reset_to_empty_table();
+        move_slots(other);
+    }
+
+    ~FlatHashMap() {
+        destroy_values();
+        deallocate_slots();
+    }
+
+    FlatHashMap &operator=(const FlatHashMap &other) {
+        if (this != &other) {
+            // the copy is made by the allocator which this map gets after assignment
+            FlatHashMap copy(other, propagate_on_copy_assignment::value ? other.allocator_
+                                                                        : allocator_);
+            swap_table(copy);
+            swap_allocator(copy, propagate_on_copy_assignment{});
+        }
+        return *this;
+    }
+
+    FlatHashMap &operator=(FlatHashMap &&other) noexcept(
+        SlotAllocatorTraits::propagate_on_container_move_assignment::value) {
+        if (this != &other) {
+            clear();
+            deallocate_slots();
+            hasher_ = std::move(other.hasher_);
+            equal_ = std::move(other.equal_);
+            max_load_factor_ = other.max_load_factor_;
+            assign_allocator(std::move(other.allocator_), propagate_on_move_assignment{});
+            move_slots(other);
+        }
+        return *this;
+    }
+
+    /// Allocators are swapped if they propagate on swap, otherwise they must be equal
+    void swap(FlatHashMap &other) noexcept {
+        swap_table(other);
+        swap_allocator(other, typename SlotAllocatorTraits::propagate_on_container_swap{});
+    }
+
+    iterator begin() noexcept { return iterator(first_occupied()); }
+    const_iterator begin() const noexcept { return const_iterator(first_occupied()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept { return iterator(slots_ + num_slots_); }
+    const_iterator end() const noexcept { return const_iterator(slots_ + num_slots_); }
+    const_iterator cend() const noexcept { return end(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    iterator find(const key_type &key) noexcept { return iterator(find_slot(key)); }
+    const_iterator find(const key_type &key) const noexcept {
+        return const_iterator(find_slot(key));
+    }
+    /// Load the desired slot of the key ahead of the following lookup of the key
+    void prefetch(const key_type &key) const { detail::prefetch(slots_ + index_for(hasher_(key))); }
+
+    size_type count(const key_type &key) const noexcept { return find(key) != end() ? 1 : 0; }
+
+    /// Insert a new element constructed from the arguments if the key does not exist
+    /// @return Iterator to the element with the key and true if insertion took place
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type &key, Args &&... args) {
+        Slot *slot = slots_ + index_for(hasher_(key));
+        int8_t distance = 0;
+        for (; slot->distance >= distance; ++slot, ++distance) {
+            if (equal_(slot->value().first, key)) {
+                return {iterator(slot), false};
+            }
+        }
+        return insert_new(distance, slot,
+                          value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                                     std::forward_as_tuple(std::forward<Args>(args)...)));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args &&... args) {
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    std::pair<iterator, bool> insert(value_type &&value) {
+        Slot *slot = slots_ + index_for(hasher_(value.first));
+        int8_t distance = 0;
+        for (; slot->distance >= distance; ++slot, ++distance) {
+            if (equal_(slot->value().first, value.first)) {
+                return {iterator(slot), false};
+            }
+        }
+        return insert_new(distance, slot, std::move(value));
+    }
+
+    std::pair<iterator, bool> insert(const value_type &value) { return insert(value_type(value)); }
+
+    mapped_type &operator[](const key_type &key) { return try_emplace(key).first->second; }
+
+    /// Remove the element and shift the following elements of the cluster back
+    /// @return Iterator to the element following the removed one
+    iterator erase(const_iterator position) noexcept {
+        Slot *current = position.slot_;
+        destroy_value(current);
+        for (Slot *next = current + 1; next->distance > 0; current = next, ++next) {
+            construct_value(current, std::move(next->value()));
+            current->distance = static_cast<int8_t>(next->distance - 1);
+            destroy_value(next);
+        }
+        --size_;
+
+        Slot *slot = position.slot_;
+        while (slot->empty()) {
+            ++slot;
+        }
+        return iterator(slot);
+    }
+
+    iterator erase(iterator position) noexcept { return erase(const_iterator(position)); }
+
+    size_type erase(const key_type &key) noexcept {
+        Slot *slot = find_slot(key);
+        if (slot == slots_ + num_slots_) {
+            return 0;
+        }
+        erase(const_iterator(slot));
+        return 1;
+    }
+
+    void clear() noexcept {
+        if (size_ == 0) {
+            return;
+        }
+        for (Slot *slot = slots_, *last = slots_ + num_slots_; slot != last; ++slot) {
+            if (!slot->empty()) {
+                destroy_value(slot);
+            }
+        }
+        size_ = 0;
+    }
+
+    size_type bucket_count() const noexcept { return bucket_count_; }
+
+    /// Get count of slots of the table including overflow slots at the end
+    size_type slot_count() const noexcept { return num_slots_; }
+
+    /// Get bytes of memory held by the table of slots
+    size_type allocated_bytes() const noexcept {
+        return slots_ != empty_table() ? (num_slots_ + 1) * sizeof(Slot) : 0;
+    }
+
+    /// Call `function(distance, element)` for each element with its distance from the
+    /// desired slot, so lookup of the element probes distance + 1 slots
+    template <typename Function>
+    void for_each_distance(Function &&function) const {
+        for (const Slot *slot = slots_, *last = slots_ + num_slots_; slot != last; ++slot) {
+            if (!slot->empty()) {
+                function(static_cast<size_type>(slot->distance), slot->value());
+            }
+        }
+    }
+
+    /// Call `function(element)` for elements in slots [first, last), so threads may
+    /// visit disjoint ranges of slots of the same table
+    template <typename Function>
+    void for_each_in_slots(size_type first, size_type last, Function &&function) const {
+        const Slot *end = slots_ + std::min(last, num_slots_);
+        for (const Slot *slot = slots_ + std::min(first, num_slots_); slot != end; ++slot) {
+            if (!slot->empty()) {
+                function(slot->value());
+            }
+        }
+    }
+    float load_factor() const noexcept {
+        return bucket_count_ != 0 ? static_cast<float>(size_) / bucket_count_ : 0.0f;
+    }
+    float max_load_factor() const noexcept { return max_load_factor_; }
+    void max_load_factor(float factor) {
+        max_load_factor_ = std::min(std::max(factor, 0.1f), 1.0f);
+        rehash(0);
+    }
+
+    /// Set count of buckets to enough for `count` elements without exceed max load factor
+    void rehash(size_type count) {
+        count = std::max(count, static_cast<size_type>(
+                                    std::ceil(static_cast<double>(size_) / max_load_factor_)));
+        if (count == 0) {
+            return;
+        }
+        size_type buckets = min_bucket_count;
+        while (buckets < count) {
+            buckets *= 2;
+        }
+        if (buckets != bucket_count_) {
+            rehash_to(buckets);
+        } else {
+            max_size_ = static_cast<size_type>(static_cast<double>(buckets) * max_load_factor_);
+        }
+    }
+
+    void reserve(size_type count) {
+        rehash(static_cast<size_type>(std::ceil(static_cast<double>(count) / max_load_factor_)));
+    }
+
+    hasher hash_function() const { return hasher_; }
+    key_equal key_eq() const { return equal_; }
+    allocator_type get_allocator() const { return allocator_type(allocator_); }
+
+    friend bool operator==(const FlatHashMap &lhs, const FlatHashMap &rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (const auto &element : lhs) {
+            auto iter = rhs.find(element.first);
+            if (iter == rhs.end() || !(iter->second == element.second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend bool operator!=(const FlatHashMap &lhs, const FlatHashMap &rhs) {
+        return !(lhs == rhs);
+    }
+
+  private:
+    using propagate_on_copy_assignment =
+        typename SlotAllocatorTraits::propagate_on_container_copy_assignment;
+    using propagate_on_move_assignment =
+        typename SlotAllocatorTraits::propagate_on_container_move_assignment;
+
+    void assign_allocator(SlotAllocator &&allocator, std::true_type) noexcept {
+        allocator_ = std::move(allocator);
+    }
+    void assign_allocator(SlotAllocator &&, std::false_type) noexcept {}
+
+    void swap_allocator(FlatHashMap &other, std::true_type) noexcept {
+        using std::swap;
+        swap(allocator_, other.allocator_);
+    }
+    void swap_allocator(FlatHashMap &, std::false_type) noexcept {}
+
+    void swap_table(FlatHashMap &other) noexcept {
+        using std::swap;
+        swap(slots_, other.slots_);
+        swap(num_slots_, other.num_slots_);
+        swap(bucket_count_, other.bucket_count_);
+        swap(max_size_, other.max_size_);
+        swap(shift_, other.shift_);
+        swap(max_lookups_, other.max_lookups_);
+        swap(size_, other.size_);
+        swap(max_load_factor_, other.max_load_factor_);
+        swap(hasher_, other.hasher_);
+        swap(equal_, other.equal_);
+    }
+
+    /// Shared table for all empty maps: two empty slots and the sentinel
+    static Slot *empty_table() noexcept {
+        static Slot table[3] = {{empty_distance, {}}, {empty_distance, {}}, {0, {}}};
+        return table;
+    }
+
+    void reset_to_empty_table() noexcept {
+        slots_ = empty_table();
+        num_slots_ = 2;
+        bucket_count_ = 0;
+        max_size_ = 0;
+        shift_ = 63;
+        max_lookups_ = 0;
+        size_ = 0;
+    }
+
+    void deallocate_slots() noexcept {
+        if (slots_ != empty_table()) {
+            SlotAllocatorTraits::deallocate(allocator_, slots_, num_slots_ + 1);
+        }
+        reset_to_empty_table();
+    }
+
+    void steal_slots(FlatHashMap &other) noexcept {
+        slots_ = other.slots_;
+        num_slots_ = other.num_slots_;
+        bucket_count_ = other.bucket_count_;
+        max_size_ = other.max_size_;
+        shift_ = other.shift_;
+        max_lookups_ = other.max_lookups_;
+        size_ = other.size_;
+        other.reset_to_empty_table();
+    }
+
+    /// Destroy elements without clearing the table, trivial elements need not be visited
+    void destroy_values() noexcept {
+        if (!std::is_trivially_destructible<value_type>::value) {
+            clear();
+        }
+    }
+
+    /// Take the table of other if it is allocated by the same allocator, otherwise
+    /// move elements into the own table with the same layout
+    void move_slots(FlatHashMap &other) {
+        if (allocator_ == other.allocator_) {
+            steal_slots(other);
+            return;
+        }
+        if (other.size_ != 0) {
+            allocate_slots(other.bucket_count_);
+            for (size_type i = 0; i != num_slots_; ++i) {
+                if (!other.slots_[i].empty()) {
+                    construct_value(slots_ + i, std::move(other.slots_[i].value()));
+                    slots_[i].distance = other.slots_[i].distance;
+                    ++size_;
+                }
+            }
+        }
+        other.clear();
+        other.deallocate_slots();
+    }
+
+    /// Copy the table with the same layout, so the elements need not be rehashed
+    void copy_slots(const FlatHashMap &other) {
+        if (other.size_ == 0) {
+            return;
+        }
+        allocate_slots(other.bucket_count_);
+        try {
+            for (size_type i = 0; i != num_slots_; ++i) {
+                if (!other.slots_[i].empty()) {
+                    construct_value(slots_ + i, other.slots_[i].value());
+                    slots_[i].distance = other.slots_[i].distance;
+                    ++size_;
+                }
+            }
+        } catch (...) {
+            // copy constructors do not run the destructor when they throw
+            clear();
+            deallocate_slots();
+            throw;
+        }
+    }
+
+    void allocate_slots(size_type buckets) {
+        int log2 = 0;
+        while ((size_type{1} << log2) < buckets) {
+            ++log2;
+        }
+        const auto lookups = static_cast<int8_t>(std::max<int>(min_lookups, log2));
+        const size_type num_slots = buckets + static_cast<size_type>(lookups);
+
+        Slot *slots = SlotAllocatorTraits::allocate(allocator_, num_slots + 1);
+        for (size_type i = 0; i != num_slots; ++i) {
+            slots[i].distance = empty_distance;
+        }
+        slots[num_slots].distance = 0;
+
+        slots_ = slots;
+        num_slots_ = num_slots;
+        bucket_count_ = buckets;
+        max_size_ = static_cast<size_type>(static_cast<double>(buckets) * max_load_factor_);
+        shift_ = 64 - log2;
+        max_lookups_ = lookups;
+        size_ = 0;
+    }
+
+    void rehash_to(size_type buckets) {
+        Slot *old_slots = slots_;
+        size_type old_num_slots = num_slots_;
+        bool old_allocated = slots_ != empty_table();
+
+        allocate_slots(buckets);
+        for (Slot *slot = old_slots, *last = old_slots + old_num_slots; slot != last; ++slot) {
+            if (!slot->empty()) {
+                place(std::move(slot->value()));
+                destroy_value(slot);
+            }
+        }
+        if (old_allocated) {
+            SlotAllocatorTraits::deallocate(allocator_, old_slots, old_num_slots + 1);
+        }
+    }
+
+    void grow() { rehash_to(std::max(min_bucket_count, bucket_count_ * 2)); }
+
+    /// Fibonacci hashing spreads poor hash values (like the identity) over the table
+    size_type index_for(size_t hash) const noexcept {
+        return static_cast<size_type>((static_cast<uint64_t>(hash) * 11400714819323198485ull) >>
+                                      shift_);
+    }
+
+    Slot *first_occupied() const noexcept {
+        Slot *slot = slots_;
+        while (slot->empty()) {
+            ++slot;
+        }
+        return slot;
+    }
+
+    Slot *find_slot(const key_type &key) const noexcept {
+        Slot *slot = slots_ + index_for(hasher_(key));
+        for (int8_t distance = 0; slot->distance >= distance; ++slot, ++distance) {
+            if (equal_(slot->value().first, key)) {
+                return slot;
+            }
+        }
+        return slots_ + num_slots_;
+    }
+
+    /// Insert the element with the key which is known to be absent
+    iterator place(value_type &&value) {
+        Slot *slot = slots_ + index_for(hasher_(value.first));
+        int8_t distance = 0;
+        for (; slot->distance >= distance; ++slot, ++distance) {
+        }
+        return insert_new(distance, slot, std::move(value)).first;
+    }
+
+    /// Insert the element at the end of its probe sequence and displace richer elements
+    std::pair<iterator, bool> insert_new(int8_t distance, Slot *slot, value_type &&value) {
+        if (distance >= max_lookups_ || size_ + 1 > max_size_) {
+            grow();
+            return {place(std::move(value)), true};
+        }
+        if (slot->empty()) {
+            construct_value(slot, std::move(value));
+            slot->distance = distance;
+            ++size_;
+            return {iterator(slot), true};
+        }
+
+        value_type carry(std::move(value));
+        std::swap(distance, slot->distance);
+        std::swap(carry, slot->value());
+        Slot *result = slot;
+        for (;;) {
+            ++slot;
+            ++distance;
+            if (distance == max_lookups_) {
+                key_type key = result->value().first;
+                grow();
+                place(std::move(carry));
+                return {find(key), true};
+            }
+            if (slot->empty()) {
+                construct_value(slot, std::move(carry));
+                slot->distance = distance;
+                ++size_;
+                return {iterator(result), true};
+            }
+            if (slot->distance < distance) {
+                std::swap(distance, slot->distance);
+                std::swap(carry, slot->value());
+            }
+        }
+    }
+
+    template <typename... Args>
+    static void construct_value(Slot *slot, Args &&... args) {
+        ::new (static_cast<void *>(&slot->storage)) value_type(std::forward<Args>(args)...);
+    }
+
+    static void destroy_value(Slot *slot) noexcept {
+        slot->value().~value_type();
+        slot->distance = empty_distance;
+    }
+};
+
+// ***********************************
+// * Class FlatHashMap::SlotIterator *
+// ***********************************
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+template <typename ValueType>
+class FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::SlotIterator {
+    friend class FlatHashMap;
+    Slot *slot_{nullptr};
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename FlatHashMap::value_type;
+    using difference_type = ptrdiff_t;
+    using pointer = ValueType *;
+    using reference = ValueType &;
+
+    SlotIterator() = default;
+    explicit SlotIterator(Slot *slot) : slot_(slot) {}
+
+    /// Iterator is implicitly converted to const_iterator
+    template <typename OtherType,
+              typename = std::enable_if_t<std::is_same<const OtherType, ValueType>::value &&
+                                          !std::is_same<OtherType, ValueType>::value>>
+    SlotIterator(const SlotIterator<OtherType> &other) : slot_(other.slot_) {} // NOLINT
+
+    template <typename OtherType>
+    friend class SlotIterator;
+
+    reference operator*() const { return slot_->value(); }
+    pointer operator->() const { return &slot_->value(); }
+
+    SlotIterator &operator++() {
+        do {
+            ++slot_;
+        } while (slot_->empty());
+        return *this;
+    }
+    SlotIterator operator++(int) {
+        SlotIterator retval = *this;
+        ++(*this);
+        return retval;
+    }
+    template <typename OtherType>
+    bool operator==(const SlotIterator<OtherType> &other) const {
+        return slot_ == other.slot_;
+    }
+    template <typename OtherType>
+    bool operator!=(const SlotIterator<OtherType> &other) const {
+        return !(*this == other);
+    }
+};
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+constexpr int8_t FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::empty_distance;
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+constexpr int8_t FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::min_lookups;
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+constexpr size_t FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::min_bucket_count;
+
+} // namespace otus
+
+#endif // OTUS_FLAT_HASH_MAP_HPP
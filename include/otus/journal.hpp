@@ -0,0 +1,236 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    journal.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: The journal of changes of the sparse matrix for shipping deltas.
+//
+
+#ifndef OTUS_JOURNAL_HPP
+#define OTUS_JOURNAL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace otus {
+
+/// Kind of the change of the element
+enum class ChangeKind : uint8_t {
+    insert, ///< new element is stored
+    update, ///< value of stored element is replaced
+    erase,  ///< element is removed (set to the default value)
+    clear   ///< all elements are removed, indices and value are not used
+};
+
+namespace detail {
+
+// Layout of the serialized journal (version 1), numbers are in the byte order of the writer:
+//   - header (detail::JournalHeader);
+//   - `count` records: kind (1 byte), `dimension` uint64_t coordinates, value (sizeof(T)).
+
+struct JournalHeader {
+    static constexpr uint32_t current_version = 1;
+    static constexpr uint32_t byte_order_mark = 0x01020304;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t dimension;
+    uint64_t value_size;
+    uint64_t count;
+};
+
+inline const char *journal_magic() noexcept { return "OTUSJRN"; }
+
+} // namespace detail
+
+/// Class of the append-only journal of changes of the matrix
+///
+/// The journal is attached to otus::Matrix by Matrix::attach() and records every
+/// insertion, update and removal of elements in order. Recorded changes are taken by
+/// drain(), shipped by serialize()/deserialize() and applied to other matrix by replay(),
+/// so replicas receive deltas instead of full copies.
+///
+/// Records are kept unpacked as Change structures, so iteration gives references to them
+/// and values need not be trivially copyable until the journal is serialized. The cost is
+/// memory: size_t indices and padding take more than the packed serialized record, e.g.
+/// 32 bytes instead of 21 for two dimension matrix of int. record_clear() stores the value
+/// initialized T, which is always default constructible for values of otus::Matrix.
+template <typename T, size_t Dimension>
+class ChangeJournal {
+  public:
+    using Indices = std::array<size_t, Dimension>;
+
+    /// Record of the journal
+    struct Change {
+        ChangeKind kind;
+        Indices indices;
+        T value;
+    };
+
+    using const_iterator = typename std::vector<Change>::const_iterator;
+
+  private:
+    std::vector<Change> changes_;
+
+    static constexpr size_t record_size = 1 + Dimension * sizeof(uint64_t) + sizeof(T);
+
+    [[noreturn]] static void invalid(const char *reason) {
+        throw std::runtime_error("Invalid journal of otus::Matrix: " + std::string(reason));
+    }
+
+  public:
+    ChangeJournal() = default;
+
+    /// Append the change
+    void record(ChangeKind kind, const Indices &indices, const T &value) {
+        changes_.push_back(Change{kind, indices, value});
+    }
+
+    /// Append removal of all elements
+    void record_clear() { changes_.push_back(Change{ChangeKind::clear, Indices{}, T{}}); }
+
+    /// Allocate place for count more changes, so appending them does not allocate.
+    /// The place grows geometrically, so reserving before each change is amortized O(1).
+    void reserve(size_t count) {
+        if (changes_.capacity() - changes_.size() < count) {
+            changes_.reserve(std::max(changes_.size() + count, changes_.capacity() * 2));
+        }
+    }
+
+    /// Take recorded changes, the journal stays empty
+    ChangeJournal drain() {
+        ChangeJournal drained;
+        drained.changes_.swap(changes_);
+        return drained;
+    }
+
+    /// Apply changes to the matrix in the recorded order
+    template <typename MatrixType>
+    void replay(MatrixType &matrix) const {
+        static_assert(std::is_same<typename MatrixType::Indices, Indices>::value,
+                      "The matrix must have the same dimension as the journal");
+        for (const Change &change : changes_) {
+            switch (change.kind) {
+            case ChangeKind::insert:
+            case ChangeKind::update:
+                matrix.at(change.indices) = change.value;
+                break;
+            case ChangeKind::erase:
+                matrix.erase(change.indices);
+                break;
+            case ChangeKind::clear:
+                matrix.clear();
+                break;
+            }
+        }
+    }
+
+    /// Write changes in the binary format read by deserialize()
+    /// @throw std::runtime_error if the stream fails
+    void serialize(std::ostream &stream) const {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Values of the serialized journal must be trivially copyable");
+        detail::JournalHeader header{};
+        std::memcpy(header.magic, detail::journal_magic(), sizeof(header.magic));
+        header.version = detail::JournalHeader::current_version;
+        header.byte_order = detail::JournalHeader::byte_order_mark;
+        header.dimension = Dimension;
+        header.value_size = sizeof(T);
+        header.count = changes_.size();
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        std::vector<char> buffer(record_size * changes_.size());
+        char *record = buffer.data();
+        for (const Change &change : changes_) {
+            *record++ = static_cast<char>(change.kind);
+            for (const size_t idx : change.indices) {
+                const auto coordinate = static_cast<uint64_t>(idx);
+                std::memcpy(record, &coordinate, sizeof(coordinate));
+                record += sizeof(coordinate);
+            }
+            std::memcpy(record, &change.value, sizeof(T));
+            record += sizeof(T);
+        }
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!stream) {
+            throw std::runtime_error("Can not write the journal of otus::Matrix");
+        }
+    }
+
+    /// Read changes written by serialize()
+    /// @throw std::runtime_error if the stream is truncated or has other format,
+    ///        dimension or type of values
+    static ChangeJournal deserialize(std::istream &stream) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Values of the serialized journal must be trivially copyable");
+        detail::JournalHeader header{};
+        if (!stream.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+            invalid("too short");
+        }
+        if (std::memcmp(header.magic, detail::journal_magic(), sizeof(header.magic)) != 0 ||
+            header.byte_order != detail::JournalHeader::byte_order_mark) {
+            invalid("not a journal");
+        }
+        if (header.version != detail::JournalHeader::current_version) {
+            invalid("unsupported version");
+        }
+        if (header.dimension != Dimension || header.value_size != sizeof(T)) {
+            invalid("other dimension or type");
+        }
+
+        ChangeJournal journal;
+        std::array<char, record_size> record;
+        for (uint64_t i = 0; i < header.count; ++i) {
+            if (!stream.read(record.data(), record_size)) {
+                invalid("truncated");
+            }
+            Change change{};
+            const char *field = record.data();
+            const auto kind = static_cast<uint8_t>(*field++);
+            if (kind > static_cast<uint8_t>(ChangeKind::clear)) {
+                invalid("unknown change");
+            }
+            change.kind = static_cast<ChangeKind>(kind);
+            for (size_t &idx : change.indices) {
+                uint64_t coordinate = 0;
+                std::memcpy(&coordinate, field, sizeof(coordinate));
+                idx = static_cast<size_t>(coordinate);
+                field += sizeof(coordinate);
+            }
+            std::memcpy(&change.value, field, sizeof(T));
+            journal.changes_.push_back(change);
+        }
+        return journal;
+    }
+
+    /// Remove recorded changes
+    void clear() noexcept { changes_.clear(); }
+
+    /// Get count of recorded changes
+    size_t size() const noexcept { return changes_.size(); }
+    bool empty() const noexcept { return changes_.empty(); }
+
+    /// Iterate over recorded changes in order
+    const_iterator begin() const noexcept { return changes_.cbegin(); }
+    const_iterator end() const noexcept { return changes_.cend(); }
+};
+
+} // namespace otus
+
+#endif // OTUS_JOURNAL_HPP
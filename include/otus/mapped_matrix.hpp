@@ -0,0 +1,437 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    mapped_matrix.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: Binary file of the sparse matrix and the read-only view of the mapped file.
+//
+
+#ifndef OTUS_MAPPED_MATRIX_HPP
+#define OTUS_MAPPED_MATRIX_HPP
+
+#include <otus/matrix.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define OTUS_MATRIX_HAS_MMAP 1
+#endif
+
+namespace otus {
+
+// Layout of the file (version 1), all numbers are in the byte order of the writer:
+//   - header (detail::FileHeader);
+//   - DefaultValue (sizeof(T) bytes);
+//   - coordinates of elements: `count` records of `dimension` uint64_t, records are sorted
+//     in lexicographic order (at coordinates_offset, aligned to 8 bytes);
+//   - values of elements in the order of records (at values_offset, aligned to alignof(T)).
+
+namespace detail {
+
+struct FileHeader {
+    static constexpr uint32_t current_version = 1;
+    static constexpr uint32_t byte_order_mark = 0x01020304;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t dimension;
+    uint64_t value_size;
+    uint64_t count;
+    uint64_t coordinates_offset;
+    uint64_t values_offset;
+};
+
+inline const char *file_magic() noexcept { return "OTUSMTX"; }
+
+inline uint64_t align_up(uint64_t offset, uint64_t alignment) noexcept {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+/// Read-only content of the file, mapped into memory where mmap is available
+class MappedFile {
+    const char *data_{nullptr};
+    size_t size_{0};
+#if !defined(OTUS_MATRIX_HAS_MMAP)
+    std::unique_ptr<char[]> buffer_;
+#endif
+
+  public:
+    explicit MappedFile(const std::string &path) {
+#if defined(OTUS_MATRIX_HAS_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Can not open the file of otus::Matrix: " + path);
+        }
+        struct stat status {};
+        if (::fstat(fd, &status) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Can not read the file of otus::Matrix: " + path);
+        }
+        size_ = static_cast<size_t>(status.st_size);
+        if (size_ > 0) {
+            void *data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Can not map the file of otus::Matrix: " + path);
+            }
+            data_ = static_cast<const char *>(data);
+        }
+        ::close(fd); // the mapping keeps the file
+#else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            throw std::runtime_error("Can not open the file of otus::Matrix: " + path);
+        }
+        size_ = static_cast<size_t>(file.tellg());
+        buffer_.reset(new char[size_]);
+        file.seekg(0);
+        if (!file.read(buffer_.get(), static_cast<std::streamsize>(size_))) {
+            throw std::runtime_error("Can not read the file of otus::Matrix: " + path);
+        }
+        data_ = buffer_.get();
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile() {
+#if defined(OTUS_MATRIX_HAS_MMAP)
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char *>(data_), size_);
+        }
+#endif
+    }
+
+    const char *data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+};
+
+} // namespace detail
+
+/// Class of the read-only view of the matrix saved by otus::save()
+///
+/// The file is mapped into memory and lookups are binary searches over the sorted
+/// records of coordinates, so opening the file costs nothing beyond the header check
+/// and pages are read from the disk on demand.
+template <typename T, T DefaultValue, size_t Dimension = 2>
+class MappedMatrix {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Values of the mapped matrix must be trivially copyable");
+
+  public:
+    using Indices = std::array<size_t, Dimension>;
+
+    /// Iterator of all elements in lexicographic order
+    class Iterator;
+
+  private:
+    /// Using this Layout for resolve partial indices by operator[]
+    template <size_t N>
+    class Layout;
+
+    static constexpr T default_value_{DefaultValue};
+
+    std::unique_ptr<detail::MappedFile> file_;
+    size_t size_{0};
+    const uint64_t *coordinates_{nullptr};
+    const T *values_{nullptr};
+
+    uint64_t coordinate(size_t record, size_t axis) const noexcept {
+        return coordinates_[record * Dimension + axis];
+    }
+
+    /// Find the first record in [first, last) with coordinate on the axis not less than idx
+    size_t lower_bound(size_t first, size_t last, size_t axis, uint64_t idx) const noexcept {
+        while (first < last) {
+            const size_t middle = first + (last - first) / 2;
+            if (coordinate(middle, axis) < idx) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+        return first;
+    }
+
+    /// Find the first record in [first, last) with coordinate on the axis greater than idx
+    size_t upper_bound(size_t first, size_t last, size_t axis, uint64_t idx) const noexcept {
+        while (first < last) {
+            const size_t middle = first + (last - first) / 2;
+            if (coordinate(middle, axis) <= idx) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+        return first;
+    }
+
+    [[noreturn]] static void invalid(const std::string &path, const char *reason) {
+        throw std::runtime_error("Invalid file of otus::Matrix (" + std::string(reason) +
+                                 "): " + path);
+    }
+
+  public:
+    /// Map the file saved by otus::save()
+    /// @throw std::runtime_error if the file can not be read or has other format,
+    ///        dimension, type or default value
+    explicit MappedMatrix(const std::string &path)
+        : file_(std::make_unique<detail::MappedFile>(path)) {
+        detail::FileHeader header{};
+        if (file_->size() < sizeof(header) + sizeof(T)) {
+            invalid(path, "too short");
+        }
+        std::memcpy(&header, file_->data(), sizeof(header));
+        if (std::memcmp(header.magic, detail::file_magic(), sizeof(header.magic)) != 0 ||
+            header.byte_order != detail::FileHeader::byte_order_mark) {
+            invalid(path, "not a matrix");
+        }
+        if (header.version != detail::FileHeader::current_version) {
+            invalid(path, "unsupported version");
+        }
+        if (header.dimension != Dimension || header.value_size != sizeof(T)) {
+            invalid(path, "other dimension or type");
+        }
+        T default_value;
+        std::memcpy(&default_value, file_->data() + sizeof(header), sizeof(T));
+        if (default_value != DefaultValue) {
+            invalid(path, "other default value");
+        }
+        // offsets are compared with the size before sizes of arrays are, so offsets of
+        // the corrupt file near the end of uint64_t do not wrap around
+        const uint64_t file_size = file_->size();
+        if (header.coordinates_offset < sizeof(header) + sizeof(T) ||
+            header.coordinates_offset > header.values_offset ||
+            header.values_offset > file_size ||
+            header.coordinates_offset % alignof(uint64_t) != 0 ||
+            header.values_offset % alignof(T) != 0 ||
+            header.count > (header.values_offset - header.coordinates_offset) /
+                               (Dimension * sizeof(uint64_t)) ||
+            header.count > (file_size - header.values_offset) / sizeof(T)) {
+            invalid(path, "truncated");
+        }
+
+        size_ = static_cast<size_t>(header.count);
+        coordinates_ =
+            reinterpret_cast<const uint64_t *>(file_->data() + header.coordinates_offset);
+        values_ = reinterpret_cast<const T *>(file_->data() + header.values_offset);
+    }
+
+    /// Get slice of the matrix by the first index
+    decltype(auto) operator[](size_t idx) const { return Layout<Dimension>(*this, 0, size_)[idx]; }
+
+    /// Get value of the element by binary search over all records
+    const T &get(const Indices &indices) const noexcept {
+        size_t first = 0, last = size_;
+        while (first < last) {
+            const size_t middle = first + (last - first) / 2;
+            const uint64_t *record = coordinates_ + middle * Dimension;
+            if (std::lexicographical_compare(record, record + Dimension, indices.begin(),
+                                             indices.end())) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+        if (first == size_ || !std::equal(indices.begin(), indices.end(),
+                                          coordinates_ + first * Dimension)) {
+            return default_value_;
+        }
+        return values_[first];
+    }
+
+    /// Get count of elements
+    size_t size() const noexcept { return size_; }
+
+    /// Return an iterator to the beginning
+    /// @return Iterator of tuples (index 1, index 2, ..., value)
+    Iterator begin() const { return Iterator(this, 0); }
+
+    /// Return an iterator to the end
+    Iterator end() const { return Iterator(this, size_); }
+};
+
+// ******************************
+// * Class MappedMatrix::Layout *
+// ******************************
+template <typename T, T DefaultValue, size_t Dimension>
+template <size_t N>
+class MappedMatrix<T, DefaultValue, Dimension>::Layout {
+    static constexpr size_t axis = Dimension - N;
+
+    const MappedMatrix &matrix_;
+    size_t first_; // records with the prefix of indices set by previous Layouts
+    size_t last_;
+
+    Layout<N - 1> next(size_t idx, std::false_type /*last axis*/) const noexcept {
+        const size_t first = matrix_.lower_bound(first_, last_, axis, idx);
+        return Layout<N - 1>(matrix_, first, matrix_.upper_bound(first, last_, axis, idx));
+    }
+
+    const T &next(size_t idx, std::true_type /*last axis*/) const noexcept {
+        const size_t record = matrix_.lower_bound(first_, last_, axis, idx);
+        if (record == last_ || matrix_.coordinate(record, axis) != idx) {
+            return default_value_;
+        }
+        return matrix_.values_[record];
+    }
+
+  public:
+    Layout(const MappedMatrix &matrix, size_t first, size_t last)
+        : matrix_(matrix), first_(first), last_(last) {}
+
+    decltype(auto) operator[](size_t idx) const {
+        return next(idx, std::integral_constant<bool, N == 1>{});
+    }
+};
+
+// ********************************
+// * Class MappedMatrix::Iterator *
+// ********************************
+template <typename T, T DefaultValue, size_t Dimension>
+class MappedMatrix<T, DefaultValue, Dimension>::Iterator {
+    const MappedMatrix *matrix_;
+    size_t record_;
+
+  public:
+    using value_type =
+        decltype(std::tuple_cat(std::declval<typename detail::generate_tuple_type<
+                                    size_t, Dimension>::type>(),
+                                std::tie(default_value_)));
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+    using iterator_category = std::input_iterator_tag;
+
+    Iterator(const MappedMatrix *matrix, size_t record) : matrix_(matrix), record_(record) {}
+
+    Iterator &operator++() {
+        ++record_;
+        return *this;
+    }
+    Iterator operator++(int) {
+        Iterator retval = *this;
+        ++(*this);
+        return retval;
+    }
+    bool operator==(const Iterator &other) const { return record_ == other.record_; }
+    bool operator!=(const Iterator &other) const { return !(*this == other); }
+
+    value_type operator*() const { return get_value(std::make_index_sequence<Dimension>{}); }
+
+  private:
+    template <size_t... I>
+    value_type get_value(std::index_sequence<I...>) const {
+        return value_type(static_cast<size_t>(matrix_->coordinate(record_, I))...,
+                          matrix_->values_[record_]);
+    }
+};
+
+template <typename T, T DefaultValue, size_t Dimension>
+constexpr T MappedMatrix<T, DefaultValue, Dimension>::default_value_;
+
+template <typename T, T DefaultValue, size_t Dimension>
+template <size_t N>
+constexpr size_t MappedMatrix<T, DefaultValue, Dimension>::Layout<N>::axis;
+
+/// Save the matrix into the binary file which is read by otus::load() or otus::MappedMatrix
+/// @throw std::runtime_error if the file can not be written
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+void save(const Matrix<T, DefaultValue, Dimension, Options...> &matrix, const std::string &path) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Values of the saved matrix must be trivially copyable");
+    using Indices = typename Matrix<T, DefaultValue, Dimension, Options...>::Indices;
+
+    std::vector<std::pair<Indices, T>> elements;
+    elements.reserve(matrix.size());
+    for (const auto element : matrix) {
+        elements.emplace_back(
+            detail::element_indices<Indices>(element, std::make_index_sequence<Dimension>{}),
+            std::get<Dimension>(element));
+    }
+    std::sort(elements.begin(), elements.end(),
+              [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+
+    std::vector<uint64_t> coordinates;
+    std::vector<T> values;
+    coordinates.reserve(elements.size() * Dimension);
+    values.reserve(elements.size());
+    for (const auto &element : elements) {
+        coordinates.insert(coordinates.end(), element.first.begin(), element.first.end());
+        values.push_back(element.second);
+    }
+
+    detail::FileHeader header{};
+    std::memcpy(header.magic, detail::file_magic(), sizeof(header.magic));
+    header.version = detail::FileHeader::current_version;
+    header.byte_order = detail::FileHeader::byte_order_mark;
+    header.dimension = Dimension;
+    header.value_size = sizeof(T);
+    header.count = elements.size();
+    header.coordinates_offset = detail::align_up(sizeof(header) + sizeof(T), alignof(uint64_t));
+    header.values_offset = detail::align_up(
+        header.coordinates_offset + coordinates.size() * sizeof(uint64_t), alignof(T));
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    const auto write = [&file](const void *data, uint64_t bytes) {
+        file.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+    };
+    const auto pad_to = [&file](uint64_t offset) {
+        while (static_cast<uint64_t>(file.tellp()) < offset && file) {
+            file.put('\0');
+        }
+    };
+    const T default_value = DefaultValue;
+    write(&header, sizeof(header));
+    write(&default_value, sizeof(T));
+    pad_to(header.coordinates_offset);
+    write(coordinates.data(), coordinates.size() * sizeof(uint64_t));
+    pad_to(header.values_offset);
+    write(values.data(), values.size() * sizeof(T));
+    if (!file.flush()) {
+        throw std::runtime_error("Can not write the file of otus::Matrix: " + path);
+    }
+}
+
+/// Load the matrix saved by otus::save(), elements are allocated by the allocator
+/// @throw std::runtime_error if the file can not be read or has other format,
+///        dimension, type or default value
+template <typename MatrixType>
+MatrixType load(const std::string &path,
+                const typename MatrixType::allocator_type &allocator = {}) {
+    using Mapped = MappedMatrix<typename MatrixType::value_type, MatrixType::default_value(),
+                                std::tuple_size<typename MatrixType::Indices>::value>;
+    const Mapped mapped(path);
+    MatrixType matrix(allocator);
+    matrix.reserve(mapped.size());
+    matrix.insert_bulk(mapped.begin(), mapped.end());
+    return matrix;
+}
+
+} // namespace otus
+
+#endif // OTUS_MAPPED_MATRIX_HPP
@@ -14,140 +14,973 @@
 #ifndef OTUS_MATRIX_HPP
 #define OTUS_MATRIX_HPP
 
+#include <otus/fingerprint.hpp>
+#include <otus/journal.hpp>
+#include <otus/policies.hpp>
+#include <otus/stats.hpp>
+#include <otus/thread_pool.hpp>
+
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
 #include <tuple>
-#include <unordered_map>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace otus {
 
+/// Order of elements in the compressed matrix
+enum class StorageOrder { row_major, column_major };
+
+template <typename T, T DefaultValue, StorageOrder Order>
+class CompressedMatrix;
+
+/// The immutable two dimension matrix in compressed sparse row format
+template <typename T, T DefaultValue>
+using CsrMatrix = CompressedMatrix<T, DefaultValue, StorageOrder::row_major>;
+
+/// The immutable two dimension matrix in compressed sparse column format
+template <typename T, T DefaultValue>
+using CscMatrix = CompressedMatrix<T, DefaultValue, StorageOrder::column_major>;
+
+template <typename T, T DefaultValue, size_t Dimension>
+class CsfTensor;
+
+template <typename Operation, typename Lhs, typename Rhs>
+class Expression;
+
 /// Class of The multi-dimensional sparse matrix
-template <typename T, T DefaultValue, size_t Dimension = 2>
+///
+/// Options are policies which customize the matrix:
+///   - the storage policy (otus::UnorderedStorage by default, otus::FlatStorage,
+///     otus::TiledStorage<Extent> or otus::DenseStorage<Size>);
+///   - the key policy (otus::TupleKeys by default, otus::PackedKeys<Coordinate> or
+///     otus::Extents<N...> which also selects dense or flat storage by default);
+///   - the hint of density of elements with extents (otus::ExpectedDensity<Percent>);
+///   - the hash policy (hash of the key policy by default, otus::TupleHash,
+///     otus::PackedKeyHash or otus::MixHash);
+///   - the index policy (otus::NoIndex by default or otus::OrderedIndex);
+///   - the counters of operations (otus::NoStats by default or otus::CollectStats);
+///   - the fingerprint of elements (otus::NoFingerprint by default or
+///     otus::TrackFingerprint);
+///   - the allocator of elements (otus::StorageAllocator<std::allocator<char>> by default,
+///     otus::StorageAllocator<otus::ArenaAllocator<char>> or otus::PmrAllocator).
+template <typename T, T DefaultValue, size_t Dimension = 2, typename... Options>
 class Matrix {
-  private:
     static_assert(Dimension > 0, "The dimension of the matrix must be greater than 0");
 
-    template <typename TupleType, unsigned N, typename... Types>
-    struct generate_tuple_type {
-        using type = typename generate_tuple_type<TupleType, N - 1, TupleType, Types...>::type;
-    };
-
-    template <typename TupleType, typename... Types>
-    struct generate_tuple_type<TupleType, 0, Types...> {
-        using type = std::tuple<Types...>;
-    };
+  public:
+    /// Indices of an element in the matrix
+    using Indices = std::array<size_t, Dimension>;
+    using value_type = T;
+    /// Allocator of the option, containers rebind it to their elements
+    using allocator_type =
+        typename detail::select_option_t<detail::allocator_option,
+                                         StorageAllocator<std::allocator<char>>,
+                                         Options...>::allocator_type;
+    /// Journal of changes which may be attached to the matrix
+    using Journal = ChangeJournal<T, Dimension>;
 
+  private:
     /// Iterator used as adaptor for concatanate key and value from map
     class Iterator;
-    /// TupleHash used as Hash function for std::unordered_map
-    class TupleHash;
+    /// Iterator which allows to change values of elements
+    class MutableIterator;
+    /// Elements with mutable values, elements set to default value are removed
+    class MutableRange;
+    /// Iterator of elements in the box [lo, hi] used by slices and ranges
+    class RangeIterator;
+    /// Elements in the box [lo, hi]
+    class Range;
     /// Using these Layouts for access to other Layouts in the matrix
-    template <size_t N, typename... Types>
+    template <size_t N, typename Owner>
     class Layout;
     /// Using this Layout as Smart Object for get/set values of the matrix
-    template <typename... Types>
-    class Layout<0, Types...>;
+    template <typename Owner>
+    class Layout<0, Owner>;
+    /// View of the matrix with permuted axes, Owner is Matrix or const Matrix
+    template <typename Owner, size_t... Axes>
+    class Permuted;
+
+    /// Layouts refer to the matrix and keep copies of views, which are references
+    /// themselves, so Layouts of temporary views stay valid
+    template <typename Owner>
+    struct layout_handle {
+        using type = Owner &;
+    };
+    template <typename Owner, size_t... Axes>
+    struct layout_handle<Permuted<Owner, Axes...>> {
+        using type = Permuted<Owner, Axes...>;
+    };
+    template <typename Owner, size_t... Axes>
+    struct layout_handle<const Permuted<Owner, Axes...>> {
+        using type = const Permuted<Owner, Axes...>;
+    };
+
+    using KeyPolicy = detail::select_option_t<detail::key_option, TupleKeys, Options...>;
+    using KeyCodec = typename KeyPolicy::template codec<Dimension>;
+
+    using StoragePolicy =
+        detail::select_option_t<detail::storage_option,
+                                detail::default_storage_t<KeyPolicy, T, Options...>, Options...>;
 
-    using TupleKey = typename generate_tuple_type<size_t, Dimension>::type;
-    using Contanter = std::unordered_map<TupleKey, T, TupleHash>;
-    using NextLayout = Layout<Dimension - 1, size_t>;
+    using TupleKey = typename detail::generate_tuple_type<size_t, Dimension>::type;
+    using KeyHash =
+        detail::select_option_t<detail::hash_option, typename KeyCodec::hasher, Options...>;
+    using Key = typename KeyCodec::key_type;
+    using Contanter =
+        typename StoragePolicy::template container<Key, T, KeyHash, allocator_type>;
+
+    using IndexPolicy = detail::select_option_t<detail::index_option, NoIndex, Options...>;
+    using Index = typename IndexPolicy::template index<Dimension>;
+    using Ordered = std::integral_constant<bool, Index::ordered>;
+    /// Position of the range iterator: in the index if it is ordered or in the container
+    using Cursor = typename std::conditional_t<Index::ordered, Index, Contanter>::const_iterator;
+
+    using StatsPolicy = detail::select_option_t<detail::stats_option, NoStats, Options...>;
+    using Counters = typename StatsPolicy::counters;
+
+    using FingerprintPolicy =
+        detail::select_option_t<detail::fingerprint_option, NoFingerprint, Options...>;
+    using Digest = typename FingerprintPolicy::digest;
+    using Tracked = std::integral_constant<bool, Digest::tracked>;
+
+    /// Tuple of references to coordinates in the key (or decoded coordinates of packed
+    /// keys) and to the value, so iteration does not copy keys
+    template <typename Value, typename Sequence = std::make_index_sequence<Dimension>>
+    struct element_reference;
+    template <typename Value, size_t... I>
+    struct element_reference<Value, std::index_sequence<I...>> {
+        using type = std::tuple<decltype(KeyCodec::template get<I>(std::declval<const Key &>()))...,
+                                Value &>;
+
+        static type make(const Key &key, Value &value) {
+            return type(KeyCodec::template get<I>(key)..., value);
+        }
+    };
+
+    using NextLayout = Layout<Dimension - 1, Matrix>;
+    using ConstNextLayout = Layout<Dimension - 1, const Matrix>;
+    using Element = Layout<0, Matrix>;
+    using ConstElement = Layout<0, const Matrix>;
+
+    static constexpr T default_value_{DefaultValue};
 
     Contanter elements_;
+    Index index_;
+    mutable Counters counters_; // reads of the const matrix are counted too
+    Digest digest_;
+    Journal *journal_{nullptr};
     const T defaultValue_{DefaultValue};
 
+    /// Expressions with values and indices of the matrix
+    template <typename ExpressionType>
+    using if_operands =
+        std::enable_if_t<std::is_same<typename ExpressionType::value_type, T>::value &&
+                         std::is_same<typename ExpressionType::Indices, Indices>::value>;
+
   public:
     Matrix() = default;
     ~Matrix() = default;
-    Matrix(const Matrix &other) noexcept : elements_(other.elements_) {}
-    Matrix(Matrix &&other) noexcept : elements_(std::move(other.elements_)) {}
+    Matrix(const Matrix &other)
+        : elements_(other.elements_), index_(other.index_), digest_(other.digest_) {}
+    Matrix(Matrix &&other) noexcept
+        : elements_(std::move(other.elements_)), index_(std::move(other.index_)),
+          digest_(std::exchange(other.digest_, Digest())) {}
 
-    Matrix(std::initializer_list<std::pair<const TupleKey, T>> list) {
+    /// Make empty matrix which allocates elements by the allocator
+    explicit Matrix(const allocator_type &allocator) : elements_(allocator) {}
+    /// Copy the matrix into memory of the allocator
+    Matrix(const Matrix &other, const allocator_type &allocator)
+        : elements_(other.elements_, allocator), index_(other.index_), digest_(other.digest_) {}
+
+    /// Make the matrix from pairs of indices and values
+    /// @throw std::out_of_range if indices are out of otus::Extents or do not fit into
+    ///        otus::PackedKeys
+    Matrix(std::initializer_list<std::pair<const TupleKey, T>> list,
+           const allocator_type &allocator = allocator_type())
+        : elements_(allocator) {
         elements_.reserve(list.size());
         for (const auto &element : list) {
-            elements_.emplace(element);
+            const Indices indices = make_indices(element.first);
+            check_bounds(indices);
+            if (elements_.emplace(KeyCodec::encode(indices), element.second).second) {
+                index_.insert(indices);
+                digest_.add(indices, element.second);
+            }
         }
     }
 
+    /// Make the matrix from range of tuples (indices..., value) like values of the iterator
+    /// @see insert_bulk
+    template <typename InputIt, typename Merge = LastWins>
+    static Matrix from_triplets(InputIt first, InputIt last, Merge merge = Merge(),
+                                const allocator_type &allocator = allocator_type()) {
+        Matrix matrix(allocator);
+        matrix.insert_bulk(first, last, merge);
+        return matrix;
+    }
+
+    /// Evaluate element-wise operations with matrices in one pass over their elements
+    /// @throw std::domain_error if elements which are default in all operands get
+    ///        other value than DefaultValue
+    template <typename Operation, typename Lhs, typename Rhs,
+              typename = if_operands<Expression<Operation, Lhs, Rhs>>>
+    Matrix(const Expression<Operation, Lhs, Rhs> &expression) // NOLINT
+        : Matrix(expression.template evaluate<Matrix>()) {}
+
+    // The journal stays attached to this matrix and records assignment as removal of all
+    // elements and insertion of new ones. So replacing the matrix by a rebuilt one ships
+    // the full copy instead of deltas: diff() of the old and the new matrix gives only
+    // changed elements. Records are reserved before elements are changed, and the copy
+    // assignment copies elements and the index aside before it moves them in, so a
+    // bad_alloc leaves the matrix and the journal as they were. It holds while moves of
+    // the storage do not throw: allocators are equal or propagate on move assignment.
+
     Matrix &operator=(const Matrix &other) {
-        elements_ = other.elements_;
+        Contanter elements(other.elements_);
+        Index index(other.index_);
+        reserve_record(other.size() + 1);
+        elements_ = std::move(elements);
+        index_ = std::move(index);
+        digest_ = other.digest_;
+        record_assignment();
         return *this;
     }
-    Matrix &operator=(Matrix &&other) noexcept {
+    Matrix &operator=(Matrix &&other) {
+        reserve_record(other.size() + 1);
         elements_ = std::move(other.elements_);
+        index_ = std::move(other.index_);
+        digest_ = std::exchange(other.digest_, Digest());
+        record_assignment();
         return *this;
     }
+    template <typename Operation, typename Lhs, typename Rhs,
+              typename = if_operands<Expression<Operation, Lhs, Rhs>>>
+    Matrix &operator=(const Expression<Operation, Lhs, Rhs> &expression) {
+        // operands may refer to this matrix, so the result is built aside
+        return *this = expression.template evaluate<Matrix>();
+    }
 
-    bool operator==(const Matrix &other) const { return elements_ == other.elements_; }
+    /// Compare elements, matrices with otus::TrackFingerprint and different fingerprints
+    /// are unequal without the walk over elements
+    bool operator==(const Matrix &other) const {
+        return digest_ == other.digest_ && elements_ == other.elements_;
+    }
     bool operator!=(const Matrix &other) const { return !(*this == other); }
 
-    NextLayout operator[](size_t idx) { return NextLayout(idx, elements_); }
-    const NextLayout operator[](size_t idx) const { return NextLayout(idx, elements_); }
+    /// Get the order-independent fingerprint of elements: equal matrices have equal
+    /// fingerprints with any options, so saved fingerprints detect changes. It is kept
+    /// up to date with otus::TrackFingerprint and computed by the walk otherwise.
+    uint64_t fingerprint() const { return fingerprint(Tracked{}); }
+
+    /// Access to the element by chain of Layouts: matrix[i][j]
+    /// @throw std::out_of_range by the last index if indices are out of otus::Extents
+    NextLayout operator[](size_t idx) { return NextLayout(*this, Indices{{idx}}); }
+    ConstNextLayout operator[](size_t idx) const { return ConstNextLayout(*this, Indices{{idx}}); }
 
-    /// Return an input iterator to the beginning
-    /// @return Input iterator to the begining
+    /// Access to the element by all indices at once without chain of Layouts
+    /// @return Smart Object for get/set value of the element
+    /// @throw std::out_of_range if indices are out of otus::Extents
+    template <typename... Idx>
+    Element operator()(Idx... idx) {
+        static_assert(sizeof...(Idx) == Dimension, "Count of indices must be equal to Dimension");
+        return Element(*this, Indices{{static_cast<size_t>(idx)...}});
+    }
+    template <typename... Idx>
+    ConstElement operator()(Idx... idx) const {
+        static_assert(sizeof...(Idx) == Dimension, "Count of indices must be equal to Dimension");
+        return ConstElement(*this, Indices{{static_cast<size_t>(idx)...}});
+    }
+
+    /// Get the view of the matrix with axes in other order without copying elements: the
+    /// index on the axis k of the view is the index on the axis Axes[k] of the matrix, e.g.
+    /// permute<2, 0, 1>()[x][y][z] is the element [y][z][x] of the matrix.
+    ///
+    /// Reads and writes through the view go to elements of the matrix by Layouts like
+    /// operator[] does, iteration and slices give indices in the order of axes of the view.
+    /// Elements are copied only by materialize() of the view.
+    template <size_t... Axes>
+    Permuted<Matrix, Axes...> permute() {
+        return Permuted<Matrix, Axes...>(*this);
+    }
+    template <size_t... Axes>
+    Permuted<const Matrix, Axes...> permute() const {
+        return Permuted<const Matrix, Axes...>(*this);
+    }
+
+    /// Get the view with the reversed order of axes: rows of the two dimension matrix are
+    /// columns of the view
+    auto transpose() { return reverse_axes(*this, std::make_index_sequence<Dimension>{}); }
+    auto transpose() const { return reverse_axes(*this, std::make_index_sequence<Dimension>{}); }
+
+    /// Access to the element by array of indices
+    /// @return Smart Object for get/set value of the element
+    /// @throw std::out_of_range if indices are out of otus::Extents or do not fit into
+    ///        otus::PackedKeys
+    Element at(const Indices &indices) {
+        check_bounds(indices);
+        return Element(*this, indices);
+    }
+    ConstElement at(const Indices &indices) const {
+        check_bounds(indices);
+        return ConstElement(*this, indices);
+    }
+
+    /// Replace value of the element by result of `function(value)` with one lookup.
+    /// The element is removed from the matrix if the result is equal to the default value.
+    /// The matrix is not changed if the function throws.
+    ///
+    /// std::unordered_map has no try_emplace before C++17, so otus::UnorderedStorage of
+    /// C++14 builds looks up the absent element twice: to read it and to insert it.
+    /// @return New value of the element
+    template <typename Function>
+    T update(const Indices &indices, Function &&function) {
+        return at(indices).update(std::forward<Function>(function));
+    }
+
+    /// Read values of elements at indices in [first, last) into `out` like operator[] does.
+    ///
+    /// Keys of following elements are hashed and their buckets (slots, cells) are loaded
+    /// while preceding elements are read, so cache misses of scattered elements overlap
+    /// instead of waiting for each other.
+    /// @return Output iterator after the last value
+    template <typename InputIt, typename OutputIt>
+    OutputIt get_many(InputIt first, InputIt last, OutputIt out) const {
+        pipeline(first, last, [this, &out](const Key &key) {
+            *out = get_value(key);
+            ++out;
+        });
+        return out;
+    }
+
+    /// Assign values from `values` to elements at indices in [first, last) like operator[]
+    /// does: the element is removed by the default value. Memory of following elements is
+    /// loaded ahead as get_many() does.
+    /// @return Iterator after the last used value
+    /// @throw std::out_of_range if indices are out of otus::Extents, values are assigned
+    ///        to elements of preceding blocks of prefetch_window indices
+    template <typename InputIt, typename ValueIt>
+    ValueIt set_many(InputIt first, InputIt last, ValueIt values) {
+        pipeline(first, last, [this, &values](const Key &key) {
+            set_value(key, *values);
+            ++values;
+        });
+        return values;
+    }
+
+    /// Remove the element from the matrix
+    /// @return count of removed elements (0 or 1)
+    /// @throw std::out_of_range if indices are out of otus::Extents
+    size_t erase(const Indices &indices) {
+        auto iter = elements_.find(KeyCodec::encode(indices));
+        if (iter == elements_.end()) {
+            return 0;
+        }
+        reserve_record();
+        digest_.remove(indices, static_cast<const T &>(iter->second));
+        elements_.erase(iter);
+        index_.erase(indices);
+        counters_.erased();
+        record(ChangeKind::erase, indices, DefaultValue);
+        return 1;
+    }
+
+    /// Return an iterator to the beginning, the iterator gives tuples of references
+    /// (indices..., value) which support structured bindings.
+    ///
+    /// The iterator is multipass: its copies visit the same elements in the same order.
+    /// But tuples are returned by value instead of references to value_type, so its
+    /// category is the input iterator.
+    /// @return Multipass input iterator to the begining
     auto begin() const noexcept { return Iterator(elements_.cbegin()); }
 
-    /// Return an input iterator to the end
-    /// @return Input iterator to the end
+    /// Return an iterator to the end
+    /// @return Multipass input iterator to the end
     auto end() const noexcept { return Iterator(elements_.cend()); }
 
+    /// Iterate over elements with mutable values: `for (auto &&[i, j, v] : m.mutable_elements())`.
+    ///
+    /// The element is removed when the iterator leaves it with the default value, the
+    /// element where the traversal stops is checked when the range is destroyed. Other
+    /// elements are not invalidated, so the traversal visits each element once. Only one
+    /// traversal of the range may be active at a time.
+    /// @return Range with begin()/end() input iterators of tuples (indices..., value)
+    MutableRange mutable_elements() { return MutableRange(*this); }
+
+    /// Get elements in the box: lo[i] <= indices[i] <= hi[i] on each axis.
+    /// Elements are visited in lexicographic order with otus::OrderedIndex,
+    /// otherwise the range is a filtered scan of all elements.
+    /// @return Range with begin()/end() input iterators of tuples (indices..., value)
+    auto range(const Indices &lo, const Indices &hi) const { return Range(*this, lo, hi); }
+
+    /// Insert range of tuples (indices..., value) like values of the iterator.
+    ///
+    /// The container is presized for forward ranges, default values are skipped and
+    /// `merge(old_value, new_value)` resolves duplicated elements (in the range or with
+    /// elements of the matrix). The element is removed if the merged value is default.
+    /// @throw std::out_of_range if indices are out of otus::Extents or do not fit into
+    ///        otus::PackedKeys, preceding elements of the range are inserted
+    template <typename InputIt, typename Merge = LastWins>
+    void insert_bulk(InputIt first, InputIt last, Merge merge = Merge()) {
+        reserve_for(first, last, typename std::iterator_traits<InputIt>::iterator_category{});
+        for (; first != last; ++first) {
+            const auto &element = *first;
+            const Indices indices = make_indices(element);
+            check_bounds(indices);
+            const T value = std::get<Dimension>(element);
+            if (value == DefaultValue) {
+                continue;
+            }
+            reserve_record();
+            // most of elements are new, so emplace is one lookup even without try_emplace
+            const size_t capacity = counters_.capacity(elements_);
+            const Key key = KeyCodec::encode(indices);
+            auto result = elements_.emplace(key, value);
+            if (result.second) {
+                index_inserted(key);
+                counters_.inserted(elements_, capacity);
+                digest_.add(indices, value);
+                record(ChangeKind::insert, indices, value);
+            } else {
+                const T old_value = result.first->second;
+                const T merged = merge(old_value, value);
+                if (merged != DefaultValue) {
+                    result.first->second = merged;
+                    counters_.updated();
+                    digest_.replace(indices, old_value, merged);
+                    record(ChangeKind::update, indices, merged);
+                } else {
+                    elements_.erase(result.first);
+                    index_.erase(indices);
+                    counters_.erased();
+                    digest_.remove(indices, old_value);
+                    record(ChangeKind::erase, indices, merged);
+                }
+            }
+        }
+    }
+
+    /// Call `function(element)` for each element by threads of the pool, elements are
+    /// tuples of references (indices..., value) like values of the iterator.
+    /// Ranges of buckets (or slots of otus::FlatStorage) are split between threads, so each
+    /// element is visited once and the function must be safe to call concurrently.
+    /// The first exception thrown by the function is rethrown in the caller.
+    template <typename Function>
+    void parallel_for_each(Function &&function, ThreadPool &pool = ThreadPool::shared()) const {
+        using Reference = element_reference<const T>;
+        pool.parallel_for(detail::partition_count(elements_), [this, &function](size_t first,
+                                                                                size_t last) {
+            detail::for_each_in_partition(elements_, first, last, [&function](const auto &element) {
+                function(Reference::make(element.first, element.second));
+            });
+        });
+    }
+
+    /// Reduce elements by threads of the pool: each part of the storage is reduced by
+    /// `reduce(result, element)` starting from `init`, then results of parts are joined
+    /// by `combine(result, result)` in the order of parts.
+    /// `init` must be the identity of `combine`, e.g. 0 for sum or empty histogram.
+    template <typename Result, typename Reduce, typename Combine,
+              typename = std::enable_if_t<!std::is_same<std::decay_t<Combine>, ThreadPool>::value>>
+    Result parallel_reduce(Result init, Reduce reduce, Combine combine,
+                           ThreadPool &pool = ThreadPool::shared()) const {
+        using Reference = element_reference<const T>;
+        const size_t count = detail::partition_count(elements_);
+        const size_t parts = std::max<size_t>(1, std::min(count, pool.concurrency() * 4));
+        std::vector<Result> results(parts, init);
+        pool.parallel_for(parts, [&](size_t first, size_t last) {
+            for (size_t part = first; part < last; ++part) {
+                // the result is local while the part is reduced, so threads do not share lines
+                Result result = init;
+                detail::for_each_in_partition(
+                    elements_, count * part / parts, count * (part + 1) / parts,
+                    [&](const auto &element) {
+                        result = reduce(std::move(result),
+                                        Reference::make(element.first, element.second));
+                    });
+                results[part] = std::move(result);
+            }
+        });
+
+        Result result = std::move(results.front());
+        for (size_t part = 1; part < parts; ++part) {
+            result = combine(std::move(result), std::move(results[part]));
+        }
+        return result;
+    }
+
+    /// Reduce values of elements by the associative and commutative `operation(T, T)`,
+    /// e.g. std::plus<>() or the maximum
+    template <typename Operation>
+    T parallel_reduce(T init, Operation operation, ThreadPool &pool = ThreadPool::shared()) const {
+        return parallel_reduce(
+            init,
+            [&operation](const T &result, const auto &element) {
+                return operation(result, std::get<Dimension>(element));
+            },
+            operation, pool);
+    }
+
     /// Get real count of elements in matrix
     /// @return count of elements
     size_t size() const noexcept { return elements_.size(); }
 
+    /// Get value of elements which are not stored in the matrix
+    static constexpr T default_value() noexcept { return DefaultValue; }
+
+    /// Reserve space for at least `count` elements without rehashing
+    void reserve(size_t count) {
+        const size_t capacity = counters_.capacity(elements_);
+        elements_.reserve(count);
+        counters_.resized(elements_, capacity);
+    }
+
+    /// Get allocator of elements, it is converted to allocator_type
+    allocator_type get_allocator() const { return allocator_type(elements_.get_allocator()); }
+
+    /// Get average count of elements per bucket
+    float load_factor() const noexcept { return elements_.load_factor(); }
+
+    /// Get/set the maximum load factor after which the container grows
+    float max_load_factor() const noexcept { return elements_.max_load_factor(); }
+    void max_load_factor(float factor) { elements_.max_load_factor(factor); }
+
+    /// Get counters of operations and the layout of the storage: lengths of probes of
+    /// elements and lengths of buckets. Counters are zero unless the matrix has the
+    /// otus::CollectStats option, the layout is collected by the walk over the storage.
+    MatrixStats stats() const {
+        MatrixStats stats;
+        counters_.snapshot(stats);
+        stats.size = size();
+        stats.buckets = detail::partition_count(elements_);
+        stats.load_factor = load_factor();
+        detail::collect_layout(elements_, stats);
+        return stats;
+    }
+
+    /// Set counters of operations to zero
+    void reset_stats() noexcept { counters_.reset(); }
+
+    /// Estimate bytes of memory held by keys, values and structures of the storage and
+    /// the index. Nodes of otus::UnorderedStorage are estimated without allocator headers.
+    MemoryUsage memory_usage() const {
+        MemoryUsage usage = detail::memory_usage(elements_);
+        usage.overhead += index_.allocated_bytes();
+        return usage;
+    }
+
     /// Clears the mapped matrix.
-    void clear() noexcept { elements_.clear(); }
-};
+    void clear() {
+        reserve_record();
+        elements_.clear();
+        index_.clear();
+        digest_.clear();
+        if (journal_ != nullptr) {
+            journal_->record_clear();
+        }
+    }
 
-// ****************************
-// * Struct Matrix::TupleHash *
-// ****************************
-// Boost for combining hash values
-// https://www.boost.org/doc/libs/1_38_0/doc/html/hash/reference.html#boost.hash_combine
-template <typename T, T DefaultValue, size_t Dimension>
-class Matrix<T, DefaultValue, Dimension>::TupleHash {
-    inline size_t get_hash(size_t &seed, size_t value) const {
-        return std::hash<size_t>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    /// Record following changes of elements into the journal, nullptr detaches it.
+    /// The journal is not copied or moved with the matrix. Without the journal each
+    /// change costs one check of the pointer.
+    void attach(Journal *journal) noexcept { journal_ = journal; }
+
+    /// Get the attached journal or nullptr
+    Journal *journal() const noexcept { return journal_; }
+
+    /// Make immutable copy of the matrix in compressed format
+    /// @return otus::CsrMatrix for two dimension matrix and otus::CsfTensor otherwise
+    auto freeze() const {
+        using Frozen = std::conditional_t<Dimension == 2, CsrMatrix<T, DefaultValue>,
+                                          CsfTensor<T, DefaultValue, Dimension>>;
+        return Frozen(*this);
+    }
+
+  private:
+    /// Count of elements between the load of memory of the key and its lookup
+    static constexpr size_t prefetch_window = 16;
+
+    /// Call `resolve(key)` for keys of indices in [first, last) in their order. Keys are
+    /// taken by blocks of prefetch_window: memory of all keys of the block is loaded
+    /// before the first of them is resolved.
+    template <typename InputIt, typename Resolve>
+    void pipeline(InputIt first, InputIt last, Resolve &&resolve) const {
+        std::array<Key, prefetch_window> keys;
+        while (first != last) {
+            size_t count = 0;
+            for (; count != prefetch_window && first != last; ++first, ++count) {
+                keys[count] = KeyCodec::encode(*first);
+                detail::prefetch_lookup(elements_, keys[count]);
+            }
+            for (size_t i = 0; i != count; ++i) {
+                resolve(keys[i]);
+            }
+        }
     }
 
-    template <std::size_t... Indices>
-    void combine_hash(size_t &seed, const TupleKey &tuple, std::index_sequence<Indices...>) const {
-        using swallow = size_t[];
-        (void)swallow{(seed ^= get_hash(seed, std::get<Indices>(tuple)))...};
+    uint64_t fingerprint(std::true_type) const noexcept { return digest_.value(); }
+    uint64_t fingerprint(std::false_type) const {
+        TrackFingerprint::digest digest;
+        for (const auto &element : elements_) {
+            digest.add(decode(element.first), element.second);
+        }
+        return digest.value();
     }
 
-  public:
-    size_t operator()(const TupleKey &tuple) const {
-        size_t seed = 0;
-        combine_hash(seed, tuple, std::make_index_sequence<Dimension>{});
+    template <typename InputIt>
+    void reserve_for(InputIt first, InputIt last, std::forward_iterator_tag) {
+        reserve(size() + static_cast<size_t>(std::distance(first, last)));
+    }
+    template <typename InputIt>
+    void reserve_for(InputIt, InputIt, std::input_iterator_tag) {}
+
+    static void check_bounds(const Indices &indices) {
+        if (!KeyCodec::contains(indices)) {
+            throw std::out_of_range("Indices are out of bounds of otus::Matrix");
+        }
+    }
+
+    /// Make indices from tuple or array of coordinates
+    template <typename Coordinates, size_t... I>
+    static Indices make_indices(const Coordinates &coordinates, std::index_sequence<I...>) {
+        return Indices{{static_cast<size_t>(std::get<I>(coordinates))...}};
+    }
+    template <typename Coordinates>
+    static Indices make_indices(const Coordinates &coordinates) {
+        return make_indices(coordinates, std::make_index_sequence<Dimension>{});
+    }
+
+    /// Decode indices from the key of the container
+    template <size_t... I>
+    static Indices decode(const Key &key, std::index_sequence<I...>) {
+        return Indices{{KeyCodec::template get<I>(key)...}};
+    }
+    static Indices decode(const Key &key) {
+        return decode(key, std::make_index_sequence<Dimension>{});
+    }
+    /// Encode indices into the key of the container, Layouts of views encode them with
+    /// permuted axes
+    static Key encode(const Indices &indices) { return KeyCodec::encode(indices); }
+
+    template <typename Self, size_t... I>
+    static auto reverse_axes(Self &self, std::index_sequence<I...>) {
+        return self.template permute<(Dimension - 1 - I)...>();
+    }
+
+    /// Append the change to the attached journal
+    void record(ChangeKind kind, const Indices &indices, const T &value) {
+        if (journal_ != nullptr) {
+            journal_->record(kind, indices, value);
+        }
+    }
+
+    /// Reserve the record of the following change before the change is made, so the
+    /// failed allocation of the record does not leave the change unrecorded
+    void reserve_record(size_t count = 1) {
+        if (journal_ != nullptr) {
+            journal_->reserve(count);
+        }
+    }
+
+    void record_assignment() {
+        if (journal_ != nullptr) {
+            journal_->record_clear();
+            for (const auto &element : elements_) {
+                journal_->record(ChangeKind::insert, decode(element.first), element.second);
+            }
+        }
+    }
+
+    /// Add the inserted element to the index, the element is removed if the index throws
+    void index_inserted(const Key &key) {
+        try {
+            index_.insert(decode(key));
+        } catch (...) {
+            elements_.erase(key);
+            throw;
+        }
+    }
+
+    // Mutations of elements used by Layouts, they keep the index and the journal consistent
+
+    const T &get_value(const Key &key) const {
+        const T &value = detail::lookup_value(elements_, key, default_value_);
+        // absent elements are the reference to the default value, so no other lookup
+        counters_.found(&value != &default_value_);
+        return value;
+    }
+
+    void set_value(const Key &key, const T &value) {
+        reserve_record();
+        if (value != DefaultValue) {
+            const size_t count = elements_.size();
+            const size_t capacity = counters_.capacity(elements_);
+            T &stored = elements_[key];
+            const bool inserted = elements_.size() != count;
+            if (inserted) {
+                index_inserted(key);
+                counters_.inserted(elements_, capacity);
+                digest_.add(decode(key), value);
+            } else {
+                counters_.updated();
+                digest_.replace(decode(key), stored, value);
+            }
+            stored = value;
+            record(inserted ? ChangeKind::insert : ChangeKind::update, decode(key), value);
+        } else {
+            auto iter = elements_.find(key);
+            if (iter != elements_.end()) {
+                digest_.remove(decode(key), static_cast<const T &>(iter->second));
+                elements_.erase(iter);
+                index_.erase(decode(key));
+                counters_.erased();
+                record(ChangeKind::erase, decode(key), value);
+            }
+        }
+    }
+
+    template <typename Function>
+    T update_value(const Key &key, Function &&function) {
+        reserve_record();
+        const size_t count = elements_.size();
+        const size_t capacity = counters_.capacity(elements_);
+        T old_value = DefaultValue;
+        const T value = detail::update_value(elements_, key, default_value_,
+                                             [&function, &old_value](const T &current) {
+                                                 old_value = current;
+                                                 return function(current);
+                                             });
+        if (elements_.size() > count) {
+            index_inserted(key);
+            counters_.inserted(elements_, capacity);
+            digest_.add(decode(key), value);
+            record(ChangeKind::insert, decode(key), value);
+        } else if (elements_.size() < count) {
+            index_.erase(decode(key));
+            counters_.erased();
+            digest_.remove(decode(key), old_value);
+            record(ChangeKind::erase, decode(key), value);
+        } else if (value != DefaultValue) {
+            counters_.updated();
+            digest_.replace(decode(key), old_value, value);
+            record(ChangeKind::update, decode(key), value);
+        }
+        return value;
+    }
+
+    // Positions of range iterators in the container (filtered scan)
+
+    Cursor first_cursor(const Indices &, std::false_type) const { return elements_.cbegin(); }
+    Cursor end_cursor(std::false_type) const { return elements_.cend(); }
+
+    static bool in_box(const Indices &indices, const Indices &lo, const Indices &hi) noexcept {
+        for (size_t axis = 0; axis < Dimension; ++axis) {
+            if (indices[axis] < lo[axis] || hi[axis] < indices[axis]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Cursor seek(Cursor cursor, const Indices &lo, const Indices &hi, std::false_type) const {
+        while (cursor != elements_.cend() && !in_box(decode(cursor->first), lo, hi)) {
+            ++cursor;
+        }
+        return cursor;
+    }
+
+    template <size_t... I>
+    typename Iterator::value_type cursor_value(Cursor cursor, std::false_type,
+                                               std::index_sequence<I...>) const {
+        return typename Iterator::value_type(KeyCodec::template get<I>(cursor->first)...,
+                                             cursor->second);
+    }
+
+    // Positions of range iterators in the ordered index
+
+    Cursor first_cursor(const Indices &lo, std::true_type) const { return index_.lower_bound(lo); }
+    Cursor end_cursor(std::true_type) const { return index_.cend(); }
+
+    /// Skip indices out of the box: jump to the next prefix which may be in the box
+    Cursor seek(Cursor cursor, const Indices &lo, const Indices &hi, std::true_type) const {
+        while (cursor != index_.cend()) {
+            const Indices &indices = *cursor;
+            size_t axis = 0;
+            while (axis < Dimension && lo[axis] <= indices[axis] && indices[axis] <= hi[axis]) {
+                ++axis;
+            }
+            if (axis == Dimension) {
+                break;
+            }
+
+            Indices next = indices;
+            if (indices[axis] < lo[axis]) {
+                next[axis] = lo[axis];
+            } else {
+                // the prefix is exhausted, so increase the last coordinate of the prefix
+                // which is still less than the upper bound of the box
+                do {
+                    if (axis == 0) {
+                        return index_.cend();
+                    }
+                    --axis;
+                } while (next[axis] >= hi[axis]);
+                ++next[axis];
+            }
+            std::copy(lo.begin() + axis + 1, lo.end(), next.begin() + axis + 1);
+            cursor = index_.lower_bound(next);
+        }
+        return cursor;
+    }
 
-        return seed;
+    template <size_t... I>
+    typename Iterator::value_type cursor_value(Cursor cursor, std::true_type,
+                                               std::index_sequence<I...>) const {
+        const Indices &indices = *cursor;
+        return typename Iterator::value_type(
+            indices[I]..., elements_.find(KeyCodec::encode(indices))->second);
     }
 };
 
+/// The matrix with compile-time extents: FixedMatrix<long, 0, Extents<64, 64>> is
+/// the plain array of 64x64 cells with constant strides. Every access to the cell out of
+/// extents throws std::out_of_range.
+template <typename T, T DefaultValue, typename ExtentsType, typename... Options>
+using FixedMatrix = Matrix<T, DefaultValue, ExtentsType::dimension, ExtentsType, Options...>;
+
+namespace detail {
+
+/// Matrices with fewer elements in total are compared by diff() in the calling thread
+constexpr size_t parallel_diff_threshold = 1 << 14;
+
+/// Check that axes are a permutation of [0, sizeof...(Axes))
+template <size_t... Axes>
+constexpr bool is_permutation() {
+    constexpr size_t axes[] = {Axes...};
+    bool seen[sizeof...(Axes)] = {};
+    for (const size_t axis : axes) {
+        if (axis >= sizeof...(Axes) || seen[axis]) {
+            return false;
+        }
+        seen[axis] = true;
+    }
+    return true;
+}
+
+/// Get indices of the element given by iterators of the matrix
+template <typename Element, size_t... I>
+std::array<size_t, sizeof...(I)> element_indices(const Element &element,
+                                                 std::index_sequence<I...>) {
+    return {{static_cast<size_t>(std::get<I>(element))...}};
+}
+
+template <typename Result, typename Source>
+typename Result::allocator_type allocator_like(const Source &source, std::true_type) {
+    return typename Result::allocator_type(source.get_allocator());
+}
+
+template <typename Result, typename Source>
+typename Result::allocator_type allocator_like(const Source &, std::false_type) {
+    return typename Result::allocator_type();
+}
+
+/// Get allocator of the matrix made from the source: the allocator of the source if it
+/// converts to the allocator of the result (e.g. the same arena), otherwise the default one
+template <typename Result, typename Source>
+typename Result::allocator_type allocator_like(const Source &source) {
+    using Allocator = typename Result::allocator_type;
+    return allocator_like<Result>(
+        source, std::is_constructible<Allocator, typename Source::allocator_type>{});
+}
+
+} // namespace detail
+
+/// Find changes which turn the matrix `from` into the matrix `to`: insertions of elements
+/// which are only in `to`, updates of elements with other values and removals of elements
+/// which are only in `from`. Replay of the result on `from` makes it equal to `to`.
+///
+/// Elements of both matrices are looked up in the other one by threads of the pool,
+/// small matrices are compared in the calling thread.
+/// @return Journal of changes, each element is changed once in unspecified order
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+ChangeJournal<T, Dimension> diff(const Matrix<T, DefaultValue, Dimension, Options...> &from,
+                                 const Matrix<T, DefaultValue, Dimension, Options...> &to,
+                                 ThreadPool &pool = ThreadPool::shared()) {
+    using Change = typename ChangeJournal<T, Dimension>::Change;
+    using Changes = std::vector<Change>;
+    const auto sequence = std::make_index_sequence<Dimension>{};
+
+    ThreadPool caller(0); // without workers the caller runs all chunks
+    ThreadPool &threads = from.size() + to.size() < detail::parallel_diff_threshold ? caller : pool;
+    const auto append = [](Changes changes, Changes other) {
+        changes.insert(changes.end(), other.begin(), other.end());
+        return changes;
+    };
+
+    const Changes removed_or_updated = from.parallel_reduce(
+        Changes(),
+        [&to, sequence](Changes changes, const auto &element) {
+            const auto indices = detail::element_indices(element, sequence);
+            const T &value = to.at(indices);
+            if (value == DefaultValue) {
+                changes.push_back(Change{ChangeKind::erase, indices, value});
+            } else if (value != std::get<Dimension>(element)) {
+                changes.push_back(Change{ChangeKind::update, indices, value});
+            }
+            return changes;
+        },
+        append, threads);
+    const Changes inserted = to.parallel_reduce(
+        Changes(),
+        [&from, sequence](Changes changes, const auto &element) {
+            const auto indices = detail::element_indices(element, sequence);
+            if (from.at(indices) == DefaultValue) {
+                changes.push_back(
+                    Change{ChangeKind::insert, indices, std::get<Dimension>(element)});
+            }
+            return changes;
+        },
+        append, threads);
+
+    ChangeJournal<T, Dimension> journal;
+    for (const Changes *changes : {&removed_or_updated, &inserted}) {
+        for (const Change &change : *changes) {
+            journal.record(change.kind, change.indices, change.value);
+        }
+    }
+    return journal;
+}
+
 // **************************
 // * Class Matrix::Iterator *
 // **************************
-template <typename T, T DefaultValue, size_t Dimension>
-class Matrix<T, DefaultValue, Dimension>::Iterator {
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+class Matrix<T, DefaultValue, Dimension, Options...>::Iterator {
     using MapIteratorType = typename Contanter::const_iterator;
+    using Reference = element_reference<const T>;
     MapIteratorType map_iterator_;
 
-    inline auto get_value() const {
-        return std::tuple_cat((*map_iterator_).first, std::tie((*map_iterator_).second));
-    }
-
   public:
-    using value_type =
-        decltype(std::tuple_cat((*map_iterator_).first, std::tie((*map_iterator_).second)));
+    using value_type = decltype(std::tuple_cat(std::declval<TupleKey>(), std::tie(defaultValue_)));
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = typename Reference::type;
+    // multipass, but reference is not value_type &
     using iterator_category = std::input_iterator_tag;
 
+    Iterator() = default;
     explicit Iterator(MapIteratorType map_iterator) : map_iterator_(map_iterator) {}
 
     Iterator &operator++() {
-        map_iterator_++;
+        ++map_iterator_;
         return *this;
     }
     Iterator operator++(int) {
@@ -158,64 +991,431 @@ class Matrix<T, DefaultValue, Dimension>::Iterator {
     bool operator==(Iterator other) const { return map_iterator_ == other.map_iterator_; }
     bool operator!=(Iterator other) const { return !(*this == other); }
 
-    value_type operator*() const { return get_value(); }
+    reference operator*() const {
+        return Reference::make(map_iterator_->first, map_iterator_->second);
+    }
+};
+
+// *********************************
+// * Class Matrix::MutableIterator *
+// *********************************
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+class Matrix<T, DefaultValue, Dimension, Options...>::MutableIterator {
+    using MapIteratorType = typename Contanter::iterator;
+    using Reference = element_reference<T>;
+    MutableRange *range_;
+    MapIteratorType map_iterator_;
+
+  public:
+    using value_type = typename Iterator::value_type;
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = typename Reference::type;
+    using iterator_category = std::input_iterator_tag;
+
+    MutableIterator(MutableRange *range, MapIteratorType map_iterator)
+        : range_(range), map_iterator_(map_iterator) {}
+
+    MutableIterator &operator++() {
+        map_iterator_ = range_->advance(map_iterator_);
+        return *this;
+    }
+    bool operator==(const MutableIterator &other) const {
+        return map_iterator_ == other.map_iterator_;
+    }
+    bool operator!=(const MutableIterator &other) const { return !(*this == other); }
+
+    reference operator*() const {
+        return Reference::make(map_iterator_->first, map_iterator_->second);
+    }
+};
+
+// ******************************
+// * Class Matrix::MutableRange *
+// ******************************
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+class Matrix<T, DefaultValue, Dimension, Options...>::MutableRange {
+    friend class MutableIterator;
+    using MapIteratorType = typename Contanter::iterator;
+
+    Matrix *matrix_;
+    MapIteratorType current_;
+    T original_{DefaultValue}; // value of the current element before changes
+
+    void arrive(MapIteratorType position) {
+        current_ = position;
+        if (position != matrix_->elements_.end()) {
+            original_ = position->second;
+            // the value is changed through the iterator, so the record is reserved ahead
+            matrix_->reserve_record();
+        }
+    }
+
+    /// Remove the current element if it is default or record its change
+    /// @return Position of the next element
+    MapIteratorType leave(MapIteratorType position) {
+        MapIteratorType next = position;
+        if (position->second == DefaultValue) {
+            const Indices indices = decode(position->first);
+            next = matrix_->elements_.erase(position);
+            matrix_->index_.erase(indices);
+            matrix_->counters_.erased();
+            matrix_->digest_.remove(indices, original_);
+            matrix_->record(ChangeKind::erase, indices, DefaultValue);
+        } else {
+            if (position->second != original_) {
+                matrix_->counters_.updated();
+                matrix_->digest_.replace(decode(position->first), original_,
+                                         static_cast<const T &>(position->second));
+                matrix_->record(ChangeKind::update, decode(position->first), position->second);
+            }
+            ++next;
+        }
+        return next;
+    }
+
+    /// Leave the current element and arrive at the next one
+    /// @return Position of the next element
+    MapIteratorType advance(MapIteratorType position) {
+        const MapIteratorType next = leave(position);
+        arrive(next);
+        return next;
+    }
+
+  public:
+    explicit MutableRange(Matrix &matrix) : matrix_(&matrix) { arrive(matrix.elements_.begin()); }
+
+    MutableRange(MutableRange &&other) noexcept
+        : matrix_(other.matrix_), current_(other.current_), original_(other.original_) {
+        other.matrix_ = nullptr;
+    }
+    MutableRange &operator=(MutableRange &&) = delete;
+
+    ~MutableRange() {
+        if (matrix_ != nullptr && current_ != matrix_->elements_.end()) {
+            leave(current_);
+        }
+    }
+
+    MutableIterator begin() { return MutableIterator(this, current_); }
+    MutableIterator end() { return MutableIterator(this, matrix_->elements_.end()); }
+};
+
+// *******************************
+// * Class Matrix::RangeIterator *
+// *******************************
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+class Matrix<T, DefaultValue, Dimension, Options...>::RangeIterator {
+    const Matrix *matrix_;
+    Indices lo_;
+    Indices hi_;
+    Cursor cursor_;
+
+  public:
+    using value_type = typename Iterator::value_type;
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+    using iterator_category = std::input_iterator_tag;
+
+    RangeIterator(const Matrix *matrix, const Indices &lo, const Indices &hi, Cursor cursor)
+        : matrix_(matrix), lo_(lo), hi_(hi),
+          cursor_(matrix->seek(cursor, lo, hi, Ordered{})) {}
+
+    RangeIterator &operator++() {
+        cursor_ = matrix_->seek(++cursor_, lo_, hi_, Ordered{});
+        return *this;
+    }
+    RangeIterator operator++(int) {
+        RangeIterator retval = *this;
+        ++(*this);
+        return retval;
+    }
+    bool operator==(const RangeIterator &other) const { return cursor_ == other.cursor_; }
+    bool operator!=(const RangeIterator &other) const { return !(*this == other); }
+
+    value_type operator*() const {
+        return matrix_->cursor_value(cursor_, Ordered{}, std::make_index_sequence<Dimension>{});
+    }
+};
+
+// ***********************
+// * Class Matrix::Range *
+// ***********************
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+class Matrix<T, DefaultValue, Dimension, Options...>::Range {
+    const Matrix &matrix_;
+    Indices lo_;
+    Indices hi_;
+
+  public:
+    Range(const Matrix &matrix, const Indices &lo, const Indices &hi)
+        : matrix_(matrix), lo_(lo), hi_(hi) {}
+
+    RangeIterator begin() const {
+        return RangeIterator(&matrix_, lo_, hi_, matrix_.first_cursor(lo_, Ordered{}));
+    }
+    RangeIterator end() const {
+        return RangeIterator(&matrix_, lo_, hi_, matrix_.end_cursor(Ordered{}));
+    }
+};
+
+// **************************
+// * Class Matrix::Permuted *
+// **************************
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+template <typename Owner, size_t... Axes>
+class Matrix<T, DefaultValue, Dimension, Options...>::Permuted {
+    static_assert(sizeof...(Axes) == Dimension, "Count of axes must be equal to Dimension");
+    static_assert(detail::is_permutation<Axes...>(), "Axes must be a permutation of axes");
+
+    template <size_t N, typename LayoutOwner>
+    friend class Layout;
+
+    /// Views of the const matrix are read only like Layouts of the const matrix
+    using View = std::conditional_t<std::is_const<Owner>::value, const Permuted, Permuted>;
+    using NextLayout = Layout<Dimension - 1, View>;
+    using ConstNextLayout = Layout<Dimension - 1, const Permuted>;
+    using Element = Layout<0, View>;
+    using ConstElement = Layout<0, const Permuted>;
+
+    /// Iterator of the matrix which gives indices in the order of axes of the view
+    template <typename BaseIterator>
+    class Remapped;
+    /// Elements of the view in the box
+    template <typename BaseIterator>
+    class Elements;
+
+    Owner &matrix_;
+
+    /// Get indices of the element in the matrix
+    static Indices to_matrix(const Indices &indices) noexcept {
+        constexpr size_t axes[] = {Axes...};
+        Indices result{};
+        for (size_t axis = 0; axis < Dimension; ++axis) {
+            result[axes[axis]] = indices[axis];
+        }
+        return result;
+    }
+
+    // Access used by Layouts of the view: keys are keys of the matrix
+
+    static Key encode(const Indices &indices) { return KeyCodec::encode(to_matrix(indices)); }
+
+    const T &get_value(const Key &key) const { return matrix_.get_value(key); }
+
+    void set_value(const Key &key, const T &value) { matrix_.set_value(key, value); }
+
+    template <typename Function>
+    T update_value(const Key &key, Function &&function) {
+        return matrix_.update_value(key, std::forward<Function>(function));
+    }
+
+  public:
+    using value_type = T;
+
+    explicit Permuted(Owner &matrix) noexcept : matrix_(matrix) {}
+
+    NextLayout operator[](size_t idx) { return NextLayout(*this, Indices{{idx}}); }
+    ConstNextLayout operator[](size_t idx) const { return ConstNextLayout(*this, Indices{{idx}}); }
+
+    /// Access to the element by all indices of the view at once
+    template <typename... Idx>
+    Element operator()(Idx... idx) {
+        static_assert(sizeof...(Idx) == Dimension, "Count of indices must be equal to Dimension");
+        return Element(*this, Indices{{static_cast<size_t>(idx)...}});
+    }
+    template <typename... Idx>
+    ConstElement operator()(Idx... idx) const {
+        static_assert(sizeof...(Idx) == Dimension, "Count of indices must be equal to Dimension");
+        return ConstElement(*this, Indices{{static_cast<size_t>(idx)...}});
+    }
+
+    /// Access to the element by array of indices of the view
+    /// @throw std::out_of_range if indices are out of bounds of keys of the matrix
+    Element at(const Indices &indices) {
+        check_bounds(to_matrix(indices));
+        return Element(*this, indices);
+    }
+    ConstElement at(const Indices &indices) const {
+        check_bounds(to_matrix(indices));
+        return ConstElement(*this, indices);
+    }
+
+    /// Replace value of the element by result of `function(value)` with one lookup
+    /// @see Matrix::update
+    template <typename Function>
+    T update(const Indices &indices, Function &&function) {
+        return at(indices).update(std::forward<Function>(function));
+    }
+
+    /// Iterate over elements of the matrix in its order with indices in the order of axes
+    /// of the view
+    auto begin() const { return Remapped<Iterator>(matrix_.begin()); }
+    auto end() const { return Remapped<Iterator>(matrix_.end()); }
+
+    /// Get elements in the box of indices of the view
+    /// @see Matrix::range
+    auto range(const Indices &lo, const Indices &hi) const {
+        const Range range = matrix_.range(to_matrix(lo), to_matrix(hi));
+        return Elements<RangeIterator>(range.begin(), range.end());
+    }
+
+    size_t size() const noexcept { return matrix_.size(); }
+    static constexpr T default_value() noexcept { return DefaultValue; }
+
+    /// Copy elements into the new matrix with indices in the order of axes of the view, so
+    /// following access does not permute indices. The matrix with otus::Extents needs
+    /// extents of the view, e.g. the same type fits transposed square matrices only.
+    /// The result allocates elements by the allocator of the matrix if it is convertible.
+    template <typename MatrixType = Matrix>
+    MatrixType materialize() const {
+        MatrixType result(detail::allocator_like<MatrixType>(matrix_));
+        result.reserve(size());
+        result.insert_bulk(begin(), end());
+        return result;
+    }
+};
+
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+template <typename Owner, size_t... Axes>
+template <typename BaseIterator>
+class Matrix<T, DefaultValue, Dimension, Options...>::Permuted<Owner, Axes...>::Remapped {
+    BaseIterator base_;
+
+  public:
+    using value_type = typename BaseIterator::value_type;
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = typename BaseIterator::reference;
+    using iterator_category = typename BaseIterator::iterator_category;
+
+    Remapped() = default;
+    explicit Remapped(BaseIterator base) : base_(base) {}
+
+    Remapped &operator++() {
+        ++base_;
+        return *this;
+    }
+    Remapped operator++(int) {
+        Remapped retval = *this;
+        ++(*this);
+        return retval;
+    }
+    bool operator==(const Remapped &other) const { return base_ == other.base_; }
+    bool operator!=(const Remapped &other) const { return !(*this == other); }
+
+    // all indices have the same type, so the tuple with permuted indices has the same type
+    reference operator*() const {
+        auto &&element = *base_;
+        return reference(std::get<Axes>(element)..., std::get<Dimension>(element));
+    }
+};
+
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+template <typename Owner, size_t... Axes>
+template <typename BaseIterator>
+class Matrix<T, DefaultValue, Dimension, Options...>::Permuted<Owner, Axes...>::Elements {
+    Remapped<BaseIterator> first_;
+    Remapped<BaseIterator> last_;
+
+  public:
+    Elements(BaseIterator first, BaseIterator last) : first_(first), last_(last) {}
+
+    Remapped<BaseIterator> begin() const { return first_; }
+    Remapped<BaseIterator> end() const { return last_; }
 };
 
 // ************************
 // * Class Matrix::Layout *
 // ************************
-template <typename T, T DefaultValue, size_t Dimension>
-template <size_t N, typename... Types>
-class Matrix<T, DefaultValue, Dimension>::Layout {
-    using NextLayout = Layout<N - 1, Types..., size_t>;
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+template <size_t N, typename Owner>
+class Matrix<T, DefaultValue, Dimension, Options...>::Layout {
+    using NextLayout = Layout<N - 1, Owner>;
+    using Handle = typename layout_handle<Owner>::type;
+
+    Handle matrix_;
+    Indices indices_; // only first (Dimension - N) indices are set, others are zero
 
-    const Matrix::Contanter &elements_;
-    std::tuple<Types...> tuple_;
+    auto slice() const {
+        Indices last = indices_;
+        std::fill(last.begin() + (Dimension - N), last.end(), std::numeric_limits<size_t>::max());
+        return matrix_.range(indices_, last);
+    }
 
   public:
-    Layout(std::tuple<Types...> tuple, const Matrix::Contanter &elements)
-        : elements_{elements}, tuple_{tuple} {}
+    Layout(const Handle &matrix, const Indices &indices) : matrix_{matrix}, indices_{indices} {}
 
-    NextLayout operator[](size_t idx) {
-        return NextLayout(std::tuple_cat(tuple_, std::tie(idx)), elements_);
-    }
-    const NextLayout operator[](size_t idx) const {
-        return NextLayout(std::tuple_cat(tuple_, std::tie(idx)), elements_);
+    NextLayout operator[](size_t idx) const {
+        Indices indices = indices_;
+        indices[Dimension - N] = idx;
+        return NextLayout(matrix_, indices);
     }
+
+    /// Iterate over elements with the indices set by the Layout
+    /// @return Input iterator of tuples (indices..., value)
+    auto begin() const { return slice().begin(); }
+    auto end() const { return slice().end(); }
 };
 
-// *************************************
-// * Class Matrix::Layout<0, Types...> *
-// *************************************
-template <typename T, T DefaultValue, size_t Dimension>
-template <typename... Types>
-class Matrix<T, DefaultValue, Dimension>::Layout<0, Types...> {
-    std::tuple<Types...> tuple_;
-    const Matrix::Contanter &elements_;
-    const T default_{DefaultValue};
+// **********************************
+// * Class Matrix::Layout<0, Owner> *
+// **********************************
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+template <typename Owner>
+class Matrix<T, DefaultValue, Dimension, Options...>::Layout<0, Owner> {
+    /// Elements of const matrix are read only
+    template <typename MatrixType>
+    using if_mutable = std::enable_if_t<!std::is_const<MatrixType>::value>;
+
+    using Handle = typename layout_handle<Owner>::type;
+
+    Handle matrix_;
+    Key key_;
 
   public:
-    Layout(std::tuple<Types...> tuple, const Matrix::Contanter &elements)
-        : tuple_{tuple}, elements_{elements} {}
+    Layout(const Handle &matrix, const Indices &indices)
+        : matrix_{matrix}, key_{std::remove_const_t<Owner>::encode(indices)} {}
 
-    auto &operator=(const T &value) { // NOLINT
-        if (value != DefaultValue) {
-            const_cast<Matrix::Contanter &>(elements_)[tuple_] = value;
-        } else {
-            auto iter = elements_.find(tuple_);
-            if (iter != elements_.cend()) {
-                const_cast<Matrix::Contanter &>(elements_).erase(iter);
-            }
-        }
+    template <typename MatrixType = Owner, typename = if_mutable<MatrixType>>
+    Layout &operator=(const T &value) { // NOLINT
+        matrix_.set_value(key_, value);
         return *this;
     }
 
-    operator const T &() const noexcept { // NOLINT
-        auto iter = elements_.find(tuple_);
-        return (iter != elements_.cend()) ? iter->second : default_;
+    /// Replace value of the element by result of `function(value)` with one lookup
+    /// @return New value of the element
+    template <typename Function, typename MatrixType = Owner, typename = if_mutable<MatrixType>>
+    T update(Function &&function) {
+        return matrix_.update_value(key_, std::forward<Function>(function));
     }
+
+    // clang-format off
+    auto &operator+=(const T &value) { update([&value](const T &old) { return old + value; }); return *this; }
+    auto &operator-=(const T &value) { update([&value](const T &old) { return old - value; }); return *this; }
+    auto &operator*=(const T &value) { update([&value](const T &old) { return old * value; }); return *this; }
+    auto &operator/=(const T &value) { update([&value](const T &old) { return old / value; }); return *this; }
+    auto &operator%=(const T &value) { update([&value](const T &old) { return old % value; }); return *this; }
+    auto &operator&=(const T &value) { update([&value](const T &old) { return old & value; }); return *this; }
+    auto &operator|=(const T &value) { update([&value](const T &old) { return old | value; }); return *this; }
+    auto &operator^=(const T &value) { update([&value](const T &old) { return old ^ value; }); return *this; }
+    auto &operator<<=(const T &value) { update([&value](const T &old) { return old << value; }); return *this; }
+    auto &operator>>=(const T &value) { update([&value](const T &old) { return old >> value; }); return *this; }
+    // clang-format on
+
+    operator const T &() const noexcept { return matrix_.get_value(key_); } // NOLINT
 };
 
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+constexpr T Matrix<T, DefaultValue, Dimension, Options...>::default_value_;
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+constexpr size_t Matrix<T, DefaultValue, Dimension, Options...>::prefetch_window;
+
 } // namespace otus
 
+#include <otus/compressed_matrix.hpp>
+#include <otus/compressed_tensor.hpp>
+#include <otus/expression.hpp>
+
 #endif // OTUS_MATRIX_HPP
\ No newline at end of file
@@ -0,0 +1,190 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    multiply.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: Parallel multiplication of two dimension sparse matrices.
+//
+
+#ifndef OTUS_MULTIPLY_HPP
+#define OTUS_MULTIPLY_HPP
+
+#include <otus/compressed_matrix.hpp>
+#include <otus/thread_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace otus {
+
+// Indices of the matrix are unbounded, so shapes of operands are explicit. All elements
+// out of the shape are equal to DefaultValue and the matrix is the sum of the dense
+// matrix of DefaultValue and the sparse matrix of deviations (value - DefaultValue).
+
+namespace detail {
+
+/// Check that all elements of CSR matrix are in the shape
+template <typename T, T DefaultValue>
+void check_shape(const CsrMatrix<T, DefaultValue> &matrix, size_t rows, size_t columns) {
+    for (size_t position = 0; position < matrix.line_count(); ++position) {
+        const auto line = matrix.line_at(position);
+        if (line.index() >= rows || (!line.empty() && line.indices()[line.size() - 1] >= columns)) {
+            throw std::out_of_range("Element of otus::Matrix is out of the shape");
+        }
+    }
+}
+
+/// Sum the products of deviations in one row: row of A' by B'
+template <typename T, T DefaultValue, typename Line>
+void multiply_row(const Line &row, const CsrMatrix<T, DefaultValue> &b,
+                  std::vector<std::pair<size_t, T>> &result) {
+    result.clear();
+    for (size_t i = 0; i < row.size(); ++i) {
+        const T a = row.values()[i] - DefaultValue;
+        const auto line = b.line(row.indices()[i]);
+        for (size_t j = 0; j < line.size(); ++j) {
+            result.emplace_back(line.indices()[j], a * (line.values()[j] - DefaultValue));
+        }
+    }
+    std::sort(result.begin(), result.end(),
+              [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+    // merge products of the same column
+    auto last = result.begin();
+    for (auto iter = result.begin(); iter != result.end(); ++iter) {
+        if (last != result.begin() && std::prev(last)->first == iter->first) {
+            std::prev(last)->second += iter->second;
+        } else {
+            *last++ = *iter;
+        }
+    }
+    result.erase(last, result.end());
+}
+
+} // namespace detail
+
+/// Multiply matrix of shape rows x x.size() by vector x
+/// @throw std::out_of_range if any element of the matrix is out of the shape
+template <typename T, T DefaultValue>
+std::vector<T> multiply(const CsrMatrix<T, DefaultValue> &matrix, const std::vector<T> &x,
+                        size_t rows, ThreadPool &pool = ThreadPool::shared()) {
+    detail::check_shape(matrix, rows, x.size());
+
+    T sum{};
+    for (const T &value : x) {
+        sum += value;
+    }
+    std::vector<T> y(rows, DefaultValue * sum);
+
+    pool.parallel_for(matrix.line_count(), [&matrix, &x, &y](size_t first, size_t last) {
+        for (size_t position = first; position < last; ++position) {
+            const auto line = matrix.line_at(position);
+            T value = y[line.index()];
+            for (size_t i = 0; i < line.size(); ++i) {
+                value += (line.values()[i] - DefaultValue) * x[line.indices()[i]];
+            }
+            y[line.index()] = value;
+        }
+    });
+    return y;
+}
+
+template <typename T, T DefaultValue, typename... Options>
+std::vector<T> multiply(const Matrix<T, DefaultValue, 2, Options...> &matrix,
+                        const std::vector<T> &x, size_t rows,
+                        ThreadPool &pool = ThreadPool::shared()) {
+    return multiply(matrix.freeze(), x, rows, pool);
+}
+
+/// Multiply matrix A of shape rows x inner by matrix B of shape inner x columns
+///
+/// With zero DefaultValue the product is sparse. Otherwise each element of the product
+/// gets inner * DefaultValue^2 and sums of deviations, so the product is dense in the shape.
+/// @throw std::out_of_range if any element of the matrices is out of the shape
+template <typename T, T DefaultValue>
+Matrix<T, DefaultValue> multiply(const CsrMatrix<T, DefaultValue> &a,
+                                 const CsrMatrix<T, DefaultValue> &b, size_t rows, size_t inner,
+                                 size_t columns, ThreadPool &pool = ThreadPool::shared()) {
+    detail::check_shape(a, rows, inner);
+    detail::check_shape(b, inner, columns);
+
+    using Row = std::vector<std::pair<size_t, T>>;
+    const bool dense = DefaultValue != T{};
+    std::vector<Row> products(dense ? rows : a.line_count());
+
+    // sums of deviations in rows of A and in columns of B
+    std::vector<T> row_sums, column_sums;
+    if (dense) {
+        row_sums.assign(rows, T{});
+        for (const auto element : a) {
+            row_sums[std::get<0>(element)] += std::get<2>(element) - DefaultValue;
+        }
+        column_sums.assign(columns, T{});
+        for (const auto element : b) {
+            column_sums[std::get<1>(element)] += std::get<2>(element) - DefaultValue;
+        }
+    }
+
+    pool.parallel_for(products.size(), [&](size_t first, size_t last) {
+        Row deviations;
+        for (size_t position = first; position < last; ++position) {
+            Row &product = products[position];
+            if (!dense) {
+                detail::multiply_row(a.line_at(position), b, product);
+                product.erase(std::remove_if(product.begin(), product.end(),
+                                             [](const auto &p) { return p.second == T{}; }),
+                              product.end());
+                continue;
+            }
+
+            detail::multiply_row(a.line(position), b, deviations);
+            const T base = static_cast<T>(inner) * DefaultValue * DefaultValue +
+                           DefaultValue * row_sums[position];
+            auto deviation = deviations.cbegin();
+            for (size_t column = 0; column < columns; ++column) {
+                T value = base + DefaultValue * column_sums[column];
+                if (deviation != deviations.cend() && deviation->first == column) {
+                    value += (deviation++)->second;
+                }
+                if (value != DefaultValue) {
+                    product.emplace_back(column, value);
+                }
+            }
+        }
+    });
+
+    Matrix<T, DefaultValue> result;
+    size_t count = 0;
+    for (const auto &product : products) {
+        count += product.size();
+    }
+    result.reserve(count);
+    for (size_t position = 0; position < products.size(); ++position) {
+        const size_t row = dense ? position : a.line_at(position).index();
+        for (const auto &element : products[position]) {
+            result(row, element.first) = element.second;
+        }
+    }
+    return result;
+}
+
+template <typename T, T DefaultValue, typename... Options>
+Matrix<T, DefaultValue> multiply(const Matrix<T, DefaultValue, 2, Options...> &a,
+                                 const Matrix<T, DefaultValue, 2, Options...> &b, size_t rows,
+                                 size_t inner, size_t columns,
+                                 ThreadPool &pool = ThreadPool::shared()) {
+    return multiply(a.freeze(), b.freeze(), rows, inner, columns, pool);
+}
+
+} // namespace otus
+
+#endif // OTUS_MULTIPLY_HPP
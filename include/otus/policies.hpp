@@ -0,0 +1,758 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    policies.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: Policies for customization of the multi-dimensional sparse matrix.
+//
+
+#ifndef OTUS_POLICIES_HPP
+#define OTUS_POLICIES_HPP
+
+#include <otus/dense_array.hpp>
+#include <otus/flat_hash_map.hpp>
+#include <otus/tiled_map.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#if defined(__has_include)
+#if __has_include(<memory_resource>) && __cplusplus >= 201703L
+#include <memory_resource>
+#define OTUS_MATRIX_HAS_PMR 1
+#endif
+#endif
+
+namespace otus {
+
+namespace detail {
+
+/// Tag of policies which select the container for elements of the matrix
+struct storage_option {};
+/// Tag of policies which select the representation of keys in the container
+struct key_option {};
+/// Tag of policies which select the hash function of keys
+struct hash_option {};
+/// Tag of policies which select the secondary index of coordinates
+struct index_option {};
+/// Tag of policies which select the allocator of the container
+struct allocator_option {};
+/// Tag of hints of the expected density of elements
+struct density_option {};
+/// Tag of policies which select counters of operations
+struct stats_option {};
+/// Tag of policies which select tracking of the fingerprint of elements
+struct fingerprint_option {};
+
+/// Find the option with the category in the list of options or use the default option
+template <typename Category, typename Default, typename... Options>
+struct select_option {
+    using type = Default;
+};
+
+template <typename Category, typename Default, typename Option, typename... Options>
+struct select_option<Category, Default, Option, Options...> {
+    using type = std::conditional_t<std::is_same<typename Option::option_category, Category>::value,
+                                    Option,
+                                    typename select_option<Category, Default, Options...>::type>;
+};
+
+template <typename Category, typename Default, typename... Options>
+using select_option_t = typename select_option<Category, Default, Options...>::type;
+
+template <typename Allocator, typename T>
+using rebind_alloc_t = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+template <typename...>
+using void_t = void;
+
+/// Check that the container has try_emplace (FlatHashMap or std::unordered_map since C++17)
+template <typename Container, typename = void>
+struct has_try_emplace : std::false_type {};
+
+template <typename Container>
+struct has_try_emplace<Container, void_t<decltype(std::declval<Container &>().try_emplace(
+                                      std::declval<const typename Container::key_type &>(),
+                                      std::declval<const typename Container::mapped_type &>()))>>
+    : std::true_type {};
+
+/// Replace the value of the key by result of the function with one lookup in the container.
+/// The element is erased when the result is equal to the default value.
+template <typename Container, typename Function>
+typename Container::mapped_type
+update_value(Container &container, const typename Container::key_type &key,
+             const typename Container::mapped_type &default_value, Function &&function,
+             std::true_type /*has_try_emplace*/) {
+    auto result = container.try_emplace(key, default_value);
+    // the new element keeps the default value only while the function is called
+    const typename Container::mapped_type value = [&]() -> typename Container::mapped_type {
+        try {
+            return function(
+                static_cast<const typename Container::mapped_type &>(result.first->second));
+        } catch (...) {
+            if (result.second) {
+                container.erase(result.first);
+            }
+            throw;
+        }
+    }();
+    if (value != default_value) {
+        result.first->second = value;
+    } else {
+        container.erase(result.first);
+    }
+    return value;
+}
+
+/// Without try_emplace the new element costs the second lookup for insertion
+template <typename Container, typename Function>
+typename Container::mapped_type
+update_value(Container &container, const typename Container::key_type &key,
+             const typename Container::mapped_type &default_value, Function &&function,
+             std::false_type /*has_try_emplace*/) {
+    auto iter = container.find(key);
+    if (iter != container.end()) {
+        const typename Container::mapped_type value =
+            function(static_cast<const typename Container::mapped_type &>(iter->second));
+        if (value != default_value) {
+            iter->second = value;
+        } else {
+            container.erase(iter);
+        }
+        return value;
+    }
+
+    const typename Container::mapped_type value = function(default_value);
+    if (value != default_value) {
+        container.emplace(key, value);
+    }
+    return value;
+}
+
+template <typename Container, typename Function>
+typename Container::mapped_type update_value(Container &container,
+                                             const typename Container::key_type &key,
+                                             const typename Container::mapped_type &default_value,
+                                             Function &&function) {
+    return update_value(container, key, default_value, std::forward<Function>(function),
+                        has_try_emplace<Container>{});
+}
+
+// Parts of containers for parallel traversal: buckets of std::unordered_map (visited by
+// local iterators) or slots of FlatHashMap (of the table of tiles for TiledMap). Threads
+// visit disjoint ranges of parts.
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+size_t partition_count(const std::unordered_map<Key, Value, Hash, KeyEqual, Allocator> &container) {
+    return container.bucket_count();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator,
+          typename Function>
+void for_each_in_partition(
+    const std::unordered_map<Key, Value, Hash, KeyEqual, Allocator> &container, size_t first,
+    size_t last, Function &&function) {
+    for (size_t bucket = first; bucket < last; ++bucket) {
+        for (auto iter = container.begin(bucket); iter != container.end(bucket); ++iter) {
+            function(*iter);
+        }
+    }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+size_t partition_count(const FlatHashMap<Key, Value, Hash, KeyEqual, Allocator> &container) {
+    return container.slot_count();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator,
+          typename Function>
+void for_each_in_partition(const FlatHashMap<Key, Value, Hash, KeyEqual, Allocator> &container,
+                           size_t first, size_t last, Function &&function) {
+    container.for_each_in_slots(first, last, std::forward<Function>(function));
+}
+
+template <typename Key, typename Value, size_t Extent, typename Hash, typename Allocator>
+size_t partition_count(const TiledMap<Key, Value, Extent, Hash, Allocator> &container) {
+    return container.slot_count();
+}
+
+template <typename Key, typename Value, size_t Extent, typename Hash, typename Allocator,
+          typename Function>
+void for_each_in_partition(const TiledMap<Key, Value, Extent, Hash, Allocator> &container,
+                           size_t first, size_t last, Function &&function) {
+    container.for_each_in_slots(first, last, std::forward<Function>(function));
+}
+
+template <typename Key, typename Value, size_t Size, typename Allocator>
+size_t partition_count(const DenseArray<Key, Value, Size, Allocator> &container) {
+    return container.slot_count();
+}
+
+template <typename Key, typename Value, size_t Size, typename Allocator, typename Function>
+void for_each_in_partition(const DenseArray<Key, Value, Size, Allocator> &container, size_t first,
+                           size_t last, Function &&function) {
+    container.for_each_in_slots(first, last, std::forward<Function>(function));
+}
+
+/// Get the value of the element or the fallback if the key is absent
+template <typename Container>
+const typename Container::mapped_type &
+lookup_value(const Container &container, const typename Container::key_type &key,
+             const typename Container::mapped_type &fallback) {
+    auto iter = container.find(key);
+    return (iter != container.cend()) ? iter->second : fallback;
+}
+
+/// The dense array selects the cell or the fallback without iterators
+template <typename Key, typename Value, size_t Size, typename Allocator>
+const Value &lookup_value(const DenseArray<Key, Value, Size, Allocator> &container, const Key &key,
+                          const Value &fallback) noexcept {
+    return container.value_or(key, fallback);
+}
+
+/// Load memory of the key ahead of the following lookup: slots of open addressing tables
+/// and cells of dense arrays
+template <typename Container>
+void prefetch_lookup(const Container &container, const typename Container::key_type &key) {
+    container.prefetch(key);
+}
+
+/// Nodes of std::unordered_map are reached only by reading its bucket, which would stall
+/// on the same cache miss as the lookup itself, so nothing is loaded ahead
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void prefetch_lookup(const std::unordered_map<Key, Value, Hash, KeyEqual, Allocator> &,
+                     const Key &) noexcept {}
+
+template <typename TupleType, unsigned N, typename... Types>
+struct generate_tuple_type {
+    using type = typename generate_tuple_type<TupleType, N - 1, TupleType, Types...>::type;
+};
+
+template <typename TupleType, typename... Types>
+struct generate_tuple_type<TupleType, 0, Types...> {
+    using type = std::tuple<Types...>;
+};
+
+/// Multiply-xorshift mixer of 64-bit value
+inline uint64_t mix64(uint64_t value) noexcept {
+    value *= 0x9e3779b97f4a7c15ull;
+    return value ^ (value >> 32);
+}
+
+/// Key with two 64-bit words for packed coordinates
+struct PackedKey128 {
+    uint64_t words[2];
+
+    bool operator==(const PackedKey128 &other) const noexcept {
+        return words[0] == other.words[0] && words[1] == other.words[1];
+    }
+    bool operator!=(const PackedKey128 &other) const noexcept { return !(*this == other); }
+};
+
+/// Fold 128-bit product of two 64-bit values into 64 bits
+inline uint64_t mum(uint64_t lhs, uint64_t rhs) noexcept {
+#if defined(__SIZEOF_INT128__)
+    __extension__ using uint128 = unsigned __int128;
+    const uint128 product = static_cast<uint128>(lhs) * rhs;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+    const uint64_t lhs_low = lhs & 0xffffffffull, lhs_high = lhs >> 32;
+    const uint64_t rhs_low = rhs & 0xffffffffull, rhs_high = rhs >> 32;
+    const uint64_t low_low = lhs_low * rhs_low, high_low = lhs_high * rhs_low;
+    const uint64_t low_high = lhs_low * rhs_high, high_high = lhs_high * rhs_high;
+    const uint64_t middle = (low_low >> 32) + (high_low & 0xffffffffull) + low_high;
+    const uint64_t low = (middle << 32) | (low_low & 0xffffffffull);
+    const uint64_t high = high_high + (high_low >> 32) + (middle >> 32);
+    return low ^ high;
+#endif
+}
+
+/// Final avalanche of XXH3
+inline uint64_t avalanche(uint64_t value) noexcept {
+    value ^= value >> 37;
+    value *= 0x165667919e3779f9ull;
+    return value ^ (value >> 32);
+}
+
+inline uint64_t &key_word(uint64_t &key, size_t) noexcept { return key; }
+inline uint64_t key_word(const uint64_t &key, size_t) noexcept { return key; }
+inline uint64_t &key_word(PackedKey128 &key, size_t index) noexcept { return key.words[index]; }
+inline uint64_t key_word(const PackedKey128 &key, size_t index) noexcept {
+    return key.words[index];
+}
+
+} // namespace detail
+
+// ********************
+// * Struct TupleHash *
+// ********************
+// Boost for combining hash values
+// https://www.boost.org/doc/libs/1_38_0/doc/html/hash/reference.html#boost.hash_combine
+struct TupleHash {
+    using option_category = detail::hash_option;
+
+  private:
+    inline size_t get_hash(size_t &seed, size_t value) const {
+        return std::hash<size_t>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    template <typename TupleKey, std::size_t... Indices>
+    void combine_hash(size_t &seed, const TupleKey &tuple, std::index_sequence<Indices...>) const {
+        using swallow = size_t[];
+        (void)swallow{(seed ^= get_hash(seed, std::get<Indices>(tuple)))...};
+    }
+
+  public:
+    template <typename... Types>
+    size_t operator()(const std::tuple<Types...> &tuple) const {
+        size_t seed = 0;
+        combine_hash(seed, tuple, std::index_sequence_for<Types...>{});
+
+        return seed;
+    }
+};
+
+/// Hash of packed keys with one multiply-xorshift mixer
+struct PackedKeyHash {
+    using option_category = detail::hash_option;
+
+    size_t operator()(uint64_t key) const noexcept {
+        return static_cast<size_t>(detail::mix64(key));
+    }
+    size_t operator()(const detail::PackedKey128 &key) const noexcept {
+        return static_cast<size_t>(
+            detail::mix64(key.words[0] ^ (key.words[1] * 0xc2b2ae3d27d4eb4full)));
+    }
+};
+
+/// Hash of all coordinates at once in style of wyhash/XXH3
+///
+/// Coordinates are mixed in pairs by independent 64x64->128 bit multiplications, so the
+/// compiler can compute them in parallel, and the sum gets the final avalanche. Unlike
+/// TupleHash, diagonal and strided coordinates are spread uniformly over all bits.
+struct MixHash {
+    using option_category = detail::hash_option;
+
+    template <typename... Types>
+    size_t operator()(const std::tuple<Types...> &tuple) const noexcept {
+        return hash_tuple(tuple, std::index_sequence_for<Types...>{});
+    }
+    size_t operator()(uint64_t key) const noexcept { return hash(&key, 1); }
+    size_t operator()(const detail::PackedKey128 &key) const noexcept {
+        return hash(key.words, 2);
+    }
+
+  private:
+    template <typename TupleKey, size_t... Indices>
+    static size_t hash_tuple(const TupleKey &tuple, std::index_sequence<Indices...>) noexcept {
+        const uint64_t coordinates[] = {static_cast<uint64_t>(std::get<Indices>(tuple))...};
+        return hash(coordinates, sizeof...(Indices));
+    }
+
+    static size_t hash(const uint64_t *coordinates, size_t count) noexcept {
+        static constexpr uint64_t secret[] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+                                              0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+        uint64_t accumulator = count * 0x9e3779b97f4a7c15ull;
+        size_t i = 0;
+        for (; i + 1 < count; i += 2) {
+            accumulator += detail::mum(coordinates[i] ^ secret[i % 4],
+                                       coordinates[i + 1] ^ secret[(i + 1) % 4]);
+        }
+        if (i < count) {
+            accumulator += detail::mum(coordinates[i] ^ secret[i % 4], secret[(i + 1) % 4]);
+        }
+        return static_cast<size_t>(detail::avalanche(accumulator));
+    }
+};
+
+/// Merge policy of duplicated elements: keep the last value
+struct LastWins {
+    template <typename T>
+    T operator()(const T & /*old_value*/, const T &new_value) const {
+        return new_value;
+    }
+};
+
+/// Merge policy of duplicated elements: keep the first value
+struct FirstWins {
+    template <typename T>
+    T operator()(const T &old_value, const T & /*new_value*/) const {
+        return old_value;
+    }
+};
+
+/// Merge policy of duplicated elements: sum of the values
+struct Sum {
+    template <typename T>
+    T operator()(const T &old_value, const T &new_value) const {
+        return old_value + new_value;
+    }
+};
+
+/// Store elements of the matrix in std::unordered_map (node based container)
+struct UnorderedStorage {
+    using option_category = detail::storage_option;
+
+    template <typename Key, typename Value, typename Hash, typename Allocator>
+    using container =
+        std::unordered_map<Key, Value, Hash, std::equal_to<Key>,
+                           detail::rebind_alloc_t<Allocator, std::pair<const Key, Value>>>;
+};
+
+/// Store elements of the matrix in otus::FlatHashMap (open addressing container)
+struct FlatStorage {
+    using option_category = detail::storage_option;
+
+    template <typename Key, typename Value, typename Hash, typename Allocator>
+    using container = FlatHashMap<Key, Value, Hash, std::equal_to<Key>,
+                                  detail::rebind_alloc_t<Allocator, std::pair<Key, Value>>>;
+};
+
+/// Store elements of the matrix in otus::TiledMap: tiles of Extent cells on each axis are
+/// kept as sorted lists or as dense arrays when they are filled. Requires otus::TupleKeys.
+/// Extent is a power of two, by default tiles have 256 or 512 cells (16x16, 8x8x8 and so on).
+template <size_t Extent = 0>
+struct TiledStorage {
+    using option_category = detail::storage_option;
+
+    template <typename Key, typename Value, typename Hash, typename Allocator>
+    using container = TiledMap<Key, Value, Extent, Hash,
+                               detail::rebind_alloc_t<Allocator, std::pair<const Key, Value>>>;
+};
+
+/// Store elements of the matrix in otus::DenseArray of Size cells, keys are offsets of
+/// otus::Extents. The matrix with extents selects it itself, see otus::ExpectedDensity.
+template <size_t Size>
+struct DenseStorage {
+    using option_category = detail::storage_option;
+
+    template <typename Key, typename Value, typename Hash, typename Allocator>
+    using container = DenseArray<Key, Value, Size,
+                                 detail::rebind_alloc_t<Allocator, std::pair<const Key, Value>>>;
+};
+
+/// Allocate elements of the matrix by the allocator, it is rebound to the type of elements
+/// of the container. The matrix with stateful allocator is made by Matrix(allocator).
+template <typename Allocator>
+struct StorageAllocator {
+    using option_category = detail::allocator_option;
+
+    using allocator_type = Allocator;
+};
+
+#if defined(OTUS_MATRIX_HAS_PMR)
+/// Allocate elements of the matrix from std::pmr::memory_resource
+using PmrAllocator = StorageAllocator<std::pmr::polymorphic_allocator<std::byte>>;
+#endif
+
+/// Use tuple of size_t as key: coordinates are unbounded
+struct TupleKeys {
+    using option_category = detail::key_option;
+
+    template <size_t Dimension>
+    struct codec {
+        using key_type = typename detail::generate_tuple_type<size_t, Dimension>::type;
+        using hasher = TupleHash;
+
+        /// Make key from coordinates (std::tuple or std::array)
+        template <typename Indices>
+        static key_type encode(const Indices &indices) {
+            return encode(indices, std::make_index_sequence<Dimension>{});
+        }
+
+        /// Get coordinate on axis I from key
+        template <size_t I>
+        static const size_t &get(const key_type &key) noexcept {
+            return std::get<I>(key);
+        }
+
+        /// Check that coordinates may be kept in the key, they are unbounded
+        static constexpr bool contains(const std::array<size_t, Dimension> &) noexcept {
+            return true;
+        }
+
+      private:
+        template <typename Indices, size_t... I>
+        static key_type encode(const Indices &indices, std::index_sequence<I...>) {
+            return key_type(std::get<I>(indices)...);
+        }
+    };
+};
+
+/// Pack coordinates into one 64-bit or 128-bit key
+///
+/// Each coordinate takes sizeof(Coordinate) bytes of the key, so all indices of the
+/// matrix must fit into Coordinate. Matrix::at(), insert_bulk() and the initializer_list
+/// constructor throw std::out_of_range for wider indices, other accesses check them only
+/// in debug builds: in release builds the wider index spills into the neighbour
+/// coordinate and aliases other cell, e.g. [65536][0] of PackedKeys<uint16_t> is [0][1].
+template <typename Coordinate>
+struct PackedKeys {
+    static_assert(std::is_unsigned<Coordinate>::value, "Coordinate must be unsigned integer");
+
+    using option_category = detail::key_option;
+
+    template <size_t Dimension>
+    struct codec {
+      private:
+        static constexpr size_t bits = std::numeric_limits<Coordinate>::digits;
+        static constexpr size_t words = (bits * Dimension + 63) / 64;
+        static_assert(words <= 2, "Coordinates of the matrix do not fit into 128-bit key");
+
+      public:
+        using key_type = std::conditional_t<words == 1, uint64_t, detail::PackedKey128>;
+        using hasher = PackedKeyHash;
+
+        /// Make key from coordinates (std::tuple or std::array)
+        template <typename Indices>
+        static key_type encode(const Indices &indices) {
+            key_type key{};
+            encode(key, indices, std::make_index_sequence<Dimension>{});
+            return key;
+        }
+
+        /// Get coordinate on axis I from key
+        template <size_t I>
+        static size_t get(const key_type &key) noexcept {
+            const uint64_t word = detail::key_word(key, bits * I / 64);
+            return static_cast<size_t>((word >> (bits * I % 64)) &
+                                       std::numeric_limits<Coordinate>::max());
+        }
+
+        /// Check that coordinates fit into Coordinate
+        static bool contains(const std::array<size_t, Dimension> &indices) noexcept {
+            return std::all_of(indices.begin(), indices.end(), [](size_t index) {
+                return index <= std::numeric_limits<Coordinate>::max();
+            });
+        }
+
+      private:
+        template <typename Indices, size_t... I>
+        static void encode(key_type &key, const Indices &indices, std::index_sequence<I...>) {
+            using swallow = int[];
+            (void)swallow{(put<I>(key, std::get<I>(indices)), 0)...};
+        }
+
+        template <size_t I>
+        static void put(key_type &key, size_t index) noexcept {
+            assert(index <= std::numeric_limits<Coordinate>::max() &&
+                   "Index of the matrix does not fit into Coordinate of packed key");
+            detail::key_word(key, bits * I / 64) |= static_cast<uint64_t>(index)
+                                                     << (bits * I % 64);
+        }
+    };
+};
+
+namespace detail {
+
+template <size_t... N>
+constexpr size_t extent_at(size_t axis) noexcept {
+    const size_t extents[] = {N...};
+    return extents[axis];
+}
+
+template <size_t... N>
+constexpr size_t stride_at(size_t axis) noexcept {
+    size_t result = 1;
+    for (size_t i = axis + 1; i < sizeof...(N); ++i) {
+        result *= extent_at<N...>(i);
+    }
+    return result;
+}
+
+/// Check that extents are positive and count of cells fits into size_t
+template <size_t... N>
+constexpr bool extents_fit() noexcept {
+    size_t result = 1;
+    for (size_t i = 0; i < sizeof...(N); ++i) {
+        if (extent_at<N...>(i) == 0 ||
+            result > std::numeric_limits<size_t>::max() / extent_at<N...>(i)) {
+            return false;
+        }
+        result *= extent_at<N...>(i);
+    }
+    return true;
+}
+
+} // namespace detail
+
+/// Bound coordinates by compile-time extents, the key is the row-major offset of the cell
+///
+/// Strides are constants, so the offset is made by multiplications and additions and
+/// coordinates are decoded by divisions by constants. Every key is made by encode(), which
+/// throws std::out_of_range for indices out of extents: an offset past the last cell would
+/// be out of the dense array, and an index past the extent of the axis would alias a cell
+/// of the next row. The matrix keeps elements in the plain array (otus::DenseStorage) if
+/// the array is small or otus::ExpectedDensity says that hash storage would not be
+/// smaller, otherwise in otus::FlatStorage.
+template <size_t... N>
+struct Extents {
+    static_assert(sizeof...(N) > 0, "Extents must have at least one axis");
+    static_assert(detail::extents_fit<N...>(),
+                  "Extents must be positive and count of cells must fit into size_t");
+
+    using option_category = detail::key_option;
+
+    static constexpr size_t dimension = sizeof...(N);
+    /// Count of all cells
+    static constexpr size_t size = detail::extent_at<N...>(0) * detail::stride_at<N...>(0);
+
+    /// Get count of cells on the axis
+    static constexpr size_t extent(size_t axis) noexcept { return detail::extent_at<N...>(axis); }
+
+    /// Get distance between offsets of neighbour cells on the axis
+    static constexpr size_t stride(size_t axis) noexcept { return detail::stride_at<N...>(axis); }
+
+    template <size_t Dimension>
+    struct codec {
+        static_assert(Dimension == dimension, "Count of extents must be equal to Dimension");
+
+        using key_type = uint64_t;
+        using hasher = PackedKeyHash;
+
+        /// Make key from coordinates (std::tuple or std::array)
+        /// @throw std::out_of_range if coordinates are out of extents
+        template <typename Indices>
+        static key_type encode(const Indices &indices) {
+            return encode(indices, std::make_index_sequence<Dimension>{});
+        }
+
+        /// Get coordinate on axis I from key
+        template <size_t I>
+        static size_t get(const key_type &key) noexcept {
+            return static_cast<size_t>(key / constant<stride(I)>::value %
+                                       constant<extent(I)>::value);
+        }
+
+        /// Check that coordinates are less than extents
+        static bool contains(const std::array<size_t, Dimension> &indices) noexcept {
+            for (size_t axis = 0; axis < Dimension; ++axis) {
+                if (indices[axis] >= extent(axis)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+      private:
+        template <size_t Value>
+        using constant = std::integral_constant<size_t, Value>;
+
+        template <typename Indices, size_t... I>
+        static key_type encode(const Indices &indices, std::index_sequence<I...>) {
+            key_type key = 0;
+            using swallow = int[];
+            (void)swallow{(key += put<I>(static_cast<size_t>(std::get<I>(indices))), 0)...};
+            return key;
+        }
+
+        template <size_t I>
+        static key_type put(size_t index) {
+            if (index >= extent(I)) {
+                throw std::out_of_range("Index of the matrix is out of its extents");
+            }
+            return static_cast<key_type>(index) * constant<stride(I)>::value;
+        }
+    };
+};
+
+/// Hint of the share of cells of otus::Extents which keep elements, in percent
+template <size_t Percent>
+struct ExpectedDensity {
+    static_assert(Percent <= 100, "Density is a percentage");
+
+    using option_category = detail::density_option;
+
+    static constexpr size_t percent = Percent;
+};
+
+namespace detail {
+
+/// Arrays of cells up to this size are dense without the hint of density
+constexpr size_t dense_array_bytes = 64 * 1024;
+
+template <typename KeyPolicy, typename T, typename Density>
+struct default_storage {
+    using type = UnorderedStorage;
+};
+
+// Hash storage takes about twice of the key and the value per element, so the array is
+// not larger when the density is above sizeof(T) / (2 * (sizeof(key) + sizeof(T))).
+template <size_t... N, typename T, typename Density>
+struct default_storage<Extents<N...>, T, Density> {
+    static constexpr size_t size = Extents<N...>::size;
+    static constexpr bool dense =
+        size <= dense_array_bytes / sizeof(T) ||
+        Density::percent * 2 * (sizeof(uint64_t) + sizeof(T)) >= 100 * sizeof(T);
+
+    using type = std::conditional_t<dense, DenseStorage<size>, FlatStorage>;
+};
+
+/// Storage of the matrix without the storage option
+template <typename KeyPolicy, typename T, typename... Options>
+using default_storage_t =
+    typename default_storage<KeyPolicy, T,
+                             select_option_t<density_option, ExpectedDensity<0>, Options...>>::type;
+
+} // namespace detail
+
+/// Do not index coordinates: slices and ranges are filtered scans of all elements
+struct NoIndex {
+    using option_category = detail::index_option;
+
+    template <size_t Dimension>
+    struct index {
+        static constexpr bool ordered = false;
+
+        void insert(const std::array<size_t, Dimension> &) noexcept {}
+        void erase(const std::array<size_t, Dimension> &) noexcept {}
+        void clear() noexcept {}
+        size_t allocated_bytes() const noexcept { return 0; }
+    };
+};
+
+/// Keep coordinates of elements in std::set in lexicographic order
+///
+/// Slices and ranges visit only elements under the prefix or in the box, but each
+/// insert and erase of an element also updates the index.
+struct OrderedIndex {
+    using option_category = detail::index_option;
+
+    template <size_t Dimension>
+    struct index : std::set<std::array<size_t, Dimension>> {
+        static constexpr bool ordered = true;
+
+        /// Estimate of memory of nodes of the tree: color and three pointers per node
+        size_t allocated_bytes() const noexcept {
+            return this->size() * (4 * sizeof(void *) + sizeof(std::array<size_t, Dimension>));
+        }
+    };
+};
+
+template <size_t... N>
+constexpr size_t Extents<N...>::dimension;
+template <size_t... N>
+constexpr size_t Extents<N...>::size;
+template <size_t Percent>
+constexpr size_t ExpectedDensity<Percent>::percent;
+
+} // namespace otus
+
+#endif // OTUS_POLICIES_HPP
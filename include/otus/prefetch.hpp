@@ -0,0 +1,41 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    prefetch.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: Hints to load memory of containers ahead of lookups.
+//
+
+#ifndef OTUS_PREFETCH_HPP
+#define OTUS_PREFETCH_HPP
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace otus {
+
+namespace detail {
+
+/// Hint the processor to load the cache line with the address for reading, so the
+/// following access does not wait for memory. It never faults on invalid addresses.
+inline void prefetch(const void *address) noexcept {
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+#else
+    static_cast<void>(address);
+#endif
+}
+
+} // namespace detail
+
+} // namespace otus
+
+#endif // OTUS_PREFETCH_HPP
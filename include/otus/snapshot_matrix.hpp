@@ -0,0 +1,247 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    snapshot_matrix.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: The multi-dimensional sparse matrix with lock-free readers of snapshots.
+//
+
+#ifndef OTUS_SNAPSHOT_MATRIX_HPP
+#define OTUS_SNAPSHOT_MATRIX_HPP
+
+#include <otus/matrix.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace otus {
+
+/// Class of the multi-dimensional sparse matrix for many readers and a writer
+///
+/// Readers see immutable snapshots of the matrix without locks. The writer changes its
+/// own copy of the matrix and publishes it as the next snapshot in batch by publish().
+/// Old snapshots are reclaimed by epochs: a snapshot retired in epoch E is deleted when
+/// all pinned readers have entered an epoch after E.
+template <typename T, T DefaultValue, size_t Dimension = 2, typename... Options>
+class SnapshotMatrix {
+  public:
+    using MatrixType = Matrix<T, DefaultValue, Dimension, Options...>;
+    using Indices = typename MatrixType::Indices;
+
+    /// Default count of readers registered at the same time
+    static constexpr size_t default_readers = 64;
+
+    class Reader;
+    class Snapshot;
+
+  private:
+    static constexpr uint64_t inactive = 0;
+
+    /// Epoch of the reader, the slot takes whole cache line. Before C++17 new[] does not
+    /// honour the over-alignment, so slots may straddle two lines but still do not share
+    /// them with more than one neighbour each.
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{inactive};
+        size_t pins{0}; // count of Snapshots of the reader, used only by its thread
+        std::atomic<bool> used{false};
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        std::unique_ptr<const MatrixType> matrix;
+    };
+
+    std::atomic<const MatrixType *> current_;
+    std::atomic<uint64_t> epoch_{1};
+    std::unique_ptr<Slot[]> slots_;
+    size_t slot_count_;
+
+    std::mutex writer_mutex_; // guards members below
+    MatrixType draft_;
+    std::vector<Retired> retired_;
+
+    /// Delete retired snapshots which are not visible for pinned readers
+    void reclaim_locked() {
+        uint64_t oldest = UINT64_MAX;
+        for (size_t i = 0; i < slot_count_; ++i) {
+            const uint64_t epoch = slots_[i].epoch.load();
+            if (epoch != inactive && epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+        auto last = std::remove_if(retired_.begin(), retired_.end(), [oldest](const auto &retired) {
+            return retired.epoch < oldest;
+        });
+        retired_.erase(last, retired_.end());
+    }
+
+  public:
+    explicit SnapshotMatrix(size_t readers = default_readers)
+        : current_(new MatrixType()), slots_(std::make_unique<Slot[]>(readers)),
+          slot_count_(readers) {}
+
+    SnapshotMatrix(const SnapshotMatrix &) = delete;
+    SnapshotMatrix &operator=(const SnapshotMatrix &) = delete;
+
+    /// All readers must be destroyed before the matrix
+    ~SnapshotMatrix() { delete current_.load(); }
+
+    /// Register the reader, the reader is not thread safe and is used by one thread
+    /// @throw std::length_error if all slots of readers are used
+    Reader reader() {
+        for (size_t i = 0; i < slot_count_; ++i) {
+            bool used = false;
+            if (slots_[i].used.compare_exchange_strong(used, true)) {
+                return Reader(*this, slots_[i]);
+            }
+        }
+        throw std::length_error("Too many readers of otus::SnapshotMatrix");
+    }
+
+    // Writer interface, changes are visible for readers after publish()
+
+    /// Set value of the element in the draft
+    void set(const Indices &indices, const T &value) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        draft_.at(indices) = value;
+    }
+
+    /// Replace value of the element in the draft by result of `function(value)`
+    /// @return New value of the element
+    template <typename Function>
+    T update(const Indices &indices, Function &&function) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        return draft_.update(indices, std::forward<Function>(function));
+    }
+
+    /// Remove the element from the draft
+    /// @return count of removed elements
+    size_t erase(const Indices &indices) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        return draft_.erase(indices);
+    }
+
+    /// Apply `function(matrix)` to the draft and publish it
+    template <typename Function>
+    void write(Function &&function) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        std::forward<Function>(function)(draft_);
+        publish_locked();
+    }
+
+    /// Make copy of the draft as the snapshot for readers
+    void publish() {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        publish_locked();
+    }
+
+    /// Delete snapshots which are not used by readers
+    void reclaim() {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        reclaim_locked();
+    }
+
+    /// Get count of old snapshots waiting for reclamation
+    size_t retired() {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        return retired_.size();
+    }
+
+  private:
+    void publish_locked() {
+        std::unique_ptr<const MatrixType> previous(current_.exchange(new MatrixType(draft_)));
+        // readers which enter the epoch after this one see only the new snapshot
+        retired_.push_back(Retired{epoch_.fetch_add(1), std::move(previous)});
+        reclaim_locked();
+    }
+};
+
+// ********************************
+// * Class SnapshotMatrix::Reader *
+// ********************************
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+class SnapshotMatrix<T, DefaultValue, Dimension, Options...>::Reader {
+    friend class SnapshotMatrix;
+
+    SnapshotMatrix *matrix_;
+    Slot *slot_;
+
+    Reader(SnapshotMatrix &matrix, Slot &slot) : matrix_(&matrix), slot_(&slot) {}
+
+  public:
+    Reader(Reader &&other) noexcept : matrix_(other.matrix_), slot_(other.slot_) {
+        other.slot_ = nullptr;
+    }
+    Reader &operator=(Reader &&other) noexcept {
+        std::swap(matrix_, other.matrix_);
+        std::swap(slot_, other.slot_);
+        return *this;
+    }
+    ~Reader() {
+        if (slot_ != nullptr) {
+            slot_->used.store(false);
+        }
+    }
+
+    /// Pin the current snapshot, it is not reclaimed while the Snapshot exists.
+    ///
+    /// Snapshots of the reader may be nested: the reader keeps the epoch of the first
+    /// of them until the last one is destroyed, so later snapshots are protected too.
+    Snapshot pin() const {
+        if (slot_->pins++ == 0) {
+            slot_->epoch.store(matrix_->epoch_.load());
+        }
+        return Snapshot(*slot_, matrix_->current_.load());
+    }
+
+    /// Get value of the element from the current snapshot
+    T get(const Indices &indices) const { return pin()->at(indices); }
+};
+
+// **********************************
+// * Class SnapshotMatrix::Snapshot *
+// **********************************
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+class SnapshotMatrix<T, DefaultValue, Dimension, Options...>::Snapshot {
+    friend class Reader;
+
+    Slot *slot_;
+    const MatrixType *matrix_;
+
+    Snapshot(Slot &slot, const MatrixType *matrix) : slot_(&slot), matrix_(matrix) {}
+
+  public:
+    Snapshot(Snapshot &&other) noexcept : slot_(other.slot_), matrix_(other.matrix_) {
+        other.slot_ = nullptr;
+    }
+    Snapshot &operator=(Snapshot &&) = delete;
+    ~Snapshot() {
+        if (slot_ != nullptr && --slot_->pins == 0) {
+            slot_->epoch.store(inactive);
+        }
+    }
+
+    const MatrixType &operator*() const noexcept { return *matrix_; }
+    const MatrixType *operator->() const noexcept { return matrix_; }
+
+    decltype(auto) operator[](size_t idx) const { return (*matrix_)[idx]; }
+};
+
+template <typename T, T DefaultValue, size_t Dimension, typename... Options>
+constexpr size_t SnapshotMatrix<T, DefaultValue, Dimension, Options...>::default_readers;
+
+} // namespace otus
+
+#endif // OTUS_SNAPSHOT_MATRIX_HPP
@@ -0,0 +1,241 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    stats.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: Counters of operations and statistics of storages of the matrix.
+//
+
+#ifndef OTUS_STATS_HPP
+#define OTUS_STATS_HPP
+
+#include <otus/policies.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace otus {
+
+/// Snapshot of counters of operations and of the layout of the storage of the matrix
+struct MatrixStats {
+    // Counters of operations since construction or reset_stats(), they stay zero
+    // without otus::CollectStats
+
+    size_t hits{0};     ///< reads of elements which are stored
+    size_t misses{0};   ///< reads of absent elements which give the default value
+    size_t inserts{0};  ///< new elements
+    size_t updates{0};  ///< changed values of stored elements
+    size_t erases{0};   ///< removed elements, e.g. by assignment of the default value
+    size_t rehashes{0}; ///< growths of the storage which moved elements
+
+    // Layout of the storage at the moment of the snapshot
+
+    size_t size{0};
+    size_t buckets{0}; ///< buckets, slots of the table (of tiles) or cells of the dense array
+    float load_factor{0.0f};
+    /// [n] is the count of elements which lookup visits n nodes or slots
+    std::vector<size_t> probe_lengths;
+    /// [n] is the count of buckets of otus::UnorderedStorage with n elements
+    std::vector<size_t> bucket_lengths;
+};
+
+/// Estimate of memory held by the matrix in bytes
+struct MemoryUsage {
+    size_t keys{0};     ///< stored keys (offsets of dense cells are not stored)
+    size_t values{0};   ///< stored values
+    size_t overhead{0}; ///< nodes, buckets, empty slots and cells, bitmaps and the index
+
+    size_t total() const noexcept { return keys + values + overhead; }
+};
+
+/// Do not count operations: the matrix has no counters and stats() has only the layout
+struct NoStats {
+    using option_category = detail::stats_option;
+
+    struct counters {
+        void found(bool) noexcept {}
+        template <typename Container>
+        size_t capacity(const Container &) const noexcept {
+            return 0;
+        }
+        template <typename Container>
+        void inserted(const Container &, size_t) noexcept {}
+        template <typename Container>
+        void resized(const Container &, size_t) noexcept {}
+        void updated() noexcept {}
+        void erased() noexcept {}
+        void reset() noexcept {}
+        void snapshot(MatrixStats &) const noexcept {}
+    };
+};
+
+/// Count reads, inserts, updates, erases and rehashes of the matrix
+///
+/// Counters are relaxed atomics, so concurrent readers of the const matrix may count
+/// too. Each counted operation costs an atomic increment. Counters are not copied or
+/// moved with the matrix.
+struct CollectStats {
+    using option_category = detail::stats_option;
+
+    class counters {
+        std::atomic<size_t> hits_{0};
+        std::atomic<size_t> misses_{0};
+        std::atomic<size_t> inserts_{0};
+        std::atomic<size_t> updates_{0};
+        std::atomic<size_t> erases_{0};
+        std::atomic<size_t> rehashes_{0};
+
+        static void increment(std::atomic<size_t> &counter) noexcept {
+            counter.fetch_add(1, std::memory_order_relaxed);
+        }
+        static size_t load(const std::atomic<size_t> &counter) noexcept {
+            return counter.load(std::memory_order_relaxed);
+        }
+
+      public:
+        void found(bool hit) noexcept { increment(hit ? hits_ : misses_); }
+
+        /// Get the capacity of the container to find out later if it grows
+        template <typename Container>
+        size_t capacity(const Container &container) const noexcept {
+            return detail::partition_count(container);
+        }
+        template <typename Container>
+        void inserted(const Container &container, size_t capacity) noexcept {
+            increment(inserts_);
+            resized(container, capacity);
+        }
+        template <typename Container>
+        void resized(const Container &container, size_t capacity) noexcept {
+            if (detail::partition_count(container) != capacity) {
+                increment(rehashes_);
+            }
+        }
+        void updated() noexcept { increment(updates_); }
+        void erased() noexcept { increment(erases_); }
+
+        void reset() noexcept {
+            for (auto *counter : {&hits_, &misses_, &inserts_, &updates_, &erases_, &rehashes_}) {
+                counter->store(0, std::memory_order_relaxed);
+            }
+        }
+
+        void snapshot(MatrixStats &stats) const noexcept {
+            stats.hits = load(hits_);
+            stats.misses = load(misses_);
+            stats.inserts = load(inserts_);
+            stats.updates = load(updates_);
+            stats.erases = load(erases_);
+            stats.rehashes = load(rehashes_);
+        }
+    };
+};
+
+namespace detail {
+
+inline void add_to_histogram(std::vector<size_t> &histogram, size_t bin, size_t count = 1) {
+    if (histogram.size() <= bin) {
+        histogram.resize(bin + 1);
+    }
+    histogram[bin] += count;
+}
+
+// Layouts of containers: lengths of chains of buckets or distances of elements from
+// their desired slots
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void collect_layout(const std::unordered_map<Key, Value, Hash, KeyEqual, Allocator> &container,
+                    MatrixStats &stats) {
+    for (size_t bucket = 0; bucket < container.bucket_count(); ++bucket) {
+        const size_t length = container.bucket_size(bucket);
+        add_to_histogram(stats.bucket_lengths, length);
+        for (size_t position = 1; position <= length; ++position) {
+            add_to_histogram(stats.probe_lengths, position);
+        }
+    }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void collect_layout(const FlatHashMap<Key, Value, Hash, KeyEqual, Allocator> &container,
+                    MatrixStats &stats) {
+    container.for_each_distance([&stats](size_t distance, const auto &) {
+        add_to_histogram(stats.probe_lengths, distance + 1);
+    });
+}
+
+template <typename Key, typename Value, size_t Extent, typename Hash, typename Allocator>
+void collect_layout(const TiledMap<Key, Value, Extent, Hash, Allocator> &container,
+                    MatrixStats &stats) {
+    container.for_each_tile_distance([&stats](size_t distance, size_t count) {
+        add_to_histogram(stats.probe_lengths, distance + 1, count);
+    });
+}
+
+template <typename Key, typename Value, size_t Size, typename Allocator>
+void collect_layout(const DenseArray<Key, Value, Size, Allocator> &container,
+                    MatrixStats &stats) {
+    if (!container.empty()) {
+        add_to_histogram(stats.probe_lengths, 1, container.size());
+    }
+}
+
+// Memory of containers: the estimate for nodes of std::unordered_map (the pointer to the
+// next node per element and the pointer per bucket) and allocated bytes of other ones
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+MemoryUsage
+memory_usage(const std::unordered_map<Key, Value, Hash, KeyEqual, Allocator> &container) {
+    using Element = std::pair<const Key, Value>;
+    constexpr size_t alignment = std::max(alignof(void *), alignof(Element));
+    constexpr size_t node =
+        (sizeof(void *) + sizeof(Element) + alignment - 1) / alignment * alignment;
+
+    MemoryUsage usage;
+    usage.keys = container.size() * sizeof(Key);
+    usage.values = container.size() * sizeof(Value);
+    usage.overhead = container.size() * (node - sizeof(Key) - sizeof(Value)) +
+                     container.bucket_count() * sizeof(void *);
+    return usage;
+}
+
+/// Split allocated bytes of the container into its keys, values and overhead
+inline MemoryUsage split_allocated(size_t allocated, size_t keys, size_t values) {
+    MemoryUsage usage;
+    usage.keys = keys;
+    usage.values = values;
+    usage.overhead = allocated - std::min(allocated, keys + values);
+    return usage;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+MemoryUsage memory_usage(const FlatHashMap<Key, Value, Hash, KeyEqual, Allocator> &container) {
+    return split_allocated(container.allocated_bytes(), container.size() * sizeof(Key),
+                           container.size() * sizeof(Value));
+}
+
+template <typename Key, typename Value, size_t Extent, typename Hash, typename Allocator>
+MemoryUsage memory_usage(const TiledMap<Key, Value, Extent, Hash, Allocator> &container) {
+    // keys of tiles are stored, cells are found by offsets in tiles
+    return split_allocated(container.allocated_bytes(), container.tile_count() * sizeof(Key),
+                           container.size() * sizeof(Value));
+}
+
+template <typename Key, typename Value, size_t Size, typename Allocator>
+MemoryUsage memory_usage(const DenseArray<Key, Value, Size, Allocator> &container) {
+    return split_allocated(container.allocated_bytes(), 0, container.size() * sizeof(Value));
+}
+
+} // namespace detail
+
+} // namespace otus
+
+#endif // OTUS_STATS_HPP
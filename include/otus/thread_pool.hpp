@@ -0,0 +1,144 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    thread_pool.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: The pool of threads for parallel algorithms of the matrix.
+//
+
+#ifndef OTUS_THREAD_POOL_HPP
+#define OTUS_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace otus {
+
+/// Class of the pool of threads which run parallel loops
+///
+/// The thread which calls parallel_for() also runs chunks of the loop while waiting,
+/// so the pool of N threads runs the loop in N + 1 threads and nested loops do not
+/// dead lock.
+class ThreadPool {
+    std::mutex mutex_;
+    std::condition_variable ready_; // new task or stop
+    std::condition_variable done_;  // some task is finished
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> workers_;
+    bool stop_{false};
+
+    /// Run one task from the queue, lock is released while the task runs
+    bool run_one(std::unique_lock<std::mutex> &lock) {
+        if (tasks_.empty()) {
+            return false;
+        }
+        auto task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+        return true;
+    }
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            ready_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            if (!run_one(lock)) {
+                return; // stopped and no tasks
+            }
+            done_.notify_all();
+        }
+    }
+
+  public:
+    /// Make pool of `threads` workers, the pool without workers runs loops in the caller
+    explicit ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency()) - 1) {
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        ready_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /// Get the pool shared by algorithms by default
+    static ThreadPool &shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    /// Get count of threads which run loops, including the caller
+    size_t concurrency() const noexcept { return workers_.size() + 1; }
+
+    /// Call `function(first, last)` for chunks of [0, count) in parallel and wait them.
+    /// The first exception thrown by the function is rethrown in the caller.
+    template <typename Function>
+    void parallel_for(size_t count, Function &&function) {
+        const size_t chunks = std::min(count, concurrency() * 4);
+        if (chunks <= 1 || workers_.empty()) {
+            if (count > 0) {
+                function(size_t{0}, count);
+            }
+            return;
+        }
+
+        size_t remaining = chunks;
+        std::exception_ptr error;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            const size_t first = count * chunk / chunks;
+            const size_t last = count * (chunk + 1) / chunks;
+            tasks_.emplace_back([this, &function, &remaining, &error, first, last] {
+                try {
+                    function(first, last);
+                } catch (...) {
+                    std::lock_guard<std::mutex> guard(mutex_);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+                std::lock_guard<std::mutex> guard(mutex_);
+                --remaining;
+            });
+        }
+        ready_.notify_all();
+
+        while (remaining > 0) {
+            if (!run_one(lock)) {
+                done_.wait(lock);
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+} // namespace otus
+
+#endif // OTUS_THREAD_POOL_HPP
@@ -0,0 +1,571 @@
+//
+//    +-+-+-+-+
+//    |O|T|U|S|
+//  +-+-+-+-+-+-+
+//  |M|A|T|R|I|X|
+//  +-+-+-+-+-+-+
+//
+// Filename:    tiled_map.hpp
+// Require:     C++14 Standard
+// Author:      Alexander Yashkin
+// Description: The map of coordinates grouped into dense or sparse tiles.
+//
+
+#ifndef OTUS_TILED_MAP_HPP
+#define OTUS_TILED_MAP_HPP
+
+#include <otus/bitmap.hpp>
+#include <otus/flat_hash_map.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace otus {
+
+namespace detail {
+
+/// Default extent of tiles on each axis, so the tile has 256 or 512 cells
+constexpr size_t default_tile_extent(size_t dimension) noexcept {
+    return dimension == 1 ? 256 : dimension == 2 ? 16 : dimension == 3 ? 8 : dimension == 4 ? 4 : 2;
+}
+
+/// Count of axes of the tuple key, zero for other keys
+template <typename Key>
+struct tuple_dimension : std::integral_constant<size_t, 0> {};
+
+template <typename... Types>
+struct tuple_dimension<std::tuple<Types...>> : std::integral_constant<size_t, sizeof...(Types)> {};
+
+} // namespace detail
+
+/// Map of coordinates grouped into tiles of Extent^Dimension cells
+///
+/// The hash table (otus::FlatHashMap) indexes tiles only. The sparse tile is the small list
+/// of cells sorted by offset in the tile, the dense tile is the array of values of all cells
+/// with the bitmap of occupied cells, so locally dense regions pay neither for the hash entry
+/// nor for the key of each element. The tile becomes dense when its list would take half of
+/// the memory of the array (long lists are slow to search) and sparse again when the list
+/// would take a quarter. Scattered elements are better kept by hash storages: every tile
+/// of one element holds the entry of the table.
+///
+/// Keys are tuples of coordinates (otus::TupleKeys). Iterators keep the key of the current
+/// element and give the value by the reference-like wrapper, so references to the key
+/// are valid while the iterator is. Insertion may invalidate iterators of the tile,
+/// erase through the iterator never skips or repeats elements.
+template <typename Key, typename Value, size_t Extent = 0, typename Hash = std::hash<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, Value>>>
+class TiledMap {
+    static constexpr size_t dimension = detail::tuple_dimension<Key>::value;
+    static_assert(dimension > 0, "Keys of the tiled map must be tuples (otus::TupleKeys)");
+
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher = Hash;
+    using allocator_type = Allocator;
+
+    /// Count of cells of the tile on each axis
+    static constexpr size_t extent = Extent != 0 ? Extent : detail::default_tile_extent(dimension);
+    static_assert((extent & (extent - 1)) == 0, "Extent of tiles must be a power of two");
+
+    /// Reference to the value which assigns through, iterators rebind it to other values
+    template <typename V>
+    class ValueReference {
+        friend class TiledMap;
+        V *value_;
+
+        void rebind(V *value) noexcept { value_ = value; }
+
+      public:
+        explicit ValueReference(V *value) noexcept : value_(value) {}
+        ValueReference(const ValueReference &) = default;
+
+        const ValueReference &operator=(const ValueReference &other) const {
+            *value_ = *other.value_;
+            return *this;
+        }
+        const ValueReference &operator=(const Value &value) const {
+            *value_ = value;
+            return *this;
+        }
+
+        operator V &() const noexcept { return *value_; } // NOLINT
+        V &get() const noexcept { return *value_; }
+
+        friend bool operator==(const ValueReference &lhs, const Value &rhs) {
+            return *lhs.value_ == rhs;
+        }
+        friend bool operator!=(const ValueReference &lhs, const Value &rhs) {
+            return !(lhs == rhs);
+        }
+    };
+
+    /// Element given by iterators
+    template <typename V>
+    struct Entry {
+        Key first;
+        ValueReference<V> second;
+    };
+
+  private:
+    template <typename V>
+    class TileIterator;
+
+    static constexpr size_t stride(size_t axis) noexcept {
+        return axis + 1 >= dimension ? 1 : extent * stride(axis + 1);
+    }
+    static constexpr size_t tile_size = extent * stride(0);
+    static constexpr size_t words = detail::bitmap_words(tile_size);
+    static_assert(tile_size <= std::numeric_limits<uint32_t>::max(), "Tiles are too big");
+
+    template <typename T>
+    using rebind_t = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+    struct Tile {
+        using Cell = std::pair<uint32_t, Value>; // offset in the tile and value
+
+        std::vector<Cell, rebind_t<Cell>> cells;               // sorted list of sparse tile
+        std::vector<Value, rebind_t<Value>> values;            // all cells of dense tile
+        std::vector<uint64_t, rebind_t<uint64_t>> occupied;    // bitmap of dense tile
+        size_t count{0};
+
+        explicit Tile(const Allocator &allocator)
+            : cells(allocator), values(allocator), occupied(allocator) {}
+        Tile(const Tile &other, const Allocator &allocator)
+            : cells(other.cells, allocator), values(other.values, allocator),
+              occupied(other.occupied, allocator), count(other.count) {}
+
+        bool dense() const noexcept { return !values.empty(); }
+    };
+
+    using Table = FlatHashMap<Key, Tile, Hash, std::equal_to<Key>, rebind_t<std::pair<Key, Tile>>>;
+
+    static constexpr size_t dense_bytes = tile_size * sizeof(Value) + words * sizeof(uint64_t);
+    static constexpr size_t to_dense = dense_bytes / sizeof(typename Tile::Cell) / 2;
+    static constexpr size_t to_sparse = to_dense / 2;
+
+    Table tiles_;
+    size_type size_{0};
+
+  public:
+    using value_type = Entry<Value>;
+    using iterator = TileIterator<Value>;
+    using const_iterator = TileIterator<const Value>;
+
+    TiledMap() = default;
+    explicit TiledMap(const allocator_type &allocator)
+        : tiles_(typename Table::allocator_type(allocator)) {}
+    TiledMap(const TiledMap &other, const allocator_type &allocator)
+        : tiles_(typename Table::allocator_type(allocator)), size_(other.size_) {
+        tiles_.max_load_factor(other.tiles_.max_load_factor());
+        tiles_.reserve(other.tiles_.size());
+        for (const auto &tile : other.tiles_) {
+            tiles_.try_emplace(tile.first, tile.second, get_allocator());
+        }
+    }
+
+    iterator begin() noexcept { return iterator(this, tiles_.begin()); }
+    const_iterator begin() const noexcept { return const_iterator(this, table().begin()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept { return iterator(this, tiles_.end()); }
+    const_iterator end() const noexcept { return const_iterator(this, table().end()); }
+    const_iterator cend() const noexcept { return end(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    iterator find(const key_type &key) {
+        auto tile = tiles_.find(tile_of(key));
+        const size_t position = tile != tiles_.end() ? locate(tile->second, offset_of(key)) : 0;
+        return position != npos && tile != tiles_.end() ? iterator(this, tile, position) : end();
+    }
+    const_iterator find(const key_type &key) const {
+        auto tile = table().find(tile_of(key));
+        const size_t position = tile != table().end() ? locate(tile->second, offset_of(key)) : 0;
+        return position != npos && tile != table().end() ? const_iterator(this, tile, position)
+                                                         : end();
+    }
+    size_type count(const key_type &key) const { return find(key) != end() ? 1 : 0; }
+
+    /// Load the slot of the tile of the key ahead of the following lookup of the key
+    void prefetch(const key_type &key) const { tiles_.prefetch(tile_of(key)); }
+
+    /// Insert a new element constructed from the arguments if the key does not exist
+    /// @return Iterator to the element with the key and true if insertion took place
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type &key, Args &&... args) {
+        auto tile = tiles_.try_emplace(tile_of(key), get_allocator()).first;
+        const size_t offset = offset_of(key);
+        size_t position = locate(tile->second, offset);
+        if (position != npos) {
+            return {iterator(this, tile, position), false};
+        }
+        try {
+            position = insert_cell(tile->second, offset, Value(std::forward<Args>(args)...));
+        } catch (...) {
+            if (tile->second.count == 0) {
+                tiles_.erase(tile); // tiles are never empty
+            }
+            throw;
+        }
+        ++size_;
+        return {iterator(this, tile, position), true};
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplace(K &&key, Args &&... args) {
+        return try_emplace(key, std::forward<Args>(args)...);
+    }
+
+    mapped_type &operator[](const key_type &key) { return try_emplace(key).first->second.get(); }
+
+    /// Remove the element, the tile without elements is removed too
+    /// @return Iterator to the element following the removed one
+    iterator erase(const_iterator position) {
+        auto tile = position.tile_;
+        Tile &cells = tile->second;
+        const size_t offset = offset_at(cells, position.position_);
+        if (cells.dense()) {
+            detail::reset_bit(cells.occupied.data(), offset);
+        } else {
+            cells.cells.erase(cells.cells.begin() + static_cast<ptrdiff_t>(position.position_));
+        }
+        --cells.count;
+        --size_;
+
+        if (cells.count == 0) {
+            return iterator(this, tiles_.erase(tile));
+        }
+        if (cells.dense() && cells.count < to_sparse) {
+            make_sparse(cells);
+        }
+        const size_t next =
+            cells.dense() ? next_occupied(cells, offset) : lower_bound(cells, offset);
+        if (next == end_position(cells)) {
+            return iterator(this, ++tile);
+        }
+        return iterator(this, tile, next);
+    }
+    iterator erase(iterator position) { return erase(const_iterator(position)); }
+
+    size_type erase(const key_type &key) {
+        auto position = find(key);
+        if (position == end()) {
+            return 0;
+        }
+        erase(position);
+        return 1;
+    }
+
+    void clear() noexcept {
+        tiles_.clear();
+        size_ = 0;
+    }
+
+    /// Reserve tiles for `count` elements which fill at least lines of tiles
+    void reserve(size_type count) { tiles_.reserve(count / extent + 1); }
+
+    /// Get count of buckets and count of slots (with overflow ones) of the table of tiles
+    size_type bucket_count() const noexcept { return tiles_.bucket_count(); }
+    size_type slot_count() const noexcept { return tiles_.slot_count(); }
+    /// Get count of tiles and count of dense tiles among them
+    size_type tile_count() const noexcept { return tiles_.size(); }
+    size_type dense_tile_count() const noexcept {
+        return static_cast<size_type>(std::count_if(
+            tiles_.begin(), tiles_.end(), [](const auto &tile) { return tile.second.dense(); }));
+    }
+
+    /// Get bytes of memory held by the table of tiles and by cells of tiles
+    size_type allocated_bytes() const noexcept {
+        size_type bytes = tiles_.allocated_bytes();
+        for (const auto &tile : tiles_) {
+            const Tile &cells = tile.second;
+            bytes += cells.cells.capacity() * sizeof(typename Tile::Cell) +
+                     cells.values.capacity() * sizeof(Value) +
+                     cells.occupied.capacity() * sizeof(uint64_t);
+        }
+        return bytes;
+    }
+
+    /// Call `function(distance, count)` for each tile with its distance from the desired
+    /// slot of the table of tiles and the count of elements in the tile
+    template <typename Function>
+    void for_each_tile_distance(Function &&function) const {
+        tiles_.for_each_distance([&function](size_type distance, const auto &tile) {
+            function(distance, tile.second.count);
+        });
+    }
+
+    /// Get average count of tiles per bucket
+    float load_factor() const noexcept { return tiles_.load_factor(); }
+    float max_load_factor() const noexcept { return tiles_.max_load_factor(); }
+    void max_load_factor(float factor) { tiles_.max_load_factor(factor); }
+
+    allocator_type get_allocator() const { return allocator_type(tiles_.get_allocator()); }
+
+    /// Call `function(element)` for elements of tiles in slots [first, last) of the table,
+    /// so threads may visit disjoint ranges of slots of the same map
+    template <typename Function>
+    void for_each_in_slots(size_type first, size_type last, Function &&function) const {
+        tiles_.for_each_in_slots(first, last, [&function](const auto &tile) {
+            const Tile &cells = tile.second;
+            for (size_t position = first_position(cells); position != end_position(cells);
+                 position = next_position(cells, position)) {
+                const Entry<const Value> entry{key_of(tile.first, offset_at(cells, position)),
+                                               ValueReference<const Value>(
+                                                   value_at(cells, position))};
+                function(entry);
+            }
+        });
+    }
+
+    friend bool operator==(const TiledMap &lhs, const TiledMap &rhs) {
+        if (lhs.size_ != rhs.size_) {
+            return false;
+        }
+        for (const auto &element : lhs) {
+            auto other = rhs.find(element.first);
+            if (other == rhs.end() || !(other->second.get() == element.second.get())) {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend bool operator!=(const TiledMap &lhs, const TiledMap &rhs) { return !(lhs == rhs); }
+
+  private:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    /// Iterators of const maps keep mutable iterators of the table, so they are erased
+    Table &table() const noexcept { return const_cast<Table &>(tiles_); }
+
+    template <size_t... I>
+    static Key tile_of(const Key &key, std::index_sequence<I...>) {
+        return Key((std::get<I>(key) / extent)...);
+    }
+    static Key tile_of(const Key &key) {
+        return tile_of(key, std::make_index_sequence<dimension>{});
+    }
+
+    /// Row-major offset of the cell in its tile
+    template <size_t... I>
+    static size_t offset_of(const Key &key, std::index_sequence<I...>) noexcept {
+        size_t offset = 0;
+        using swallow = int[];
+        (void)swallow{(offset = offset * extent + std::get<I>(key) % extent, 0)...};
+        return offset;
+    }
+    static size_t offset_of(const Key &key) noexcept {
+        return offset_of(key, std::make_index_sequence<dimension>{});
+    }
+
+    template <size_t... I>
+    static Key key_of(const Key &tile, size_t offset, std::index_sequence<I...>) {
+        return Key((std::get<I>(tile) * extent + offset / stride(I) % extent)...);
+    }
+    static Key key_of(const Key &tile, size_t offset) {
+        return key_of(tile, offset, std::make_index_sequence<dimension>{});
+    }
+
+    // Positions of cells in the tile: offsets in the dense tile or indices in the list
+
+    static size_t lower_bound(const Tile &tile, size_t offset) noexcept {
+        return static_cast<size_t>(
+            std::lower_bound(tile.cells.begin(), tile.cells.end(), offset,
+                             [](const auto &cell, size_t value) { return cell.first < value; }) -
+            tile.cells.begin());
+    }
+
+    /// Find the first occupied cell of the dense tile after the offset
+    static size_t next_occupied(const Tile &tile, size_t offset) noexcept {
+        return detail::find_set_bit(tile.occupied.data(), tile_size, offset + 1);
+    }
+
+    static size_t locate(const Tile &tile, size_t offset) noexcept {
+        if (tile.dense()) {
+            return detail::test_bit(tile.occupied.data(), offset) ? offset : npos;
+        }
+        const size_t position = lower_bound(tile, offset);
+        return position < tile.cells.size() && tile.cells[position].first == offset ? position
+                                                                                    : npos;
+    }
+
+    static size_t first_position(const Tile &tile) noexcept {
+        return tile.dense() ? detail::find_set_bit(tile.occupied.data(), tile_size, 0) : 0;
+    }
+    static size_t next_position(const Tile &tile, size_t position) noexcept {
+        return tile.dense() ? next_occupied(tile, position) : position + 1;
+    }
+    static size_t end_position(const Tile &tile) noexcept {
+        return tile.dense() ? tile_size : tile.cells.size();
+    }
+    static size_t offset_at(const Tile &tile, size_t position) noexcept {
+        return tile.dense() ? position : tile.cells[position].first;
+    }
+    template <typename TileType>
+    static auto value_at(TileType &tile, size_t position) noexcept {
+        return tile.dense() ? &tile.values[position] : &tile.cells[position].second;
+    }
+
+    /// Store the value of the absent cell
+    /// @return Position of the cell
+    size_t insert_cell(Tile &tile, size_t offset, Value &&value) {
+        if (!tile.dense() && tile.count + 1 > to_dense) {
+            make_dense(tile);
+        }
+        ++tile.count;
+        if (tile.dense()) {
+            tile.values[offset] = std::move(value);
+            detail::set_bit(tile.occupied.data(), offset);
+            return offset;
+        }
+        const size_t position = lower_bound(tile, offset);
+        tile.cells.emplace(tile.cells.begin() + static_cast<ptrdiff_t>(position),
+                           static_cast<uint32_t>(offset), std::move(value));
+        return position;
+    }
+
+    static void make_dense(Tile &tile) {
+        tile.values.resize(tile_size);
+        tile.occupied.assign(words, 0);
+        for (auto &cell : tile.cells) {
+            tile.values[cell.first] = std::move(cell.second);
+            detail::set_bit(tile.occupied.data(), cell.first);
+        }
+        tile.cells.clear();
+        tile.cells.shrink_to_fit();
+    }
+
+    static void make_sparse(Tile &tile) {
+        tile.cells.reserve(tile.count);
+        for (size_t offset = first_position(tile); offset != tile_size;
+             offset = next_occupied(tile, offset)) {
+            tile.cells.emplace_back(static_cast<uint32_t>(offset), std::move(tile.values[offset]));
+        }
+        tile.values.clear();
+        tile.values.shrink_to_fit();
+        tile.occupied.clear();
+        tile.occupied.shrink_to_fit();
+    }
+};
+
+// ********************************
+// * Class TiledMap::TileIterator *
+// ********************************
+template <typename Key, typename Value, size_t Extent, typename Hash, typename Allocator>
+template <typename V>
+class TiledMap<Key, Value, Extent, Hash, Allocator>::TileIterator {
+    friend class TiledMap;
+    template <typename OtherType>
+    friend class TileIterator;
+
+    using Map = std::conditional_t<std::is_const<V>::value, const TiledMap, TiledMap>;
+    using TableIterator = typename Table::iterator;
+
+    Map *map_{nullptr};
+    TableIterator tile_;
+    size_t position_{0};
+    Entry<V> entry_{Key{}, ValueReference<V>(nullptr)};
+
+    /// Make the entry of the current element
+    void load() {
+        if (map_ != nullptr && tile_ != map_->table().end()) {
+            entry_.first = key_of(tile_->first, offset_at(tile_->second, position_));
+            entry_.second.rebind(value_at(tile_->second, position_));
+        }
+    }
+
+  public:
+    // the entry is stashed in the iterator, so references to it are invalidated by the
+    // increment and iterators can not be forward ones
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Entry<V>;
+    using difference_type = ptrdiff_t;
+    using pointer = const Entry<V> *;
+    using reference = const Entry<V> &;
+
+    TileIterator() = default;
+    // the entry is made again: assignment of values references assigns values
+    TileIterator(const TileIterator &other)
+        : map_(other.map_), tile_(other.tile_), position_(other.position_) {
+        load();
+    }
+    TileIterator &operator=(const TileIterator &other) {
+        map_ = other.map_;
+        tile_ = other.tile_;
+        position_ = other.position_;
+        load();
+        return *this;
+    }
+    TileIterator(Map *map, TableIterator tile, size_t position)
+        : map_(map), tile_(tile), position_(position) {
+        load();
+    }
+    /// Iterator to the first element of the tile or to the end
+    TileIterator(Map *map, TableIterator tile)
+        : map_(map), tile_(tile),
+          position_(tile != map->table().end() ? first_position(tile->second) : 0) {
+        load();
+    }
+
+    /// Iterator is implicitly converted to const_iterator
+    template <typename OtherType,
+              typename = std::enable_if_t<std::is_same<const OtherType, V>::value &&
+                                          !std::is_same<OtherType, V>::value>>
+    TileIterator(const TileIterator<OtherType> &other) // NOLINT
+        : map_(other.map_), tile_(other.tile_), position_(other.position_) {
+        load();
+    }
+
+    reference operator*() const { return entry_; }
+    pointer operator->() const { return &entry_; }
+
+    TileIterator &operator++() {
+        position_ = next_position(tile_->second, position_);
+        if (position_ == end_position(tile_->second)) {
+            ++tile_;
+            position_ = tile_ != map_->table().end() ? first_position(tile_->second) : 0;
+        }
+        load();
+        return *this;
+    }
+    TileIterator operator++(int) {
+        TileIterator retval = *this;
+        ++(*this);
+        return retval;
+    }
+    template <typename OtherType>
+    bool operator==(const TileIterator<OtherType> &other) const {
+        return tile_ == other.tile_ && position_ == other.position_;
+    }
+    template <typename OtherType>
+    bool operator!=(const TileIterator<OtherType> &other) const {
+        return !(*this == other);
+    }
+};
+
+template <typename Key, typename Value, size_t Extent, typename Hash, typename Allocator>
+constexpr size_t TiledMap<Key, Value, Extent, Hash, Allocator>::extent;
+template <typename Key, typename Value, size_t Extent, typename Hash, typename Allocator>
+constexpr size_t TiledMap<Key, Value, Extent, Hash, Allocator>::tile_size;
+template <typename Key, typename Value, size_t Extent, typename Hash, typename Allocator>
+constexpr size_t TiledMap<Key, Value, Extent, Hash, Allocator>::to_dense;
+template <typename Key, typename Value, size_t Extent, typename Hash, typename Allocator>
+constexpr size_t TiledMap<Key, Value, Extent, Hash, Allocator>::to_sparse;
+template <typename Key, typename Value, size_t Extent, typename Hash, typename Allocator>
+constexpr size_t TiledMap<Key, Value, Extent, Hash, Allocator>::npos;
+
+} // namespace otus
+
+#endif // OTUS_TILED_MAP_HPP
@@ -0,0 +1,239 @@
+#include <catch2/catch.hpp>
+#include <otus/arena.hpp>
+#include <otus/compressed_matrix.hpp>
+#include <otus/compressed_tensor.hpp>
+#include <otus/expression.hpp>
+#include <otus/flat_hash_map.hpp>
+#include <otus/mapped_matrix.hpp>
+#include <otus/matrix.hpp>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+/// Allocator which counts live blocks and never propagates
+template <typename T>
+struct TrackingAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+
+    int *blocks;
+
+    explicit TrackingAllocator(int &counter) noexcept : blocks(&counter) {}
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U> &other) noexcept // NOLINT
+        : blocks(other.blocks) {}
+
+    T *allocate(size_t count) {
+        ++*blocks;
+        return std::allocator<T>().allocate(count);
+    }
+    void deallocate(T *pointer, size_t count) noexcept {
+        --*blocks;
+        std::allocator<T>().deallocate(pointer, count);
+    }
+
+    template <typename U>
+    bool operator==(const TrackingAllocator<U> &other) const noexcept {
+        return blocks == other.blocks;
+    }
+    template <typename U>
+    bool operator!=(const TrackingAllocator<U> &other) const noexcept {
+        return blocks != other.blocks;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Arena reuses freed blocks", "[arena]") {
+    otus::Arena arena(1024);
+    void *first = arena.allocate(24);
+    void *second = arena.allocate(24);
+    REQUIRE(first != second);
+    REQUIRE(arena.chunks() == 1);
+
+    arena.deallocate(first, 24);
+    REQUIRE(arena.allocate(20) == first); // the same size class
+
+    void *big = arena.allocate(10000);
+    REQUIRE(arena.chunks() == 2);
+    arena.deallocate(big, 10000);
+    REQUIRE(arena.chunks() == 1);
+    REQUIRE(arena.allocations() == 2);
+
+    arena.release();
+    REQUIRE(arena.chunks() == 0);
+    REQUIRE(arena.capacity() == 0);
+    REQUIRE_THROWS_AS(arena.allocate(8, alignof(std::max_align_t) * 2), std::bad_alloc);
+}
+
+TEMPLATE_TEST_CASE("Matrix allocates elements in the arena", "[matrix][arena]",
+                   otus::UnorderedStorage, otus::FlatStorage) {
+    using Allocator = otus::ArenaAllocator<char>;
+    using MatrixType = otus::Matrix<int, 0, 2, TestType, otus::StorageAllocator<Allocator>>;
+
+    otus::Arena arena, other_arena;
+    MatrixType matrix{Allocator(arena)};
+    for (size_t i = 0; i < 100; ++i) {
+        matrix[i][i * 2] = static_cast<int>(i) + 1;
+    }
+    REQUIRE(matrix.size() == 100);
+    REQUIRE(&matrix.get_allocator().arena() == &arena);
+    REQUIRE(arena.chunks() > 0);
+
+    SECTION("copies share the arena or take the given one") {
+        MatrixType copy = matrix;
+        REQUIRE(copy == matrix);
+        REQUIRE(&copy.get_allocator().arena() == &arena);
+
+        MatrixType other(matrix, Allocator(other_arena));
+        REQUIRE(other == matrix);
+        REQUIRE(&other.get_allocator().arena() == &other_arena);
+        REQUIRE(other_arena.chunks() > 0);
+    }
+
+    SECTION("assignment propagates the arena") {
+        MatrixType other{Allocator(other_arena)};
+        other[1][1] = 5;
+        other = matrix;
+        REQUIRE(other == matrix);
+        REQUIRE(&other.get_allocator().arena() == &arena);
+
+        MatrixType moved{Allocator(other_arena)};
+        moved = std::move(other);
+        REQUIRE(moved == matrix);
+        REQUIRE(&moved.get_allocator().arena() == &arena);
+    }
+
+    SECTION("cleared matrix reuses memory of the arena") {
+        const size_t capacity = arena.capacity();
+        matrix.clear();
+        REQUIRE(matrix.size() == 0);
+        for (size_t i = 0; i < 100; ++i) {
+            matrix[i][i * 3] = 7;
+        }
+        REQUIRE(matrix.size() == 100);
+        REQUIRE(arena.capacity() <= capacity);
+    }
+}
+
+TEST_CASE("Matrices made from other matrices allocate elements in the arena", "[matrix][arena]") {
+    using Allocator = otus::ArenaAllocator<char>;
+    using Storage = otus::StorageAllocator<Allocator>;
+    using MatrixType = otus::Matrix<int, 0, 2, Storage>;
+    using TensorType = otus::Matrix<int, 0, 3, otus::FlatStorage, Storage>;
+
+    otus::Arena arena, other_arena;
+    const MatrixType matrix({{{1, 2}, 3}, {{4, 5}, 6}, {{7, 1}, 8}}, Allocator(arena));
+    REQUIRE(&matrix.get_allocator().arena() == &arena);
+
+    SECTION("materialized view") {
+        const MatrixType copy = matrix.transpose().materialize();
+        REQUIRE(copy[2][1] == 3);
+        REQUIRE(&copy.get_allocator().arena() == &arena);
+    }
+
+    SECTION("thawed compressed matrix and tensor") {
+        const otus::CsrMatrix<int, 0> csr = matrix.freeze();
+        const auto thawed = csr.thaw<Storage>(Allocator(other_arena));
+        REQUIRE(thawed == matrix);
+        REQUIRE(&thawed.get_allocator().arena() == &other_arena);
+
+        TensorType tensor{Allocator(arena)};
+        tensor[1][2][3] = 4;
+        const otus::CsfTensor<int, 0, 3> csf = tensor.freeze();
+        const auto thawed_tensor = csf.thaw<otus::FlatStorage, Storage>(Allocator(other_arena));
+        REQUIRE(thawed_tensor == tensor);
+        REQUIRE(&thawed_tensor.get_allocator().arena() == &other_arena);
+    }
+
+    SECTION("evaluated expression") {
+        const MatrixType sum = 2 * matrix + matrix;
+        REQUIRE(sum[4][5] == 18);
+        REQUIRE(&sum.get_allocator().arena() == &arena);
+
+        const auto other = (matrix - matrix).evaluate<MatrixType>(Allocator(other_arena));
+        REQUIRE(other.size() == 0);
+        REQUIRE(&other.get_allocator().arena() == &other_arena);
+    }
+
+    SECTION("triplets and loaded file") {
+        const std::vector<std::tuple<size_t, size_t, int>> triplets{{1, 2, 3}, {4, 5, 6}};
+        const auto built = MatrixType::from_triplets(triplets.begin(), triplets.end(),
+                                                     otus::LastWins(), Allocator(other_arena));
+        REQUIRE(built.size() == 2);
+        REQUIRE(&built.get_allocator().arena() == &other_arena);
+
+        const std::string path = "otus_matrix_arena.bin";
+        otus::save(matrix, path);
+        const auto loaded = otus::load<MatrixType>(path, Allocator(other_arena));
+        std::remove(path.c_str());
+        REQUIRE(loaded == matrix);
+        REQUIRE(&loaded.get_allocator().arena() == &other_arena);
+    }
+}
+
+TEST_CASE("FlatHashMap does not propagate allocators which forbid it", "[flat][allocator]") {
+    using Map = otus::FlatHashMap<int, int, std::hash<int>, std::equal_to<int>,
+                                  TrackingAllocator<std::pair<int, int>>>;
+    int first_blocks = 0, second_blocks = 0;
+    {
+        Map first{TrackingAllocator<std::pair<int, int>>(first_blocks)};
+        Map second{TrackingAllocator<std::pair<int, int>>(second_blocks)};
+        for (int i = 0; i < 50; ++i) {
+            first[i] = i * i;
+        }
+        REQUIRE(first_blocks == 1);
+
+        second = first;
+        REQUIRE(second == first);
+        REQUIRE(second.get_allocator().blocks == &second_blocks);
+        REQUIRE(second_blocks == 1);
+
+        Map third{TrackingAllocator<std::pair<int, int>>(second_blocks)};
+        third = std::move(first); // elements are moved into the table of own allocator
+        REQUIRE(third == second);
+        REQUIRE(first.empty());
+        REQUIRE(first_blocks == 0);
+        REQUIRE(second_blocks == 2);
+
+        Map copy(third, TrackingAllocator<std::pair<int, int>>(first_blocks));
+        REQUIRE(copy == third);
+        REQUIRE(first_blocks == 1);
+    }
+    REQUIRE(first_blocks == 0);
+    REQUIRE(second_blocks == 0);
+}
+
+#if defined(OTUS_MATRIX_HAS_PMR)
+TEMPLATE_TEST_CASE("Matrix allocates elements from memory resource", "[matrix][pmr]",
+                   otus::UnorderedStorage, otus::FlatStorage, otus::TiledStorage<>) {
+    using MatrixType = otus::Matrix<int, 0, 2, TestType, otus::PmrAllocator>;
+
+    std::pmr::monotonic_buffer_resource resource;
+    MatrixType matrix{&resource};
+    for (size_t i = 0; i < 100; ++i) {
+        matrix[i][i] = static_cast<int>(i) + 1;
+    }
+    REQUIRE(matrix.get_allocator().resource() == &resource);
+
+    // memory resources are not propagated by assignment
+    MatrixType other;
+    other = matrix;
+    REQUIRE(other == matrix);
+    REQUIRE(other.get_allocator().resource() == std::pmr::get_default_resource());
+
+    MatrixType moved{&resource};
+    moved = std::move(other);
+    REQUIRE(moved == matrix);
+    REQUIRE(moved.get_allocator().resource() == &resource);
+}
+#endif
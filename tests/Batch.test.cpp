@@ -0,0 +1,80 @@
+#include <catch2/catch.hpp>
+#include <otus/matrix.hpp>
+#include <array>
+#include <list>
+#include <random>
+#include <tuple>
+#include <vector>
+
+TEMPLATE_TEST_CASE("Batched reads and writes match operator[]", "[matrix][batch]",
+                   otus::UnorderedStorage, otus::FlatStorage, otus::TiledStorage<>,
+                   (otus::Extents<300, 300>)) {
+    using MatrixType = otus::Matrix<int, -1, 2, TestType, otus::ExpectedDensity<50>>;
+    MatrixType matrix;
+    MatrixType reference;
+
+    // more indices than the prefetch window with repeated ones
+    std::mt19937_64 random{11};
+    std::vector<std::array<size_t, 2>> indices(1000);
+    std::vector<int> values(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        indices[i] = {{random() % 300, random() % 300}};
+        values[i] = static_cast<int>(random() % 5) - 1;
+    }
+
+    auto last = matrix.set_many(indices.begin(), indices.end(), values.begin());
+    REQUIRE(last == values.end());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        reference[indices[i][0]][indices[i][1]] = values[i];
+    }
+    REQUIRE(matrix == reference);
+    REQUIRE(matrix.size() < indices.size()); // the default value removes elements
+
+    SECTION("get_many reads stored and absent elements in order") {
+        std::vector<int> read;
+        matrix.get_many(indices.begin(), indices.end(), std::back_inserter(read));
+        REQUIRE(read.size() == indices.size());
+        for (size_t i = 0; i < indices.size(); ++i) {
+            REQUIRE(read[i] == reference[indices[i][0]][indices[i][1]]);
+        }
+        REQUIRE(read.back() == values.back());
+    }
+
+    SECTION("indices of tuples from input ranges and empty ranges") {
+        const std::list<std::tuple<int, int>> tuples{std::make_tuple(1, 2), std::make_tuple(2, 1)};
+        const std::vector<int> assigned{12, 21};
+        matrix.set_many(tuples.begin(), tuples.end(), assigned.begin());
+        std::array<int, 2> read{};
+        REQUIRE(matrix.get_many(tuples.begin(), tuples.end(), read.begin()) == read.end());
+        REQUIRE(read == std::array<int, 2>{{12, 21}});
+
+        REQUIRE(matrix.get_many(tuples.end(), tuples.end(), read.begin()) == read.begin());
+        const auto size = matrix.size();
+        matrix.set_many(indices.end(), indices.end(), values.end());
+        REQUIRE(matrix.size() == size);
+    }
+}
+
+TEST_CASE("Batched writes are recorded by the journal", "[matrix][batch][journal]") {
+    using MatrixType = otus::Matrix<int, 0, 2, otus::OrderedIndex>;
+    MatrixType matrix;
+    typename MatrixType::Journal journal;
+    matrix.attach(&journal);
+
+    const std::vector<std::array<size_t, 2>> indices{{{1, 2}}, {{1, 2}}, {{3, 4}}, {{1, 2}}};
+    const std::vector<int> values{5, 6, 0, 0};
+    matrix.set_many(indices.begin(), indices.end(), values.begin());
+    REQUIRE(matrix.size() == 0);
+    REQUIRE(matrix.begin() == matrix.end());
+
+    std::vector<std::tuple<otus::ChangeKind, int>> changes;
+    for (const auto &change : journal) {
+        changes.emplace_back(change.kind, change.value);
+    }
+    const std::vector<std::tuple<otus::ChangeKind, int>> expected = {
+        {otus::ChangeKind::insert, 5},
+        {otus::ChangeKind::update, 6},
+        {otus::ChangeKind::erase, 0},
+    };
+    REQUIRE(changes == expected);
+}
@@ -0,0 +1,77 @@
+// Bounds are checked in release builds too, so the test disables assertions
+#define NDEBUG
+
+#include <catch2/catch.hpp>
+#include <otus/matrix.hpp>
+#include <array>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+TEMPLATE_TEST_CASE("Every access out of extents throws", "[matrix][extents][bounds]",
+                   otus::DenseStorage<64 * 64>, otus::FlatStorage) {
+    using MatrixType = otus::Matrix<int, 0, 2, otus::Extents<64, 64>, TestType>;
+    MatrixType matrix;
+    matrix[63][63] = 1;
+    matrix[1][0] = 10;
+    const auto &const_matrix = matrix;
+
+    REQUIRE_THROWS_AS(matrix[64][0] = 2, std::out_of_range);
+    REQUIRE_THROWS_AS(matrix[0][64] = 2, std::out_of_range); // would alias [1][0]
+    REQUIRE_THROWS_AS(matrix(64, 63) = 2, std::out_of_range);
+    REQUIRE_THROWS_AS(matrix[0][64] += 2, std::out_of_range);
+    REQUIRE_THROWS_AS(static_cast<int>(const_matrix[0][64]), std::out_of_range);
+    REQUIRE_THROWS_AS(static_cast<int>(const_matrix(100000, 0)), std::out_of_range);
+    REQUIRE_THROWS_AS(matrix.erase({{0, 64}}), std::out_of_range);
+    REQUIRE_THROWS_AS(matrix.transpose()[64][0] = 2, std::out_of_range);
+
+    const std::vector<std::array<size_t, 2>> indices{{{2, 2}}, {{0, 64}}};
+    const std::vector<int> values{3, 4};
+    REQUIRE_THROWS_AS(matrix.set_many(indices.begin(), indices.end(), values.begin()),
+                      std::out_of_range);
+    std::vector<int> read(2);
+    REQUIRE_THROWS_AS(matrix.get_many(indices.begin(), indices.end(), read.begin()),
+                      std::out_of_range);
+
+    const std::vector<std::tuple<size_t, size_t, int>> triplets{{3, 3, 5}, {64, 64, 6}};
+    REQUIRE_THROWS_AS(matrix.insert_bulk(triplets.begin(), triplets.end()), std::out_of_range);
+    REQUIRE(matrix[3][3] == 5); // preceding elements are inserted
+
+    using Init = std::initializer_list<std::pair<const std::tuple<size_t, size_t>, int>>;
+    REQUIRE_THROWS_AS(MatrixType(Init{{{0, 0}, 1}, {{0, 64}, 2}}), std::out_of_range);
+
+    // nothing was written past the extents
+    REQUIRE(matrix.size() == 3);
+    REQUIRE(matrix[1][0] == 10);
+    REQUIRE(matrix[63][63] == 1);
+}
+
+TEST_CASE("Dense array does not hold offsets out of its cells", "[dense][bounds]") {
+    otus::DenseArray<uint64_t, int, 16> array;
+    array[15] = 1;
+    REQUIRE(array.find(16) == array.end());
+    REQUIRE(array.count(1000) == 0);
+    REQUIRE(array.erase(16) == 0);
+    REQUIRE(array.value_or(16, -1) == -1);
+    REQUIRE_THROWS_AS(array[16] = 2, std::out_of_range);
+    REQUIRE_THROWS_AS(array.try_emplace(16, 2), std::out_of_range);
+    REQUIRE(array.size() == 1);
+}
+
+TEST_CASE("Bulk insertion checks that indices fit into packed keys", "[matrix][packed][bounds]") {
+    using MatrixType = otus::Matrix<int, 0, 2, otus::PackedKeys<uint16_t>>;
+    MatrixType matrix;
+    matrix[0][1] = 1;
+
+    // [65536][0] would be packed into the key of [0][1]
+    const std::vector<std::tuple<size_t, size_t, int>> triplets{{2, 2, 5}, {65536, 0, 6}};
+    REQUIRE_THROWS_AS(matrix.insert_bulk(triplets.begin(), triplets.end()), std::out_of_range);
+    REQUIRE(matrix.size() == 2);
+    REQUIRE(matrix[0][1] == 1);
+    REQUIRE(matrix[2][2] == 5);
+
+    using Init = std::initializer_list<std::pair<const std::tuple<size_t, size_t>, int>>;
+    REQUIRE_THROWS_AS(MatrixType(Init{{{0, 1}, 1}, {{65536, 0}, 2}}), std::out_of_range);
+    REQUIRE_THROWS_AS(MatrixType::from_triplets(triplets.begin(), triplets.end()),
+                      std::out_of_range);
+}
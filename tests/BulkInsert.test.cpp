@@ -0,0 +1,67 @@
+#include <catch2/catch.hpp>
+#include <list>
+#include <otus/matrix.hpp>
+#include <tuple>
+#include <vector>
+
+TEMPLATE_TEST_CASE("Bulk insert into Matrix", "[matrix][bulk]", otus::UnorderedStorage,
+                   otus::FlatStorage, otus::TiledStorage<>) {
+    constexpr int DEFAULT_VALUE = 0;
+    using MatrixType = otus::Matrix<int, DEFAULT_VALUE, 2, TestType>;
+    using Triplet = std::tuple<size_t, size_t, int>;
+
+    const std::vector<Triplet> triplets{
+        Triplet{1, 2, 10}, Triplet{3, 4, 20}, Triplet{5, 6, DEFAULT_VALUE},
+        Triplet{1, 2, 5},  Triplet{7, 8, 30},
+    };
+
+    SECTION("Last value wins by default") {
+        auto matrix = MatrixType::from_triplets(triplets.begin(), triplets.end());
+        REQUIRE(matrix.size() == 3);
+        REQUIRE(matrix[1][2] == 5);
+        REQUIRE(matrix[3][4] == 20);
+        REQUIRE(matrix[7][8] == 30);
+    }
+
+    SECTION("First value wins") {
+        auto matrix =
+            MatrixType::from_triplets(triplets.begin(), triplets.end(), otus::FirstWins{});
+        REQUIRE(matrix.size() == 3);
+        REQUIRE(matrix[1][2] == 10);
+    }
+
+    SECTION("Sum of duplicates also with existing elements") {
+        MatrixType matrix{{std::make_tuple(3, 4), 1}};
+        matrix.insert_bulk(triplets.begin(), triplets.end(), otus::Sum{});
+        REQUIRE(matrix.size() == 3);
+        REQUIRE(matrix[1][2] == 15);
+        REQUIRE(matrix[3][4] == 21);
+    }
+
+    SECTION("Merged default value removes the element") {
+        MatrixType matrix{{std::make_tuple(1, 2), -15}};
+        matrix.insert_bulk(triplets.begin(), triplets.end(), otus::Sum{});
+        REQUIRE(matrix[1][2] == DEFAULT_VALUE);
+        REQUIRE(matrix.size() == 2);
+    }
+
+    SECTION("Insert from input range and from other matrix") {
+        std::list<Triplet> list(triplets.begin(), triplets.end());
+        MatrixType matrix;
+        matrix.insert_bulk(list.begin(), list.end());
+
+        MatrixType copy;
+        copy.insert_bulk(matrix.begin(), matrix.end());
+        REQUIRE(copy == matrix);
+    }
+
+    SECTION("Reserve and load factor") {
+        MatrixType matrix;
+        matrix.max_load_factor(0.5f);
+        REQUIRE(matrix.max_load_factor() == Approx(0.5f));
+        matrix.reserve(1000);
+        matrix.insert_bulk(triplets.begin(), triplets.end());
+        REQUIRE(matrix.load_factor() <= 0.5f);
+        REQUIRE(matrix.size() == 3);
+    }
+}
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <otus/compressed_matrix.hpp>
+#include <tuple>
+#include <vector>
+
+TEST_CASE("Compressed sparse matrix", "[matrix][compressed]") {
+    constexpr int DEFAULT_VALUE = -1;
+    using MatrixType = otus::Matrix<int, DEFAULT_VALUE>;
+
+    const MatrixType matrix{
+        {std::make_tuple(5, 1), 51},
+        {std::make_tuple(2, 7), 27},
+        {std::make_tuple(2, 3), 23},
+        {std::make_tuple(100, 0), 1000},
+        {std::make_tuple(2, 100), 2100},
+    };
+
+    SECTION("Freeze matrix in CSR format") {
+        const otus::CsrMatrix<int, DEFAULT_VALUE> csr = matrix.freeze();
+        REQUIRE(csr.size() == matrix.size());
+        REQUIRE(csr.line_count() == 3);
+        REQUIRE(csr[2][3] == 23);
+        REQUIRE(csr[2][7] == 27);
+        REQUIRE(csr[100][0] == 1000);
+        REQUIRE(csr[2][4] == DEFAULT_VALUE);
+        REQUIRE(csr[3][3] == DEFAULT_VALUE);
+        REQUIRE(csr.get(1000, 1000) == DEFAULT_VALUE);
+    }
+
+    SECTION("Row of CSR matrix is sorted") {
+        const otus::CsrMatrix<int, DEFAULT_VALUE> csr(matrix);
+        const auto row = csr.row(2);
+        REQUIRE(row.index() == 2);
+        REQUIRE(row.size() == 3);
+
+        std::vector<std::pair<size_t, int>> elements;
+        for (const auto element : row) {
+            elements.emplace_back(element.first, element.second);
+        }
+        REQUIRE(elements == std::vector<std::pair<size_t, int>>{{3, 23}, {7, 27}, {100, 2100}});
+        REQUIRE(row.indices()[1] == 7);
+        REQUIRE(row.values()[1] == 27);
+
+        REQUIRE(csr.row(3).empty());
+        REQUIRE(csr.row(3).begin() == csr.row(3).end());
+    }
+
+    SECTION("Column of CSC matrix is sorted") {
+        const otus::CscMatrix<int, DEFAULT_VALUE> csc(matrix);
+        REQUIRE(csc.line_count() == 5);
+        REQUIRE(csc[5][1] == 51);
+        REQUIRE(csc[1][5] == DEFAULT_VALUE);
+
+        const auto column = csc.column(0);
+        REQUIRE(column.size() == 1);
+        REQUIRE((*column.begin()).first == 100);
+        REQUIRE((*column.begin()).second == 1000);
+    }
+
+    SECTION("Iterate over all elements in storage order") {
+        const otus::CsrMatrix<int, DEFAULT_VALUE> csr(matrix);
+        std::vector<std::tuple<size_t, size_t, int>> elements;
+        for (const auto element : csr) {
+            size_t x, y;
+            int v;
+            std::tie(x, y, v) = element;
+            REQUIRE(matrix[x][y] == v);
+            elements.emplace_back(x, y, v);
+        }
+        REQUIRE(elements.size() == matrix.size());
+        REQUIRE(std::is_sorted(elements.begin(), elements.end()));
+
+        const otus::CscMatrix<int, DEFAULT_VALUE> csc(matrix);
+        REQUIRE(std::get<0>(*csc.begin()) == 100);
+        REQUIRE(std::get<1>(*csc.begin()) == 0);
+    }
+
+    SECTION("Thaw the frozen matrix") {
+        const auto csr = matrix.freeze();
+        REQUIRE(csr.thaw() == matrix);
+        REQUIRE(otus::CscMatrix<int, DEFAULT_VALUE>(matrix).thaw<otus::FlatStorage>().size() ==
+                matrix.size());
+        REQUIRE(otus::CsrMatrix<int, DEFAULT_VALUE>(csr.thaw()) == csr);
+    }
+
+    SECTION("Empty matrix") {
+        const otus::CsrMatrix<int, DEFAULT_VALUE> csr(MatrixType{});
+        REQUIRE(csr.size() == 0);
+        REQUIRE(csr.line_count() == 0);
+        REQUIRE(csr.begin() == csr.end());
+        REQUIRE(csr[0][0] == DEFAULT_VALUE);
+        REQUIRE(csr == otus::CsrMatrix<int, DEFAULT_VALUE>{});
+    }
+}
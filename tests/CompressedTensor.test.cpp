@@ -0,0 +1,99 @@
+#include <catch2/catch.hpp>
+#include <otus/compressed_tensor.hpp>
+#include <tuple>
+#include <vector>
+
+TEST_CASE("Compressed sparse fiber tensor", "[matrix][compressed]") {
+    constexpr long DEFAULT_VALUE = 1;
+    using MatrixType = otus::Matrix<long, DEFAULT_VALUE, 3>;
+
+    const MatrixType matrix{
+        {std::make_tuple(7, 1, 1), 711},
+        {std::make_tuple(2, 5, 3), 253},
+        {std::make_tuple(2, 5, 0), 250},
+        {std::make_tuple(2, 0, 9), 209},
+        {std::make_tuple(0, 0, 0), 0},
+    };
+
+    SECTION("Freeze matrix in CSF format") {
+        const otus::CsfTensor<long, DEFAULT_VALUE, 3> tensor = matrix.freeze();
+        REQUIRE(tensor.size() == matrix.size());
+        REQUIRE(tensor.nodes(0) == 3);
+        REQUIRE(tensor.nodes(1) == 4);
+        REQUIRE(tensor.nodes(2) == 5);
+
+        REQUIRE(tensor[2][5][3] == 253);
+        REQUIRE(tensor[0][0][0] == 0);
+        REQUIRE(tensor.get({7, 1, 1}) == 711);
+        REQUIRE(tensor[2][5][1] == DEFAULT_VALUE);
+        REQUIRE(tensor[2][1][0] == DEFAULT_VALUE);
+        REQUIRE(tensor[3][5][3] == DEFAULT_VALUE);
+        REQUIRE(tensor.get({100, 100, 100}) == DEFAULT_VALUE);
+    }
+
+    SECTION("Slices by partial indices") {
+        const auto tensor = matrix.freeze();
+        REQUIRE(tensor[2].size() == 3);
+        REQUIRE(tensor[2][5].size() == 2);
+        REQUIRE(tensor[3].empty());
+        REQUIRE(tensor[3][5].empty());
+        REQUIRE(tensor[3][5].begin() == tensor[3][5].end());
+
+        std::vector<std::tuple<size_t, size_t, size_t, long>> elements;
+        for (const auto element : tensor[2]) {
+            elements.emplace_back(element);
+        }
+        REQUIRE(elements == std::vector<std::tuple<size_t, size_t, size_t, long>>{
+                                {2, 0, 9, 209}, {2, 5, 0, 250}, {2, 5, 3, 253}});
+
+        elements.clear();
+        for (const auto element : tensor[2][5]) {
+            elements.emplace_back(element);
+        }
+        REQUIRE(elements.size() == 2);
+        REQUIRE(std::get<3>(elements.front()) == 250);
+    }
+
+    SECTION("Iterate over all elements and thaw") {
+        const auto tensor = matrix.freeze();
+        size_t count = 0;
+        for (const auto element : tensor) {
+            size_t x, y, z;
+            long v;
+            std::tie(x, y, z, v) = element;
+            REQUIRE(matrix[x][y][z] == v);
+            ++count;
+        }
+        REQUIRE(count == matrix.size());
+        REQUIRE(tensor.thaw() == matrix);
+        const auto flat = tensor.thaw<otus::FlatStorage>();
+        REQUIRE(otus::CsfTensor<long, DEFAULT_VALUE, 3>(flat) == tensor);
+    }
+
+    SECTION("One and four dimension tensors") {
+        const otus::Matrix<int, 0, 1> vector{{std::make_tuple(5), 1}, {std::make_tuple(3), 2}};
+        const auto frozen_vector = vector.freeze();
+        REQUIRE(frozen_vector[5] == 1);
+        REQUIRE(frozen_vector[4] == 0);
+        REQUIRE(std::get<0>(*frozen_vector.begin()) == 3);
+
+        otus::Matrix<int, 0, 4> matrix4d;
+        matrix4d[1][2][3][4] = 1;
+        matrix4d[1][2][4][0] = 2;
+        matrix4d[1][3][0][0] = 3;
+        const auto tensor = matrix4d.freeze();
+        REQUIRE(tensor[1][2][4][0] == 2);
+        REQUIRE(tensor[1][2].size() == 2);
+        REQUIRE(tensor[1].size() == 3);
+        REQUIRE(tensor.thaw() == matrix4d);
+    }
+
+    SECTION("Empty tensor") {
+        const otus::CsfTensor<long, DEFAULT_VALUE, 3> tensor(MatrixType{});
+        REQUIRE(tensor.size() == 0);
+        REQUIRE(tensor.begin() == tensor.end());
+        REQUIRE(tensor[0][0][0] == DEFAULT_VALUE);
+        REQUIRE(tensor[0].empty());
+        REQUIRE(tensor == otus::CsfTensor<long, DEFAULT_VALUE, 3>{});
+    }
+}
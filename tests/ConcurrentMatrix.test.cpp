@@ -0,0 +1,59 @@
+#include <catch2/catch.hpp>
+#include <otus/concurrent_matrix.hpp>
+#include <thread>
+#include <vector>
+
+TEMPLATE_TEST_CASE("Concurrent Matrix operations", "[matrix][concurrent]",
+                   otus::UnorderedStorage, otus::FlatStorage) {
+    constexpr int DEFAULT_VALUE = 0;
+    otus::ConcurrentMatrix<int, DEFAULT_VALUE, 2, TestType> matrix(10);
+    REQUIRE(matrix.shards() == 16);
+    REQUIRE(matrix.size() == 0);
+
+    SECTION("Get, set, update and erase from one thread") {
+        matrix.set({1, 2}, 12);
+        REQUIRE(matrix.get({1, 2}) == 12);
+        REQUIRE(matrix.get({2, 1}) == DEFAULT_VALUE);
+        REQUIRE(matrix.update({1, 2}, [](int value) { return value + 1; }) == 13);
+        REQUIRE(matrix.size() == 1);
+
+        matrix.set({1, 2}, DEFAULT_VALUE);
+        REQUIRE(matrix.size() == 0);
+
+        matrix.set({3, 4}, 34);
+        REQUIRE(matrix.erase({3, 4}) == 1);
+        REQUIRE(matrix.erase({3, 4}) == 0);
+        REQUIRE(matrix.size() == 0);
+    }
+
+    SECTION("Updates from many threads are not lost") {
+        constexpr size_t threads = 8;
+        constexpr size_t cells = 64;
+        constexpr int rounds = 200;
+
+        std::vector<std::thread> workers;
+        for (size_t thread = 0; thread < threads; ++thread) {
+            workers.emplace_back([&matrix, thread] {
+                for (int round = 0; round < rounds; ++round) {
+                    for (size_t cell = 0; cell < cells; ++cell) {
+                        matrix.update({cell, cell * 3}, [](int value) { return value + 1; });
+                        matrix.set({cells + thread, cell}, round + 1);
+                        (void)matrix.get({cell, 0});
+                    }
+                }
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+
+        REQUIRE(matrix.size() == cells + threads * cells);
+        for (size_t cell = 0; cell < cells; ++cell) {
+            REQUIRE(matrix.get({cell, cell * 3}) == static_cast<int>(threads) * rounds);
+            REQUIRE(matrix.get({cells, cell}) == rounds);
+        }
+
+        matrix.clear();
+        REQUIRE(matrix.size() == 0);
+    }
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch.hpp>
 #include <otus/matrix.hpp>
+#include <type_traits>
 
 TEST_CASE("Const two dismension Matrix operations", "[matrix][2D][const]") {
     constexpr long DEFAULT_VALUE = 1;
@@ -32,6 +33,14 @@ TEST_CASE("Const two dismension Matrix operations", "[matrix][2D][const]") {
         REQUIRE(const_matrix.size() == start_size);
     }
 
+    SECTION("Elements of const matrix are read only") {
+        using ConstElement = decltype(const_matrix[1][2]);
+        using Element = decltype(matrix[1][2]);
+        REQUIRE_FALSE(std::is_assignable<ConstElement, long>::value);
+        REQUIRE_FALSE(std::is_assignable<decltype(const_matrix(1, 2)), long>::value);
+        REQUIRE(std::is_assignable<Element, long>::value);
+    }
+
     SECTION("use for each loop with const matrix") {
         size_t counter = 0;
         for (const auto element : matrix) {
@@ -0,0 +1,122 @@
+#include <catch2/catch.hpp>
+#include <otus/matrix.hpp>
+#include <stdexcept>
+#include <type_traits>
+
+TEST_CASE("Element-wise operations with matrices", "[matrix][expression]") {
+    otus::Matrix<int, 0> a, b;
+    a[0][0] = 1;
+    a[1][2] = 4;
+    a[3][3] = -2;
+    b[1][2] = -4;
+    b[2][2] = 5;
+    b[3][3] = 3;
+
+    SECTION("sum and difference") {
+        otus::Matrix<int, 0> sum = a + b;
+        REQUIRE(sum.size() == 3); // (1, 2) is zero
+        REQUIRE(sum[0][0] == 1);
+        REQUIRE(sum[1][2] == 0);
+        REQUIRE(sum[2][2] == 5);
+        REQUIRE(sum[3][3] == 1);
+
+        otus::Matrix<int, 0> difference = a - b;
+        REQUIRE(difference.size() == 4);
+        REQUIRE(difference[1][2] == 8);
+        REQUIRE(difference[2][2] == -5);
+        REQUIRE(difference[3][3] == -5);
+    }
+
+    SECTION("Hadamard product") {
+        otus::Matrix<int, 0> product = otus::hadamard(a, b);
+        REQUIRE(product.size() == 2);
+        REQUIRE(product[1][2] == -16);
+        REQUIRE(product[3][3] == -6);
+    }
+
+    SECTION("scalar operations and nested expressions") {
+        otus::Matrix<int, 0> c = a + b * 2;
+        REQUIRE(c.size() == 4);
+        REQUIRE(c[0][0] == 1);
+        REQUIRE(c[1][2] == -4);
+        REQUIRE(c[2][2] == 10);
+        REQUIRE(c[3][3] == 4);
+
+        c = -(c - a) / 2;
+        REQUIRE(c.size() == 3);
+        REQUIRE(c[1][2] == 4);
+        REQUIRE(c[2][2] == -5);
+        REQUIRE(c[3][3] == -3);
+
+        c = 3 * otus::hadamard(a, a) - a;
+        REQUIRE(c.size() == 3);
+        REQUIRE(c[0][0] == 2);
+        REQUIRE(c[1][2] == 44);
+        REQUIRE(c[3][3] == 14);
+    }
+
+    SECTION("operand is the result") {
+        a = a + b + a;
+        REQUIRE(a.size() == 4);
+        REQUIRE(a[0][0] == 2);
+        REQUIRE(a[1][2] == 4);
+        REQUIRE(a[2][2] == 5);
+        REQUIRE(a[3][3] == -1);
+    }
+
+    SECTION("operations with not sparse result") {
+        using Result = otus::Matrix<int, 0>;
+        REQUIRE_THROWS_AS(Result(a + 1), std::domain_error);
+
+        otus::Matrix<int, 1> shifted = a + 1;
+        REQUIRE(shifted.size() == 3);
+        REQUIRE(shifted[0][0] == 2);
+        REQUIRE(shifted[1][2] == 5);
+        REQUIRE(shifted[3][3] == -1);
+    }
+
+    SECTION("operands are not modified") {
+        otus::Matrix<int, 0> copy = a;
+        otus::Matrix<int, 0> c = a * 3 + b;
+        REQUIRE(copy == a);
+        REQUIRE(c.size() == 4);
+    }
+}
+
+TEST_CASE("Element-wise operations respect DefaultValue", "[matrix][expression]") {
+    otus::Matrix<long, 1, 3> a, b;
+    a[0][0][0] = 2;
+    a[1][1][1] = 3;
+    b[0][0][0] = 0;
+    b[1][1][1] = 5;
+    b[2][0][1] = 0;
+
+    otus::Matrix<long, 1, 3> product = otus::hadamard(a, b);
+    REQUIRE(product.size() == 3);
+    REQUIRE(product[0][0][0] == 0);
+    REQUIRE(product[1][1][1] == 15);
+    REQUIRE(product[2][0][1] == 0);
+
+    // (0, 0, 0) gets 2 + 0 - 1 which is default and is dropped
+    otus::Matrix<long, 1, 3> sum = a + b - 1;
+    REQUIRE(sum.size() == 2);
+    REQUIRE(sum[1][1][1] == 7);
+    REQUIRE(sum[2][0][1] == 0);
+
+    using Result = otus::Matrix<long, 1, 3>;
+    REQUIRE_THROWS_AS(Result(a + b), std::domain_error);
+
+    // the result may have other DefaultValue and options than operands
+    otus::Matrix<long, 2, 3, otus::FlatStorage> shifted = a + b;
+    REQUIRE(shifted.size() == 2);
+    REQUIRE(shifted[1][1][1] == 8);
+    REQUIRE(shifted[2][0][1] == 1);
+    REQUIRE(shifted[5][5][5] == 2);
+}
+
+TEST_CASE("Operators are only for matrices and scalars", "[matrix][expression]") {
+    using MatrixType = otus::Matrix<int, 0>;
+    using Sum = decltype(std::declval<MatrixType>() + std::declval<MatrixType>());
+    REQUIRE(std::is_convertible<Sum, MatrixType>::value);
+    REQUIRE_FALSE(std::is_convertible<Sum, otus::Matrix<int, 0, 3>>::value);
+}
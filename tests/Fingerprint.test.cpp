@@ -0,0 +1,150 @@
+#include <catch2/catch.hpp>
+#include <otus/matrix.hpp>
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+TEMPLATE_TEST_CASE("Tracked fingerprint follows every change", "[matrix][fingerprint]",
+                   otus::UnorderedStorage, otus::FlatStorage, otus::TiledStorage<>,
+                   (otus::Extents<64, 64>)) {
+    using Tracked = otus::Matrix<int, 0, 2, TestType, otus::TrackFingerprint>;
+    using Plain = otus::Matrix<int, 0, 2, otus::PackedKeys<uint32_t>>;
+    Tracked matrix;
+    const auto empty = matrix.fingerprint();
+
+    // the fingerprint of the tracked matrix is the same as the one computed by the walk
+    // over elements of the matrix with other policies
+    const auto check = [&matrix] {
+        Plain plain;
+        for (const auto element : matrix) {
+            plain[std::get<0>(element)][std::get<1>(element)] = std::get<2>(element);
+        }
+        REQUIRE(matrix.fingerprint() == plain.fingerprint());
+    };
+
+    matrix[1][2] = 5;
+    matrix[1][2] = 6;
+    matrix[3][4] += 2;
+    matrix[3][4] *= 3;
+    matrix[5][6] = 7;
+    matrix[7][8] -= 1;
+    matrix[7][8] += 1; // removed by the default value
+    check();
+    REQUIRE(matrix.erase({{5, 6}}) == 1);
+    check();
+
+    const std::vector<std::tuple<size_t, size_t, int>> triplets{
+        {1, 2, 1}, {9, 9, 9}, {3, 4, -6}, {10, 10, 1}};
+    matrix.insert_bulk(triplets.begin(), triplets.end(), otus::Sum{});
+    check();
+
+    for (auto element : matrix.mutable_elements()) {
+        int &value = std::get<2>(element);
+        value = value == 9 ? 0 : value * 2;
+    }
+    check();
+
+    const std::vector<std::array<size_t, 2>> indices{{{20, 20}}, {{1, 2}}, {{10, 10}}};
+    const std::vector<int> values{4, 0, 3};
+    matrix.set_many(indices.begin(), indices.end(), values.begin());
+    check();
+    REQUIRE(matrix.fingerprint() != empty);
+
+    SECTION("copies and moves keep the fingerprint") {
+        Tracked copy = matrix;
+        REQUIRE(copy.fingerprint() == matrix.fingerprint());
+        Tracked moved = std::move(copy);
+        REQUIRE(moved.fingerprint() == matrix.fingerprint());
+        REQUIRE(copy.fingerprint() == empty); // NOLINT: moved-from matrix is empty
+
+        copy = moved;
+        REQUIRE(copy == matrix);
+        copy[0][0] = 1;
+        REQUIRE(copy != matrix);
+        copy = std::move(moved);
+        REQUIRE(copy == matrix);
+    }
+
+    SECTION("clear resets the fingerprint") {
+        matrix.clear();
+        REQUIRE(matrix.fingerprint() == empty);
+    }
+}
+
+TEST_CASE("Fingerprint does not depend on the order of elements", "[matrix][fingerprint]") {
+    std::vector<std::tuple<size_t, size_t, size_t, long>> elements;
+    std::mt19937_64 random{3};
+    for (int i = 0; i < 500; ++i) {
+        elements.emplace_back(random() % 50, random() % 50, random() % 50, random() % 100 + 1);
+    }
+    otus::Matrix<long, 0, 3, otus::TrackFingerprint> lhs;
+    otus::Matrix<long, 0, 3, otus::TrackFingerprint> rhs;
+    lhs.insert_bulk(elements.begin(), elements.end());
+    std::reverse(elements.begin(), elements.end());
+    rhs.insert_bulk(elements.begin(), elements.end(), otus::FirstWins{});
+    REQUIRE(lhs == rhs);
+    REQUIRE(lhs.fingerprint() == rhs.fingerprint());
+
+    // swapped indices or values are other elements
+    otus::Matrix<long, 0, 3> swapped;
+    swapped[1][2][3] = 4;
+    swapped[3][2][1] = 5;
+    otus::Matrix<long, 0, 3> other;
+    other[1][2][3] = 5;
+    other[3][2][1] = 4;
+    REQUIRE(swapped.fingerprint() != other.fingerprint());
+}
+
+TEMPLATE_TEST_CASE("Diff of matrices replays one onto the other", "[matrix][fingerprint][diff]",
+                   otus::UnorderedStorage, otus::FlatStorage) {
+    using MatrixType = otus::Matrix<int, 0, 2, TestType>;
+    otus::ThreadPool pool(3);
+    const size_t count = GENERATE(as<size_t>{}, 100, 40000); // below and above the threshold
+
+    std::mt19937_64 random{count};
+    MatrixType from;
+    MatrixType to;
+    for (size_t i = 0; i < count; ++i) {
+        const size_t row = random() % 1000, column = random() % 1000;
+        const int value = static_cast<int>(random() % 4);
+        from[row][column] = value;
+        to[row][column] = random() % 2 == 0 ? value : static_cast<int>(random() % 4);
+        to[random() % 1000][random() % 1000] = static_cast<int>(random() % 4);
+    }
+
+    const auto journal = otus::diff(from, to, pool);
+    size_t inserted = 0, updated = 0, erased = 0;
+    for (const auto &change : journal) {
+        const int before = from.at(change.indices);
+        const int after = to.at(change.indices);
+        REQUIRE(before != after);
+        switch (change.kind) {
+        case otus::ChangeKind::insert:
+            ++inserted;
+            REQUIRE(before == 0);
+            break;
+        case otus::ChangeKind::update:
+            ++updated;
+            REQUIRE(before != 0);
+            REQUIRE(after != 0);
+            break;
+        case otus::ChangeKind::erase:
+            ++erased;
+            REQUIRE(after == 0);
+            break;
+        case otus::ChangeKind::clear:
+            FAIL("diff does not clear");
+        }
+        REQUIRE(change.value == after);
+    }
+    REQUIRE(inserted + updated + erased == journal.size());
+    REQUIRE(inserted > 0);
+    REQUIRE(updated > 0);
+    REQUIRE(erased > 0);
+    REQUIRE(from.size() + inserted - erased == to.size());
+
+    journal.replay(from);
+    REQUIRE(from == to);
+    REQUIRE(otus::diff(from, to).empty());
+}
@@ -0,0 +1,179 @@
+#include <catch2/catch.hpp>
+#include <otus/dense_array.hpp>
+#include <otus/matrix.hpp>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("Extents compute row-major offsets at compile time", "[extents]") {
+    using Extents = otus::Extents<4, 5, 6>;
+    static_assert(Extents::dimension == 3, "");
+    static_assert(Extents::size == 120, "");
+    static_assert(Extents::stride(0) == 30 && Extents::stride(1) == 6 && Extents::stride(2) == 1,
+                  "");
+
+    using Codec = Extents::codec<3>;
+    const auto key = Codec::encode(std::make_tuple(3, 4, 5));
+    REQUIRE(key == 119);
+    REQUIRE(Codec::get<0>(key) == 3);
+    REQUIRE(Codec::get<1>(key) == 4);
+    REQUIRE(Codec::get<2>(key) == 5);
+    REQUIRE(Codec::contains({{3, 4, 5}}));
+    REQUIRE_FALSE(Codec::contains({{3, 5, 0}}));
+}
+
+TEST_CASE("Small fixed matrix is the dense array", "[matrix][extents]") {
+    otus::FixedMatrix<int, -1, otus::Extents<64, 64>> matrix;
+    REQUIRE(matrix.max_load_factor() == 1.0f); // the dense array never grows
+    matrix[3][4] = 34;
+    matrix[63][0] = 630;
+    matrix(0, 63) = 63;
+    REQUIRE(matrix.size() == 3);
+    REQUIRE(matrix[3][4] == 34);
+    REQUIRE(matrix[4][3] == -1);
+    REQUIRE(matrix.load_factor() == Approx(3.0 / 4096));
+
+    SECTION("elements are visited in row-major order") {
+        std::vector<std::tuple<size_t, size_t, int>> elements(matrix.begin(), matrix.end());
+        REQUIRE(elements == std::vector<std::tuple<size_t, size_t, int>>{
+                                {0, 63, 63}, {3, 4, 34}, {63, 0, 630}});
+    }
+
+    SECTION("default value removes the element") {
+        matrix[3][4] = -1;
+        REQUIRE(matrix.size() == 2);
+        REQUIRE(matrix.erase({{63, 0}}) == 1);
+        REQUIRE(matrix.erase({{63, 0}}) == 0);
+        REQUIRE(matrix.size() == 1);
+        matrix[0][63] += 1;
+        REQUIRE(matrix[0][63] == 64);
+    }
+
+    SECTION("copies, moves and comparison") {
+        auto copy = matrix;
+        REQUIRE(copy == matrix);
+        copy[1][1] = 11;
+        REQUIRE(copy != matrix);
+
+        auto moved = std::move(copy);
+        REQUIRE(moved.size() == 4);
+        REQUIRE(moved[1][1] == 11);
+        copy = matrix;
+        REQUIRE(copy == matrix);
+    }
+
+    SECTION("mutable iteration") {
+        for (auto element : matrix.mutable_elements()) {
+            int &value = std::get<2>(element);
+            value = value == 34 ? -1 : value * 2;
+        }
+        REQUIRE(matrix.size() == 2);
+        REQUIRE(matrix[63][0] == 1260);
+    }
+
+    SECTION("at() checks extents") {
+        REQUIRE(matrix.at({{63, 0}}) == 630);
+        REQUIRE_THROWS_AS(matrix.at({{64, 0}}), std::out_of_range);
+        REQUIRE_THROWS_AS(matrix.at({{0, 64}}) = 1, std::out_of_range);
+        REQUIRE(matrix.size() == 3);
+    }
+}
+
+TEST_CASE("Large fixed matrix selects storage by the density hint", "[matrix][extents]") {
+    using Extents = otus::Extents<512, 512>;
+    otus::Matrix<int, 0, 2, Extents> sparse;
+    otus::Matrix<int, 0, 2, Extents, otus::ExpectedDensity<50>> dense;
+    REQUIRE(sparse.max_load_factor() < 1.0f);
+    REQUIRE(dense.max_load_factor() == 1.0f);
+
+    std::mt19937_64 random{7};
+    for (int i = 0; i < 20000; ++i) {
+        const size_t row = random() % 512, column = random() % 512;
+        const int value = static_cast<int>(random() % 10);
+        sparse[row][column] = value;
+        dense[row][column] = value;
+    }
+    REQUIRE(sparse.size() == dense.size());
+    for (const auto element : sparse) {
+        REQUIRE(dense[std::get<0>(element)][std::get<1>(element)] == std::get<2>(element));
+    }
+    REQUIRE_THROWS_AS(sparse.at({{512, 0}}), std::out_of_range);
+}
+
+TEST_CASE("at() checks that indices fit into packed keys", "[matrix][packed]") {
+    otus::Matrix<int, 0, 2, otus::PackedKeys<uint16_t>> matrix;
+    matrix.at({{65535, 1}}) = 5;
+    REQUIRE(matrix[65535][1] == 5);
+    REQUIRE_THROWS_AS(matrix.at({{65536, 1}}), std::out_of_range);
+}
+
+TEST_CASE("DenseArray behaves like std::unordered_map", "[dense]") {
+    otus::DenseArray<uint64_t, int, 4096> dense;
+    std::unordered_map<uint64_t, int> reference;
+    std::mt19937_64 random{42};
+
+    for (int i = 0; i < 20000; ++i) {
+        const uint64_t key = random() % 4096;
+        if (random() % 3 == 0) {
+            REQUIRE(dense.erase(key) == reference.erase(key));
+        } else {
+            const int value = static_cast<int>(random() % 1000);
+            dense[key] = value;
+            reference[key] = value;
+        }
+    }
+
+    REQUIRE(dense.size() == reference.size());
+    for (const auto &element : reference) {
+        auto iter = dense.find(element.first);
+        REQUIRE(iter != dense.end());
+        REQUIRE(iter->second == element.second);
+        REQUIRE(dense.value_or(element.first, -1) == element.second);
+    }
+
+    SECTION("erase while iterating visits every element once") {
+        size_t visited = 0;
+        for (auto iter = dense.begin(); iter != dense.end();) {
+            ++visited;
+            iter = iter->second % 2 == 0 ? dense.erase(iter) : std::next(iter);
+        }
+        REQUIRE(visited == reference.size());
+        for (const auto &element : dense) {
+            REQUIRE(element.second % 2 != 0);
+        }
+    }
+
+    SECTION("elements are copied into std::unordered_map") {
+        static_assert(std::is_same<std::iterator_traits<decltype(dense.begin())>::iterator_category,
+                                   std::input_iterator_tag>::value,
+                      "DenseArray stashes the element in the iterator");
+        const std::unordered_map<uint64_t, int> copy(dense.begin(), dense.end());
+        REQUIRE(copy == reference);
+    }
+
+    SECTION("ranges of slots split elements between them") {
+        std::unordered_map<uint64_t, int> visited;
+        const std::vector<size_t> bounds{0, 1, 63, 64, 100, 1000, 4095, 5000};
+        for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+            const size_t first = bounds[i], last = bounds[i + 1];
+            dense.for_each_in_slots(first, last, [&](const auto &element) {
+                REQUIRE(element.first >= first);
+                REQUIRE(element.first < last);
+                REQUIRE(visited.emplace(element.first, element.second).second);
+            });
+        }
+        REQUIRE(visited == reference);
+    }
+
+    SECTION("clear removes all elements") {
+        dense.clear();
+        REQUIRE(dense.empty());
+        REQUIRE(dense.begin() == dense.end());
+        REQUIRE(dense.find(1) == dense.end());
+        REQUIRE(dense.value_or(1, -1) == -1);
+    }
+}
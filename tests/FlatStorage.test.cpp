@@ -0,0 +1,146 @@
+#include <catch2/catch.hpp>
+#include <otus/flat_hash_map.hpp>
+#include <otus/matrix.hpp>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+TEST_CASE("2D Matrix with flat storage", "[matrix][2D][flat]") {
+    constexpr int DEFAULT_VALUE = -1;
+    otus::Matrix<int, DEFAULT_VALUE, 2, otus::FlatStorage> matrix{
+        {std::make_tuple(14, 68), 52},
+        {std::make_tuple(139, 1), 871},
+        {std::make_tuple(71, 89), 51},
+    };
+
+    const auto start_size = matrix.size();
+    REQUIRE(matrix.size() == 3);
+
+    SECTION("Check operator[] for getting values from the matrix") {
+        REQUIRE(matrix[14][68] == 52);
+        REQUIRE(matrix[139][1] == 871);
+        REQUIRE(matrix[71][89] == 51);
+        REQUIRE(matrix[26][8] == DEFAULT_VALUE);
+    }
+
+    SECTION("Copy and move keep the elements") {
+        auto copyMatrix = matrix;
+        REQUIRE(copyMatrix == matrix);
+
+        auto moveMatrix = std::move(copyMatrix);
+        REQUIRE(moveMatrix == matrix);
+        REQUIRE(moveMatrix.size() == start_size);
+    }
+
+    SECTION("Assign and reset elements") {
+        matrix[100][100] = 314;
+        REQUIRE(matrix.size() == start_size + 1);
+        matrix[14][68] = DEFAULT_VALUE;
+        REQUIRE(matrix[14][68] == DEFAULT_VALUE);
+        REQUIRE(matrix.size() == start_size);
+    }
+
+    SECTION("Use for-range loop with the matrix") {
+        size_t counter = 0;
+        for (const auto element : matrix) {
+            size_t x, y;
+            int value;
+
+            std::tie(x, y, value) = element;
+            REQUIRE(matrix[x][y] == value);
+
+            ++counter;
+        }
+        REQUIRE(counter == start_size);
+    }
+}
+
+TEST_CASE("FlatHashMap behaves like std::unordered_map", "[flat]") {
+    otus::FlatHashMap<size_t, int> flat;
+    std::unordered_map<size_t, int> reference;
+    std::mt19937_64 random{42};
+
+    for (int i = 0; i < 20000; ++i) {
+        size_t key = random() % 4096;
+        if (random() % 3 == 0) {
+            REQUIRE(flat.erase(key) == reference.erase(key));
+        } else {
+            int value = static_cast<int>(random() % 1000);
+            flat[key] = value;
+            reference[key] = value;
+        }
+    }
+
+    REQUIRE(flat.size() == reference.size());
+    for (const auto &element : reference) {
+        auto iter = flat.find(element.first);
+        REQUIRE(iter != flat.end());
+        REQUIRE(iter->second == element.second);
+    }
+
+    SECTION("Erase while iterating visits every element once") {
+        size_t visited = 0;
+        for (auto iter = flat.begin(); iter != flat.end();) {
+            ++visited;
+            iter = (iter->second % 2 == 0) ? flat.erase(iter) : std::next(iter);
+        }
+        REQUIRE(visited == reference.size());
+        for (const auto &element : flat) {
+            REQUIRE(element.second % 2 != 0);
+        }
+    }
+
+    SECTION("Reserve keeps the elements") {
+        flat.reserve(100000);
+        REQUIRE(flat.bucket_count() * flat.max_load_factor() >= 100000);
+        REQUIRE(flat.size() == reference.size());
+        for (const auto &element : reference) {
+            REQUIRE(flat[element.first] == element.second);
+        }
+    }
+
+    SECTION("Clear removes all elements") {
+        flat.clear();
+        REQUIRE(flat.empty());
+        REQUIRE(flat.begin() == flat.end());
+        REQUIRE(flat.find(1) == flat.end());
+    }
+}
+
+namespace {
+
+/// Value which counts its instances and throws from the copy on demand
+struct CountedValue {
+    static int instances;
+    static int copies_left;
+
+    CountedValue() { ++instances; }
+    CountedValue(const CountedValue &) {
+        if (copies_left-- == 0) {
+            throw std::runtime_error("copy failed");
+        }
+        ++instances;
+    }
+    CountedValue &operator=(const CountedValue &) = default;
+    ~CountedValue() { --instances; }
+};
+
+int CountedValue::instances = 0;
+int CountedValue::copies_left = -1;
+
+} // namespace
+
+TEST_CASE("Failed copy of FlatHashMap releases copied values and slots", "[flat]") {
+    otus::FlatHashMap<size_t, CountedValue> flat;
+    for (size_t key = 0; key < 10; ++key) {
+        flat[key];
+    }
+    REQUIRE(CountedValue::instances == 10);
+
+    CountedValue::copies_left = 5;
+    using Map = otus::FlatHashMap<size_t, CountedValue>;
+    REQUIRE_THROWS_AS(Map(flat), std::runtime_error);
+    CountedValue::copies_left = -1;
+    REQUIRE(CountedValue::instances == 10);
+}
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <otus/matrix.hpp>
+#include <tuple>
+#include <vector>
+
+TEST_CASE("Matrix with selected hash policy", "[matrix][hash]") {
+    SECTION("MixHash with tuple keys") {
+        otus::Matrix<int, 0, 3, otus::MixHash> matrix;
+        for (size_t i = 0; i < 1000; ++i) {
+            matrix[i][i][i] = static_cast<int>(i) + 1;
+        }
+        REQUIRE(matrix.size() == 1000);
+        for (size_t i = 0; i < 1000; ++i) {
+            REQUIRE(matrix[i][i][i] == static_cast<int>(i) + 1);
+        }
+        REQUIRE(matrix[1][2][3] == 0);
+    }
+
+    SECTION("MixHash with packed keys and flat storage") {
+        otus::Matrix<int, 0, 2, otus::MixHash, otus::PackedKeys<uint32_t>, otus::FlatStorage>
+            matrix;
+        for (size_t i = 0; i < 1000; ++i) {
+            matrix[i][7 * i] = static_cast<int>(i) + 1;
+        }
+        REQUIRE(matrix.size() == 1000);
+        for (size_t i = 0; i < 1000; ++i) {
+            REQUIRE(matrix[i][7 * i] == static_cast<int>(i) + 1);
+        }
+    }
+
+    SECTION("TupleHash can be selected explicitly") {
+        otus::Matrix<int, 0, 2, otus::TupleHash> matrix{{std::make_tuple(1, 2), 3}};
+        REQUIRE(matrix[1][2] == 3);
+    }
+}
+
+TEST_CASE("MixHash spreads grid patterns over buckets", "[hash]") {
+    constexpr size_t buckets = 1024;
+    constexpr size_t count = 16 * buckets;
+    const otus::MixHash hash;
+
+    auto max_bucket_size = [&](auto make_key) {
+        std::vector<size_t> sizes(buckets);
+        for (size_t i = 0; i < count; ++i) {
+            ++sizes[hash(make_key(i)) % buckets];
+        }
+        return *std::max_element(sizes.begin(), sizes.end());
+    };
+
+    // 16 elements per bucket on average
+    REQUIRE(max_bucket_size([](size_t i) { return std::make_tuple(i, i); }) < 48);
+    REQUIRE(max_bucket_size([](size_t i) { return std::make_tuple(i, 1024 * i); }) < 48);
+    REQUIRE(max_bucket_size([](size_t i) { return std::make_tuple(i % 128, i / 128); }) < 48);
+    REQUIRE(max_bucket_size([](size_t i) { return std::make_tuple(i, i, i); }) < 48);
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+#include <otus/matrix.hpp>
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+TEST_CASE("Iterator gives references to keys and values", "[matrix][iterator]") {
+    using MatrixType = otus::Matrix<int, 0>;
+    using Iterator = decltype(std::declval<const MatrixType &>().begin());
+    using Reference = std::iterator_traits<Iterator>::reference;
+    // multipass, but tuples of references are not references to value_type
+    REQUIRE(std::is_same<std::iterator_traits<Iterator>::iterator_category,
+                         std::input_iterator_tag>::value);
+    REQUIRE(std::is_same<Reference,
+                         std::tuple<const size_t &, const size_t &, const int &>>::value);
+
+    MatrixType matrix;
+    matrix[1][2] = 3;
+    matrix[4][5] = 6;
+
+    SECTION("multiple passes see the same elements") {
+        auto first = matrix.begin();
+        auto second = first;
+        ++second;
+        REQUIRE(std::distance(matrix.begin(), matrix.end()) == 2);
+        REQUIRE(std::get<2>(*first) + std::get<2>(*second) == 9);
+        REQUIRE(&std::get<2>(*first) == &std::get<2>(*matrix.begin()));
+        REQUIRE(Iterator() == Iterator());
+    }
+
+    SECTION("elements are converted to tuples of values") {
+        std::vector<std::tuple<size_t, size_t, int>> elements(matrix.begin(), matrix.end());
+        std::sort(elements.begin(), elements.end());
+        REQUIRE(elements == std::vector<std::tuple<size_t, size_t, int>>{{1, 2, 3}, {4, 5, 6}});
+    }
+
+#if __cplusplus >= 201703L
+    SECTION("structured bindings") {
+        int sum = 0;
+        for (auto &&[i, j, value] : matrix) {
+            sum += static_cast<int>(i * 10 + j) * value;
+        }
+        REQUIRE(sum == 12 * 3 + 45 * 6);
+    }
+#endif
+}
+
+TEST_CASE("Iterator of packed keys decodes coordinates", "[matrix][iterator]") {
+    otus::Matrix<long, 0, 3, otus::PackedKeys<uint16_t>> matrix;
+    matrix[1][2][3] = 4;
+    using Reference = std::iterator_traits<decltype(matrix.begin())>::reference;
+    REQUIRE(std::is_same<Reference, std::tuple<size_t, size_t, size_t, const long &>>::value);
+
+    size_t x, y, z;
+    long value;
+    std::tie(x, y, z, value) = *matrix.begin();
+    REQUIRE(std::make_tuple(x, y, z, value) == std::make_tuple(1, 2, 3, 4));
+}
+
+TEMPLATE_TEST_CASE("Mutable iteration changes and removes elements", "[matrix][iterator]",
+                   otus::UnorderedStorage, otus::FlatStorage, otus::TiledStorage<>) {
+    using MatrixType = otus::Matrix<int, -1, 2, TestType, otus::OrderedIndex>;
+    MatrixType matrix;
+    for (size_t i = 0; i < 1000; ++i) {
+        matrix[i][i % 7] = static_cast<int>(i);
+    }
+    typename MatrixType::Journal journal;
+    matrix.attach(&journal);
+
+    SECTION("odd values are removed and others are doubled") {
+        size_t visited = 0;
+        for (auto element : matrix.mutable_elements()) {
+            int &value = std::get<2>(element);
+            value = value % 2 != 0 ? -1 : value * 2;
+            ++visited;
+        }
+        REQUIRE(visited == 1000);
+        REQUIRE(matrix.size() == 500);
+        for (const auto element : matrix) {
+            REQUIRE(std::get<2>(element) == static_cast<int>(std::get<0>(element)) * 2);
+        }
+        // the ordered index is consistent too
+        REQUIRE(std::distance(matrix.range({{0, 0}}, {{999, 6}}).begin(),
+                              matrix.range({{0, 0}}, {{999, 6}}).end()) == 500);
+        REQUIRE(journal.size() == 999); // (0, 0) keeps its value 0
+    }
+
+    SECTION("element where the traversal stops is checked") {
+        {
+            auto elements = matrix.mutable_elements();
+            auto iter = elements.begin();
+            std::get<2>(*iter) = -1;
+        }
+        REQUIRE(matrix.size() == 999);
+        REQUIRE(journal.size() == 1);
+        REQUIRE(journal.begin()->kind == otus::ChangeKind::erase);
+    }
+}
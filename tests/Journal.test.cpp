@@ -0,0 +1,230 @@
+#include <catch2/catch.hpp>
+#include <otus/matrix.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+/// Count of allocations which succeed before the next one throws std::bad_alloc
+size_t allocations_left = SIZE_MAX;
+
+} // namespace
+
+// allocations of the test fail on demand to check that changes are recorded or not done
+void *operator new(size_t size) {
+    if (allocations_left != SIZE_MAX) {
+        if (allocations_left == 0) {
+            throw std::bad_alloc();
+        }
+        --allocations_left;
+    }
+    if (void *memory = std::malloc(size != 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return operator new(size);
+    } catch (const std::bad_alloc &) {
+        return nullptr;
+    }
+}
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+TEMPLATE_TEST_CASE("Journal records changes of elements", "[matrix][journal]",
+                   otus::UnorderedStorage, otus::FlatStorage, otus::TiledStorage<>) {
+    using MatrixType = otus::Matrix<int, 0, 2, TestType>;
+    MatrixType matrix;
+    matrix[9][9] = 1; // before attaching
+    typename MatrixType::Journal journal;
+    matrix.attach(&journal);
+    REQUIRE(matrix.journal() == &journal);
+
+    matrix[1][2] = 5;
+    matrix[1][2] = 6;
+    matrix[3][4] += 2;
+    matrix[3][4] -= 2;
+    matrix[5][5] = 0; // nothing is changed
+    matrix[5][5] *= 3;
+    matrix.erase({{9, 9}});
+    matrix.erase({{9, 9}});
+
+    std::vector<std::tuple<otus::ChangeKind, size_t, size_t, int>> changes;
+    for (const auto &change : journal) {
+        changes.emplace_back(change.kind, change.indices[0], change.indices[1], change.value);
+    }
+    const std::vector<std::tuple<otus::ChangeKind, size_t, size_t, int>> expected = {
+        {otus::ChangeKind::insert, 1, 2, 5},
+        {otus::ChangeKind::update, 1, 2, 6},
+        {otus::ChangeKind::insert, 3, 4, 2},
+        {otus::ChangeKind::erase, 3, 4, 0},
+        {otus::ChangeKind::erase, 9, 9, 0},
+    };
+    REQUIRE(changes == expected);
+
+    SECTION("bulk insertion and clear") {
+        journal.clear();
+        const std::vector<std::tuple<size_t, size_t, int>> triplets = {
+            {1, 2, -6}, {7, 7, 1}, {7, 7, 2}, {8, 8, 0}};
+        matrix.insert_bulk(triplets.begin(), triplets.end(), otus::Sum{});
+        matrix.clear();
+        REQUIRE(journal.size() == 4);
+        auto iter = journal.begin();
+        REQUIRE(iter->kind == otus::ChangeKind::erase);
+        REQUIRE((++iter)->kind == otus::ChangeKind::insert);
+        REQUIRE((++iter)->kind == otus::ChangeKind::update);
+        REQUIRE(iter->value == 3);
+        REQUIRE((++iter)->kind == otus::ChangeKind::clear);
+    }
+
+    SECTION("assignments record the new contents") {
+        static_assert(!std::is_nothrow_move_assignable<MatrixType>::value,
+                      "recording of the assignment allocates");
+        MatrixType replica;
+        journal.replay(replica);
+        journal.clear();
+
+        MatrixType rebuilt;
+        rebuilt[2][2] = 22;
+        rebuilt[3][3] = 33;
+        matrix = rebuilt;
+        REQUIRE(journal.size() == 3); // clear and two insertions
+        rebuilt[4][4] = 44;
+        matrix = std::move(rebuilt);
+        REQUIRE(journal.size() == 7);
+        REQUIRE(journal.begin()->kind == otus::ChangeKind::clear);
+
+        journal.replay(replica);
+        REQUIRE(replica == matrix);
+        REQUIRE(replica.size() == 3);
+    }
+
+    SECTION("detached journal and copies of the matrix do not record") {
+        MatrixType copy = matrix;
+        REQUIRE(copy.journal() == nullptr);
+        copy[0][0] = 1;
+        matrix.attach(nullptr);
+        matrix[0][0] = 1;
+        REQUIRE(journal.size() == expected.size());
+    }
+}
+
+TEST_CASE("Replica follows the matrix by replayed deltas", "[matrix][journal]") {
+    using MatrixType = otus::Matrix<long, -1, 3, otus::OrderedIndex>;
+    MatrixType primary, replica;
+    MatrixType::Journal journal;
+    primary.attach(&journal);
+
+    for (size_t i = 0; i < 100; ++i) {
+        primary[i % 7][i % 5][i % 3] = static_cast<long>(i);
+    }
+    primary[0][0][0] = -1;
+    primary[1][1][1].update([](long value) { return value * 2; });
+
+    SECTION("drained journal is replayed") {
+        auto delta = journal.drain();
+        REQUIRE(journal.empty());
+        REQUIRE(delta.size() > 0);
+        delta.replay(replica);
+        REQUIRE(replica == primary);
+
+        primary = MatrixType{{{2, 2, 2}, 7}};
+        journal.drain().replay(replica);
+        REQUIRE(replica == primary);
+        REQUIRE(replica.size() == 1);
+    }
+
+    SECTION("serialized journal is replayed") {
+        std::stringstream stream;
+        journal.drain().serialize(stream);
+        auto delta = MatrixType::Journal::deserialize(stream);
+        delta.replay(replica);
+        REQUIRE(replica == primary);
+        REQUIRE(std::equal(replica.range({{0, 0, 0}}, {{9, 9, 9}}).begin(),
+                           replica.range({{0, 0, 0}}, {{9, 9, 9}}).end(),
+                           primary.range({{0, 0, 0}}, {{9, 9, 9}}).begin()));
+    }
+
+    SECTION("invalid stream is rejected") {
+        std::stringstream stream;
+        journal.serialize(stream);
+        const std::string bytes = stream.str();
+
+        std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+        REQUIRE_THROWS_AS(MatrixType::Journal::deserialize(truncated), std::runtime_error);
+        std::stringstream other(bytes);
+        REQUIRE_THROWS_AS((otus::ChangeJournal<long, 2>::deserialize(other)), std::runtime_error);
+        std::stringstream garbage("not a journal of the matrix at all");
+        REQUIRE_THROWS_AS(MatrixType::Journal::deserialize(garbage), std::runtime_error);
+    }
+}
+
+TEMPLATE_TEST_CASE("Failed allocations do not leave changes unrecorded", "[matrix][journal]",
+                   otus::UnorderedStorage, otus::FlatStorage, otus::TiledStorage<>,
+                   otus::OrderedIndex) {
+    using MatrixType = otus::Matrix<int, 0, 2, TestType>;
+    MatrixType base;
+    for (size_t i = 0; i < 20; ++i) {
+        base[i][i] = static_cast<int>(i) + 1;
+    }
+    const std::vector<std::tuple<size_t, size_t, int>> triplets{
+        {1, 1, 0}, {2, 2, 5}, {30, 30, 3}, {31, 31, 4}, {3, 3, -4}};
+
+    using Change = std::function<void(MatrixType &)>;
+    const std::vector<Change> changes{
+        [](MatrixType &matrix) { matrix[1][2] = 5; },
+        [](MatrixType &matrix) { matrix[3][3] = 7; },
+        [](MatrixType &matrix) { matrix[3][3] = 0; },
+        [](MatrixType &matrix) { matrix.erase({{4, 4}}); },
+        [](MatrixType &matrix) { matrix[5][6].update([](int value) { return value + 1; }); },
+        [](MatrixType &matrix) { matrix.update({{5, 5}}, [](int value) { return value - 6; }); },
+        [&triplets](MatrixType &matrix) {
+            matrix.insert_bulk(triplets.begin(), triplets.end(), otus::Sum{});
+        },
+        [](MatrixType &matrix) {
+            for (auto element : matrix.mutable_elements()) {
+                std::get<2>(element) = std::get<2>(element) % 3 == 0 ? 0 : 1;
+            }
+        },
+        [](MatrixType &matrix) { matrix.clear(); },
+        [](MatrixType &matrix) {
+            // more elements than in the matrix, so nodes of the index are not only reused
+            MatrixType other;
+            for (size_t i = 0; i < 30; ++i) {
+                other[i][i + 1] = static_cast<int>(i) + 1;
+            }
+            matrix = other;
+        },
+        [](MatrixType &matrix) { matrix = MatrixType{{{9, 9}, 99}}; },
+    };
+
+    for (const Change &change : changes) {
+        // fail each allocation of the change in turn until the change succeeds
+        bool done = false;
+        for (size_t budget = 0; !done; ++budget) {
+            MatrixType matrix = base, replica = base;
+            typename MatrixType::Journal journal;
+            matrix.attach(&journal);
+            allocations_left = budget;
+            try {
+                change(matrix);
+                done = true;
+            } catch (const std::bad_alloc &) {
+            }
+            allocations_left = SIZE_MAX;
+            journal.replay(replica);
+            REQUIRE(replica == matrix);
+        }
+    }
+}
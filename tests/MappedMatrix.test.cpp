@@ -0,0 +1,148 @@
+#include <catch2/catch.hpp>
+#include <otus/mapped_matrix.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+/// Name of the temporary file which is removed at the end of the scope
+struct TemporaryFile {
+    std::string path;
+
+    explicit TemporaryFile(const std::string &name) : path("otus_matrix_" + name + ".bin") {}
+    ~TemporaryFile() { std::remove(path.c_str()); }
+};
+
+} // namespace
+
+TEST_CASE("Save and load 2D matrix", "[matrix][mapped]") {
+    constexpr int DEFAULT_VALUE = -1;
+    using MatrixType = otus::Matrix<int, DEFAULT_VALUE>;
+    TemporaryFile file("2d");
+
+    MatrixType matrix;
+    matrix[5][7] = 57;
+    matrix[0][3] = 3;
+    matrix[5][2] = 52;
+    matrix[100][0] = 0;
+    otus::save(matrix, file.path);
+
+    SECTION("load makes the equal matrix") {
+        REQUIRE(otus::load<MatrixType>(file.path) == matrix);
+        using FlatMatrix = otus::Matrix<int, DEFAULT_VALUE, 2, otus::FlatStorage>;
+        const auto flat = otus::load<FlatMatrix>(file.path);
+        REQUIRE(flat.size() == 4);
+        REQUIRE(flat[5][2] == 52);
+    }
+
+    SECTION("mapped matrix answers lookups") {
+        const otus::MappedMatrix<int, DEFAULT_VALUE> mapped(file.path);
+        REQUIRE(mapped.size() == 4);
+        REQUIRE(mapped[5][7] == 57);
+        REQUIRE(mapped[5][2] == 52);
+        REQUIRE(mapped[0][3] == 3);
+        REQUIRE(mapped[100][0] == 0);
+        REQUIRE(mapped[5][3] == DEFAULT_VALUE);
+        REQUIRE(mapped[4][7] == DEFAULT_VALUE);
+        REQUIRE(mapped[1000][1000] == DEFAULT_VALUE);
+        REQUIRE(mapped.get({{5, 7}}) == 57);
+        REQUIRE(mapped.get({{6, 0}}) == DEFAULT_VALUE);
+    }
+
+    SECTION("mapped matrix iterates in lexicographic order") {
+        const otus::MappedMatrix<int, DEFAULT_VALUE> mapped(file.path);
+        std::vector<std::tuple<size_t, size_t, int>> elements;
+        for (const auto element : mapped) {
+            elements.emplace_back(element);
+        }
+        const std::vector<std::tuple<size_t, size_t, int>> expected{
+            {0, 3, 3}, {5, 2, 52}, {5, 7, 57}, {100, 0, 0}};
+        REQUIRE(elements == expected);
+    }
+}
+
+TEST_CASE("Save and load 3D matrix", "[matrix][mapped]") {
+    using MatrixType = otus::Matrix<long, 0, 3, otus::FlatStorage, otus::MixHash>;
+    TemporaryFile file("3d");
+
+    MatrixType matrix;
+    for (size_t i = 0; i < 1000; ++i) {
+        matrix[i % 7][i % 11][i] = static_cast<long>(i) + 1;
+    }
+    otus::save(matrix, file.path);
+    REQUIRE(otus::load<MatrixType>(file.path) == matrix);
+
+    const otus::MappedMatrix<long, 0, 3> mapped(file.path);
+    REQUIRE(mapped.size() == matrix.size());
+    for (size_t i = 0; i < 1000; ++i) {
+        REQUIRE(mapped[i % 7][i % 11][i] == static_cast<long>(i) + 1);
+        REQUIRE(mapped[i % 7][i % 11][i + 1] == 0);
+    }
+}
+
+TEST_CASE("Empty matrix is saved", "[matrix][mapped]") {
+    TemporaryFile file("empty");
+    otus::save(otus::Matrix<short, 0>(), file.path);
+
+    const otus::MappedMatrix<short, 0> mapped(file.path);
+    REQUIRE(mapped.size() == 0);
+    REQUIRE(mapped.begin() == mapped.end());
+    REQUIRE(mapped[1][1] == 0);
+    REQUIRE(otus::load<otus::Matrix<short, 0>>(file.path).size() == 0);
+}
+
+TEST_CASE("Files of other matrices are rejected", "[matrix][mapped]") {
+    TemporaryFile file("other");
+    otus::Matrix<int, 0> matrix;
+    matrix[1][1] = 1;
+    otus::save(matrix, file.path);
+
+    REQUIRE_THROWS_AS((otus::MappedMatrix<int, 1>(file.path)), std::runtime_error);
+    REQUIRE_THROWS_AS((otus::MappedMatrix<int, 0, 3>(file.path)), std::runtime_error);
+    REQUIRE_THROWS_AS((otus::MappedMatrix<long, 0>(file.path)), std::runtime_error);
+    REQUIRE_THROWS_AS((otus::load<otus::Matrix<int, 1>>(file.path)), std::runtime_error);
+    REQUIRE_THROWS_AS((otus::MappedMatrix<int, 0>("otus_matrix_missing.bin")),
+                      std::runtime_error);
+
+    {
+        std::ofstream text(file.path, std::ios::trunc);
+        text << "1 1 1\n";
+    }
+    REQUIRE_THROWS_AS((otus::MappedMatrix<int, 0>(file.path)), std::runtime_error);
+}
+
+TEST_CASE("Files with corrupt offsets are rejected", "[matrix][mapped]") {
+    TemporaryFile file("corrupt");
+    otus::Matrix<int, 0> matrix;
+    matrix[1][1] = 1;
+    matrix[2][2] = 2;
+
+    // rewrite the field of the header of the saved file
+    const auto corrupt = [&file, &matrix](size_t field, uint64_t value) {
+        otus::save(matrix, file.path);
+        std::fstream stream(file.path, std::ios::in | std::ios::out | std::ios::binary);
+        stream.seekp(static_cast<std::streamoff>(field));
+        stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    };
+    const size_t coordinates = offsetof(otus::detail::FileHeader, coordinates_offset);
+    const size_t values = offsetof(otus::detail::FileHeader, values_offset);
+
+    corrupt(coordinates, 0); // records over the header
+    REQUIRE_THROWS_AS((otus::MappedMatrix<int, 0>(file.path)), std::runtime_error);
+    // the end of records wraps around to 0
+    corrupt(coordinates, UINT64_MAX - 2 * 2 * sizeof(uint64_t) + 1);
+    REQUIRE_THROWS_AS((otus::MappedMatrix<int, 0>(file.path)), std::runtime_error);
+    // the end of values wraps around to 0
+    corrupt(values, UINT64_MAX - 2 * sizeof(int) + 1);
+    REQUIRE_THROWS_AS((otus::MappedMatrix<int, 0>(file.path)), std::runtime_error);
+    REQUIRE_THROWS_AS((otus::load<otus::Matrix<int, 0>>(file.path)), std::runtime_error);
+
+    otus::save(matrix, file.path);
+    REQUIRE(otus::MappedMatrix<int, 0>(file.path).size() == 2);
+}
@@ -56,6 +56,20 @@ TEST_CASE("2D Matrix operations", "[matrix][2D]") {
         REQUIRE(matrix[71][89] == 51);
     }
 
+    SECTION("Check direct access by all indices") {
+        REQUIRE(matrix(14, 68) == 52);
+        REQUIRE(matrix.at({139, 1}) == 871);
+
+        matrix(5, 6) = 56;
+        matrix.at({6, 5}) = 65;
+        REQUIRE(matrix[5][6] == 56);
+        REQUIRE(matrix[6][5] == 65);
+        REQUIRE(matrix.size() == start_size + 2);
+
+        matrix(5, 6) = DEFAULT_VALUE;
+        REQUIRE(matrix.size() == start_size + 1);
+    }
+
     SECTION("Clear elements in the matrix") {
         matrix.clear();
         REQUIRE(matrix[14][68] == DEFAULT_VALUE);
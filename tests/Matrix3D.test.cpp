@@ -58,6 +58,16 @@ TEST_CASE("Three dismension Matrix operations", "[matrix][3D]") {
         REQUIRE(matrix[92][32][7] == 840);
     }
 
+    SECTION("Check direct access by all indices") {
+        REQUIRE(matrix(1, 10, 123) == 10);
+        REQUIRE(matrix.at({13, 42, 18}) == 70);
+
+        matrix(3, 2, 1) = 321;
+        REQUIRE(matrix[3][2][1] == 321);
+        REQUIRE(matrix.at({3, 2, 1}) == 321);
+        REQUIRE(matrix.size() == start_size + 1);
+    }
+
     SECTION("Clear elements in the matrix") {
         matrix.clear();
         REQUIRE(matrix[1][10][123] == DEFAULT_VALUE);
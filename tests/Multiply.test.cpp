@@ -0,0 +1,96 @@
+#include <catch2/catch.hpp>
+#include <otus/multiply.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+/// Reference product of dense matrices
+template <typename MatrixType>
+std::vector<std::vector<long>> dense_product(const MatrixType &a, const MatrixType &b,
+                                             size_t rows, size_t inner, size_t columns) {
+    std::vector<std::vector<long>> result(rows, std::vector<long>(columns, 0));
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < columns; ++j) {
+            for (size_t k = 0; k < inner; ++k) {
+                result[i][j] += a[i][k] * b[k][j];
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Thread pool runs all chunks", "[thread_pool]") {
+    otus::ThreadPool pool(3);
+    REQUIRE(pool.concurrency() == 4);
+
+    std::vector<int> values(1000, 0);
+    pool.parallel_for(values.size(), [&values](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            values[i] += static_cast<int>(i);
+        }
+    });
+    for (size_t i = 0; i < values.size(); ++i) {
+        REQUIRE(values[i] == static_cast<int>(i));
+    }
+
+    REQUIRE_THROWS_AS(pool.parallel_for(100,
+                                        [](size_t first, size_t) {
+                                            if (first > 50) {
+                                                throw std::runtime_error("error");
+                                            }
+                                        }),
+                      std::runtime_error);
+}
+
+TEMPLATE_TEST_CASE("Multiply Matrix by vector and Matrix", "[matrix][multiply]",
+                   (std::integral_constant<long, 0>), (std::integral_constant<long, 2>)) {
+    constexpr long DEFAULT_VALUE = TestType::value;
+    using MatrixType = otus::Matrix<long, DEFAULT_VALUE>;
+    otus::ThreadPool pool(2);
+
+    MatrixType a, b;
+    for (size_t i = 0; i < 6; ++i) {
+        a[i][(i * 3) % 5] = static_cast<long>(i) + 3;
+        a[i][i % 5] = -static_cast<long>(i);
+        b[i % 5][i] = static_cast<long>(i) * 2 + 1;
+    }
+    a[2][4] = DEFAULT_VALUE;
+    b[4][2] = 7;
+
+    SECTION("Multiply by vector") {
+        const std::vector<long> x{1, -2, 3, 4, 5};
+        const auto y = otus::multiply(a, x, 7, pool);
+        REQUIRE(y.size() == 7);
+        for (size_t i = 0; i < y.size(); ++i) {
+            long expected = 0;
+            for (size_t j = 0; j < x.size(); ++j) {
+                expected += a[i][j] * x[j];
+            }
+            REQUIRE(y[i] == expected);
+        }
+    }
+
+    SECTION("Multiply by matrix") {
+        const auto product = otus::multiply(a, b, 7, 5, 6, pool);
+        const auto expected = dense_product(a, b, 7, 5, 6);
+        for (size_t i = 0; i < 7; ++i) {
+            for (size_t j = 0; j < 6; ++j) {
+                REQUIRE(product[i][j] == expected[i][j]);
+            }
+        }
+        for (const auto element : product) {
+            REQUIRE(std::get<0>(element) < 7);
+            REQUIRE(std::get<1>(element) < 6);
+        }
+    }
+
+    SECTION("Elements out of the shape") {
+        REQUIRE_THROWS_AS(otus::multiply(a, std::vector<long>(4, 1), 7, pool), std::out_of_range);
+        REQUIRE_THROWS_AS(otus::multiply(a, std::vector<long>(5, 1), 5, pool), std::out_of_range);
+        REQUIRE_THROWS_AS(otus::multiply(a, b, 7, 5, 5, pool), std::out_of_range);
+    }
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <otus/matrix.hpp>
+#include <tuple>
+
+TEST_CASE("2D Matrix with packed keys", "[matrix][2D][packed]") {
+    constexpr int DEFAULT_VALUE = 0;
+    using MatrixType = otus::Matrix<int, DEFAULT_VALUE, 2, otus::PackedKeys<uint32_t>>;
+    MatrixType matrix{
+        {std::make_tuple(14, 68), 52},
+        {std::make_tuple(0xffffffff, 1), 871},
+        {std::make_tuple(71, 0xffffffff), 51},
+    };
+
+    const auto start_size = matrix.size();
+    REQUIRE(matrix.size() == 3);
+
+    SECTION("Check operator[] for getting values from the matrix") {
+        REQUIRE(matrix[14][68] == 52);
+        REQUIRE(matrix[0xffffffff][1] == 871);
+        REQUIRE(matrix[71][0xffffffff] == 51);
+        REQUIRE(matrix[68][14] == DEFAULT_VALUE);
+    }
+
+    SECTION("Assign and reset elements") {
+        matrix[1][0] = 7;
+        matrix[0][1] = 8;
+        REQUIRE(matrix[1][0] == 7);
+        REQUIRE(matrix[0][1] == 8);
+        REQUIRE(matrix.size() == start_size + 2);
+
+        matrix[1][0] = DEFAULT_VALUE;
+        REQUIRE(matrix.size() == start_size + 1);
+    }
+
+    SECTION("Iteration decodes coordinates") {
+        size_t counter = 0;
+        for (const auto element : matrix) {
+            size_t x, y;
+            int value;
+
+            std::tie(x, y, value) = element;
+            REQUIRE(matrix[x][y] == value);
+
+            ++counter;
+        }
+        REQUIRE(counter == start_size);
+    }
+}
+
+TEST_CASE("3D and 4D Matrix with packed keys", "[matrix][3D][packed]") {
+    SECTION("Three 32-bit coordinates use 128-bit key") {
+        otus::Matrix<long, 1, 3, otus::PackedKeys<uint32_t>, otus::FlatStorage> matrix;
+        matrix[1][10][123] = 10;
+        matrix[123][10][1] = 20;
+        matrix[0xffffffff][0][0xffffffff] = 30;
+
+        REQUIRE(matrix.size() == 3);
+        REQUIRE(matrix[1][10][123] == 10);
+        REQUIRE(matrix[123][10][1] == 20);
+        REQUIRE(matrix[0xffffffff][0][0xffffffff] == 30);
+        REQUIRE(matrix[0][0][0] == 1);
+
+        long sum = 0;
+        for (const auto element : matrix) {
+            REQUIRE(matrix[std::get<0>(element)][std::get<1>(element)][std::get<2>(element)] ==
+                    std::get<3>(element));
+            sum += std::get<3>(element);
+        }
+        REQUIRE(sum == 60);
+    }
+
+    SECTION("Four 16-bit coordinates use 64-bit key") {
+        otus::Matrix<int, 0, 4, otus::PackedKeys<uint16_t>> matrix;
+        matrix[1][2][3][4] = 1234;
+        matrix[4][3][2][1] = 4321;
+        matrix[0xffff][0xffff][0xffff][0xffff] = -1;
+
+        REQUIRE(matrix.size() == 3);
+        REQUIRE(matrix[1][2][3][4] == 1234);
+        REQUIRE(matrix[4][3][2][1] == 4321);
+        REQUIRE(matrix[0xffff][0xffff][0xffff][0xffff] == -1);
+
+        matrix[4][3][2][1] = 0;
+        REQUIRE(matrix.size() == 2);
+    }
+}
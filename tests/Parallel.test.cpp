@@ -0,0 +1,80 @@
+#include <catch2/catch.hpp>
+#include <otus/matrix.hpp>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+TEMPLATE_TEST_CASE("Parallel traversal visits each element once", "[matrix][parallel]",
+                   otus::UnorderedStorage, otus::FlatStorage, otus::TiledStorage<>) {
+    using MatrixType = otus::Matrix<long, 0, 3, TestType, otus::MixHash>;
+    MatrixType matrix;
+    long expected_sum = 0;
+    for (size_t i = 0; i < 5000; ++i) {
+        matrix[i % 17][i % 31][i] = static_cast<long>(i) + 1;
+        expected_sum += static_cast<long>(i) + 1;
+    }
+    otus::ThreadPool pool(3);
+
+    SECTION("for_each") {
+        std::vector<std::atomic<int>> visits(5000);
+        std::atomic<long> sum{0};
+        matrix.parallel_for_each(
+            [&visits, &sum](const auto &element) {
+                ++visits[std::get<2>(element)];
+                sum += std::get<3>(element);
+            },
+            pool);
+        REQUIRE(sum == expected_sum);
+        REQUIRE(std::all_of(visits.begin(), visits.end(), [](const auto &n) { return n == 1; }));
+    }
+
+    SECTION("reduce of values") {
+        REQUIRE(matrix.parallel_reduce(0L, std::plus<>(), pool) == expected_sum);
+        REQUIRE(matrix.parallel_reduce(0L, [](long a, long b) { return std::max(a, b); }, pool) ==
+                5000);
+        REQUIRE(MatrixType().parallel_reduce(0L, std::plus<>(), pool) == 0);
+    }
+
+    SECTION("reduce of elements to histogram") {
+        using Histogram = std::vector<size_t>;
+        const Histogram histogram = matrix.parallel_reduce(
+            Histogram(17),
+            [](Histogram result, const auto &element) {
+                ++result[std::get<0>(element)];
+                return result;
+            },
+            [](Histogram lhs, const Histogram &rhs) {
+                std::transform(lhs.begin(), lhs.end(), rhs.begin(), lhs.begin(), std::plus<>());
+                return lhs;
+            },
+            pool);
+        for (size_t row = 0; row < 17; ++row) {
+            REQUIRE(histogram[row] == (5000 - row + 16) / 17);
+        }
+    }
+
+    SECTION("exception is rethrown") {
+        REQUIRE_THROWS_AS(matrix.parallel_for_each(
+                              [](const auto &element) {
+                                  if (std::get<2>(element) == 4999) {
+                                      throw std::runtime_error("stop");
+                                  }
+                              },
+                              pool),
+                          std::runtime_error);
+    }
+}
+
+TEST_CASE("Parallel reduce with the shared pool", "[matrix][parallel]") {
+    otus::Matrix<int, -1> matrix;
+    for (int i = 0; i < 100; ++i) {
+        matrix[static_cast<size_t>(i)][0] = i;
+    }
+    REQUIRE(matrix.parallel_reduce(0, std::plus<>()) == 4950);
+    REQUIRE(matrix.parallel_reduce(
+                size_t{0}, [](size_t count, const auto &) { return count + 1; }, std::plus<>()) ==
+            100);
+}
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <otus/matrix.hpp>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+/// Collect elements of the range into sorted vector
+template <typename Element, typename Range>
+std::vector<Element> collect(const Range &range) {
+    std::vector<Element> elements;
+    for (const auto element : range) {
+        elements.emplace_back(element);
+    }
+    std::sort(elements.begin(), elements.end());
+    return elements;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("Transposed view reads and writes elements of the matrix",
+                   "[matrix][permute]", otus::TupleKeys, otus::PackedKeys<uint32_t>,
+                   (otus::Extents<8, 8>)) {
+    using Element = std::tuple<size_t, size_t, int>;
+    otus::Matrix<int, -1, 2, TestType> matrix;
+    matrix[1][2] = 12;
+    matrix[3][4] = 34;
+    matrix[5][0] = 50;
+
+    auto transposed = matrix.transpose();
+    REQUIRE(transposed.size() == 3);
+    REQUIRE(transposed[2][1] == 12);
+    REQUIRE(transposed(4, 3) == 34);
+    REQUIRE(transposed[1][2] == -1);
+
+    transposed[0][7] = 70;
+    transposed[4][3] += 1;
+    transposed[2][1] = -1;
+    REQUIRE(matrix[7][0] == 70);
+    REQUIRE(matrix[3][4] == 35);
+    REQUIRE(matrix.size() == 3); // the default value removes the element
+    REQUIRE(transposed.size() == 3);
+
+    SECTION("iteration gives indices of the view") {
+        REQUIRE(collect<Element>(transposed) == std::vector<Element>{{0, 5, 50}, {0, 7, 70},
+                                                                     {4, 3, 35}});
+        REQUIRE(collect<Element>(transposed[0]) == std::vector<Element>{{0, 5, 50}, {0, 7, 70}});
+        REQUIRE(collect<Element>(transposed.range({{1, 0}}, {{5, 5}})) ==
+                std::vector<Element>{{4, 3, 35}});
+    }
+
+    SECTION("view of the const matrix is read only") {
+        const auto &const_matrix = matrix;
+        const auto view = const_matrix.transpose();
+        REQUIRE(view[0][7] == 70);
+        REQUIRE(view.at({{0, 5}}) == 50);
+        static_assert(!std::is_assignable<decltype(view[0][7]), int>::value, "");
+        static_assert(!std::is_assignable<decltype(const_matrix.transpose()(0, 7)), int>::value,
+                      "");
+        static_assert(std::is_assignable<decltype(transposed[0][7]), int>::value, "");
+    }
+
+    SECTION("transposed twice is the matrix") {
+        const auto copy = transposed.materialize();
+        REQUIRE(collect<Element>(copy.transpose()) == collect<Element>(matrix));
+    }
+
+    SECTION("materialized view is the transposed copy") {
+        const auto copy = transposed.materialize();
+        REQUIRE(copy.size() == 3);
+        REQUIRE(copy[0][7] == 70);
+        REQUIRE(copy[4][3] == 35);
+        matrix[5][0] = 1; // the copy does not follow the matrix
+        REQUIRE(copy[0][5] == 50);
+    }
+}
+
+TEST_CASE("Permuted view of the three dimension matrix", "[matrix][permute]") {
+    using Element = std::tuple<size_t, size_t, size_t, long>;
+    otus::Matrix<long, 0, 3, otus::OrderedIndex> matrix;
+    for (size_t x = 0; x < 4; ++x) {
+        for (size_t y = 0; y < 4; ++y) {
+            matrix[x][y][x + y] = static_cast<long>(x * 100 + y * 10 + x + y);
+        }
+    }
+
+    // the index on the axis k of the view is the index on the axis Axes[k] of the matrix
+    auto view = matrix.permute<2, 0, 1>();
+    REQUIRE(view[5][2][3] == 235);
+    REQUIRE(view.at({{5, 2, 3}}) == 235);
+    view[9][8][7] = 1;
+    REQUIRE(matrix[8][7][9] == 1);
+    view(9, 8, 7) *= 5;
+    REQUIRE(matrix[8][7][9] == 5);
+    REQUIRE(view.update({{9, 8, 7}}, [](long value) { return value - 5; }) == 0);
+    REQUIRE(matrix.size() == 15); // [0][0][0] is the default value
+
+    SECTION("iteration and slices of the view") {
+        for (const auto element : view) {
+            REQUIRE(std::get<0>(element) == std::get<1>(element) + std::get<2>(element));
+            REQUIRE(matrix[std::get<1>(element)][std::get<2>(element)][std::get<0>(element)] ==
+                    std::get<3>(element));
+        }
+        // the slice of the view by the first index is the slice by the last axis of the matrix
+        REQUIRE(collect<Element>(view[2]) ==
+                std::vector<Element>{{2, 0, 2, 22}, {2, 1, 1, 112}, {2, 2, 0, 202}});
+        REQUIRE(collect<Element>(view[3][1]) == std::vector<Element>{{3, 1, 2, 123}});
+    }
+
+    SECTION("reversed axes and materialization into other options") {
+        const auto reversed = matrix.transpose();
+        REQUIRE(reversed[3][2][1] == 123);
+        const auto copy = reversed.materialize<otus::Matrix<long, 0, 3, otus::FlatStorage>>();
+        REQUIRE(copy.size() == matrix.size());
+        for (const auto element : matrix) {
+            REQUIRE(copy[std::get<2>(element)][std::get<1>(element)][std::get<0>(element)] ==
+                    std::get<3>(element));
+        }
+    }
+}
+
+TEST_CASE("Views check bounds of indices in the matrix", "[matrix][permute]") {
+    otus::FixedMatrix<int, 0, otus::Extents<4, 16>> matrix;
+    auto view = matrix.transpose();
+    view.at({{15, 3}}) = 1;
+    REQUIRE(matrix[3][15] == 1);
+    REQUIRE_THROWS_AS(view.at({{3, 15}}), std::out_of_range);
+    REQUIRE_THROWS_AS(view.at({{16, 0}}) = 1, std::out_of_range);
+}
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <limits>
+#include <otus/matrix.hpp>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+/// Collect elements of the range into sorted vector
+template <typename Element = std::tuple<size_t, size_t, size_t, int>, typename Range>
+std::vector<Element> collect(const Range &range) {
+    std::vector<Element> elements;
+    for (auto iter = range.begin(); iter != range.end(); ++iter) {
+        elements.emplace_back(*iter);
+    }
+    std::sort(elements.begin(), elements.end());
+    return elements;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("Slices and ranges of Matrix", "[matrix][slice]", otus::NoIndex,
+                   otus::OrderedIndex) {
+    constexpr int DEFAULT_VALUE = 0;
+    using Element = std::tuple<size_t, size_t, size_t, int>;
+    otus::Matrix<int, DEFAULT_VALUE, 3, TestType> matrix;
+
+    for (size_t x = 0; x < 5; ++x) {
+        for (size_t y = 0; y < 5; ++y) {
+            matrix[x][y][x + y] = static_cast<int>(x * 10 + y);
+        }
+    }
+    matrix[0][0][0] = DEFAULT_VALUE;
+    REQUIRE(matrix.size() == 24);
+
+    SECTION("Slice by the first index") {
+        const auto elements = collect(matrix[2]);
+        REQUIRE(elements.size() == 5);
+        REQUIRE(elements.front() == Element{2, 0, 2, 20});
+        REQUIRE(elements.back() == Element{2, 4, 6, 24});
+        REQUIRE(collect(matrix[7]).empty());
+    }
+
+    SECTION("Slice by the first two indices") {
+        const auto &const_matrix = matrix;
+        REQUIRE(collect(const_matrix[3][1]) == std::vector<Element>{Element{3, 1, 4, 31}});
+        REQUIRE(collect(matrix[0][0]).empty());
+    }
+
+    SECTION("Slice follows inserts and erases") {
+        matrix[2][9][9] = 1;
+        matrix[2][0][2] = DEFAULT_VALUE;
+        matrix[2][1][3] += 1;
+        matrix[2][2][4] -= 22;
+        const auto elements = collect(matrix[2]);
+        REQUIRE(elements == std::vector<Element>{Element{2, 1, 3, 22}, Element{2, 3, 5, 23},
+                                                 Element{2, 4, 6, 24}, Element{2, 9, 9, 1}});
+
+        matrix.clear();
+        REQUIRE(collect(matrix[2]).empty());
+    }
+
+    SECTION("Box range query") {
+        const auto elements = collect(matrix.range({1, 2, 0}, {3, 3, 5}));
+        REQUIRE(elements == std::vector<Element>{Element{1, 2, 3, 12}, Element{1, 3, 4, 13},
+                                                 Element{2, 2, 4, 22}, Element{2, 3, 5, 23},
+                                                 Element{3, 2, 5, 32}});
+
+        REQUIRE(collect(matrix.range({0, 0, 0}, {9, 9, 9})).size() == matrix.size());
+        REQUIRE(collect(matrix.range({5, 0, 0}, {9, 9, 9})).empty());
+        REQUIRE(collect(matrix.range({2, 2, 2}, {1, 1, 1})).empty());
+    }
+
+    SECTION("Copy and bulk insert keep the index") {
+        auto copy = matrix;
+        const std::vector<Element> triplets{Element{4, 4, 8, -44}, Element{4, 7, 7, 1}};
+        copy.insert_bulk(triplets.begin(), triplets.end(), otus::Sum{});
+        REQUIRE(collect(copy[4]).size() == 5);
+        REQUIRE(collect(copy[4][4]).empty());
+        REQUIRE(collect(matrix[4]).size() == 5);
+    }
+}
+
+TEST_CASE("Range query with the largest indices", "[matrix][slice]") {
+    constexpr size_t max = std::numeric_limits<size_t>::max();
+    using Element = std::tuple<size_t, size_t, int>;
+    otus::Matrix<int, 0, 2, otus::OrderedIndex, otus::FlatStorage> matrix;
+    matrix[max][max] = 1;
+    matrix[max][0] = 2;
+    matrix[0][max] = 3;
+    REQUIRE(collect<Element>(matrix[max]).size() == 2);
+    REQUIRE(collect<Element>(matrix.range({1, 1}, {max, max})).size() == 1);
+    REQUIRE(collect<Element>(matrix.range({0, 1}, {max, max})).size() == 2);
+}
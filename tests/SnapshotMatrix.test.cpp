@@ -0,0 +1,114 @@
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <otus/snapshot_matrix.hpp>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Snapshot Matrix operations", "[matrix][snapshot]") {
+    constexpr int DEFAULT_VALUE = 0;
+    otus::SnapshotMatrix<int, DEFAULT_VALUE> matrix(4);
+    auto reader = matrix.reader();
+
+    SECTION("Changes are visible after publish") {
+        matrix.set({1, 2}, 12);
+        matrix.update({3, 4}, [](int value) { return value + 34; });
+        REQUIRE(reader.get({1, 2}) == DEFAULT_VALUE);
+
+        matrix.publish();
+        REQUIRE(reader.get({1, 2}) == 12);
+        REQUIRE(reader.pin()->size() == 2);
+
+        REQUIRE(matrix.erase({1, 2}) == 1);
+        matrix.write([](auto &draft) { draft[5][6] = 56; });
+        const auto snapshot = reader.pin();
+        REQUIRE(snapshot[1][2] == DEFAULT_VALUE);
+        REQUIRE(snapshot[5][6] == 56);
+        REQUIRE((*snapshot).size() == 2);
+    }
+
+    SECTION("Pinned snapshot is not reclaimed") {
+        matrix.set({1, 1}, 1);
+        matrix.publish();
+        {
+            const auto snapshot = reader.pin();
+            for (int version = 2; version < 10; ++version) {
+                matrix.set({1, 1}, version);
+                matrix.publish();
+            }
+            REQUIRE(snapshot[1][1] == 1);
+            REQUIRE(matrix.retired() == 8);
+        }
+        matrix.reclaim();
+        REQUIRE(matrix.retired() == 0);
+        REQUIRE(reader.get({1, 1}) == 9);
+    }
+
+    SECTION("Nested pins keep the first snapshot") {
+        matrix.set({1, 1}, 1);
+        matrix.publish();
+        const auto snapshot = reader.pin();
+        for (int version = 2; version < 5; ++version) {
+            matrix.set({1, 1}, version);
+            matrix.publish();
+            // get() pins and unpins the current snapshot inside
+            REQUIRE(reader.get({1, 1}) == version);
+            const auto inner = reader.pin();
+            matrix.set({1, 1}, version * 10);
+            matrix.publish();
+            REQUIRE(inner[1][1] == version);
+        }
+        matrix.reclaim();
+        REQUIRE(matrix.retired() == 6); // all snapshots published after the first pin
+        REQUIRE(snapshot[1][1] == 1);
+        REQUIRE(snapshot->at({{1, 1}}) == 1);
+    }
+
+    SECTION("Count of readers is limited") {
+        std::vector<decltype(matrix.reader())> readers;
+        for (int i = 0; i < 3; ++i) {
+            readers.push_back(matrix.reader());
+        }
+        REQUIRE_THROWS_AS(matrix.reader(), std::length_error);
+        readers.pop_back();
+        REQUIRE_NOTHROW(matrix.reader());
+    }
+}
+
+TEST_CASE("Snapshot Matrix with concurrent readers", "[matrix][snapshot]") {
+    otus::SnapshotMatrix<long, 0> matrix;
+    std::atomic<bool> done{false};
+    std::atomic<size_t> errors{0};
+
+    // Catch2 assertions are not thread safe, so readers only count errors
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&matrix, &done, &errors] {
+            auto reader = matrix.reader();
+            long last = 0;
+            while (!done.load()) {
+                const auto snapshot = reader.pin();
+                // the writer keeps both elements equal in each snapshot
+                const long value = snapshot[0][0];
+                if (value != snapshot[1][1] || value < last) {
+                    ++errors;
+                }
+                last = value;
+            }
+        });
+    }
+
+    for (long version = 1; version <= 1000; ++version) {
+        matrix.write([version](auto &draft) {
+            draft[0][0] = version;
+            draft[1][1] = version;
+        });
+    }
+    done.store(true);
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    REQUIRE(errors == 0);
+    matrix.reclaim();
+    REQUIRE(matrix.retired() == 0);
+}
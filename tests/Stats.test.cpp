@@ -0,0 +1,112 @@
+#include <catch2/catch.hpp>
+#include <otus/matrix.hpp>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+size_t histogram_sum(const std::vector<size_t> &histogram) {
+    return std::accumulate(histogram.begin(), histogram.end(), size_t{0});
+}
+
+} // namespace
+
+TEST_CASE("Counters of operations of the matrix", "[matrix][stats]") {
+    otus::Matrix<int, 0, 2, otus::CollectStats> matrix;
+
+    matrix[1][1] = 5;  // insert
+    matrix[1][1] = 6;  // update
+    matrix[2][2] = 0;  // absent element stays absent
+    matrix[3][3] = 7;  // insert
+    matrix[3][3] += 1; // update
+    matrix[4][4] += 1; // insert
+    int sum = matrix[1][1] + matrix[3][3] + matrix[9][9];
+    REQUIRE(sum == 14);
+    matrix[1][1] = 0; // erase by default
+    REQUIRE(matrix.erase({{3, 3}}) == 1);
+
+    auto stats = matrix.stats();
+    REQUIRE(stats.hits == 2);
+    REQUIRE(stats.misses == 1);
+    REQUIRE(stats.inserts == 3);
+    REQUIRE(stats.updates == 2);
+    REQUIRE(stats.erases == 2);
+    REQUIRE(stats.size == 1);
+
+    SECTION("growth of the storage is counted as rehash") {
+        const size_t rehashes = stats.rehashes;
+        for (int i = 0; i < 1000; ++i) {
+            matrix[i][i + 1] = i + 1;
+        }
+        REQUIRE(matrix.stats().rehashes > rehashes);
+    }
+
+    SECTION("mutable iteration counts updates and erases") {
+        matrix[5][5] = 2;
+        for (auto element : matrix.mutable_elements()) {
+            std::get<2>(element) = std::get<0>(element) == 4 ? 0 : 3;
+        }
+        stats = matrix.stats();
+        REQUIRE(stats.updates == 3);
+        REQUIRE(stats.erases == 3);
+    }
+
+    SECTION("reset and copies start from zero") {
+        const auto copy = matrix;
+        REQUIRE(copy.stats().inserts == 0);
+        matrix.reset_stats();
+        REQUIRE(matrix.stats().hits == 0);
+        REQUIRE(matrix.stats().inserts == 0);
+        REQUIRE(matrix.stats().size == 1);
+    }
+}
+
+TEMPLATE_TEST_CASE("Layout and memory of storages", "[matrix][stats]", otus::UnorderedStorage,
+                   otus::FlatStorage, otus::TiledStorage<>) {
+    otus::Matrix<long, 0, 2, TestType, otus::MixHash> matrix;
+    REQUIRE(histogram_sum(matrix.stats().probe_lengths) == 0);
+    for (size_t i = 0; i < 5000; ++i) {
+        matrix[i % 100][i / 100 * 7] = static_cast<long>(i + 1);
+    }
+
+    const auto stats = matrix.stats();
+    REQUIRE(stats.hits == 0); // counters need otus::CollectStats
+    REQUIRE(stats.inserts == 0);
+    REQUIRE(stats.size == 5000);
+    REQUIRE(stats.buckets > 0);
+    REQUIRE(stats.load_factor == matrix.load_factor());
+    REQUIRE_FALSE(stats.probe_lengths.empty());
+    REQUIRE(stats.probe_lengths[0] == 0);
+    REQUIRE(histogram_sum(stats.probe_lengths) == 5000);
+    if (!stats.bucket_lengths.empty()) {
+        REQUIRE(histogram_sum(stats.bucket_lengths) == stats.buckets);
+    }
+
+    const auto usage = matrix.memory_usage();
+    REQUIRE(usage.values == 5000 * sizeof(long));
+    REQUIRE(usage.keys > 0);
+    REQUIRE(usage.overhead > 0);
+    REQUIRE(usage.total() == usage.keys + usage.values + usage.overhead);
+
+    matrix.clear();
+    REQUIRE(histogram_sum(matrix.stats().probe_lengths) == 0);
+    REQUIRE(matrix.memory_usage().values == 0);
+}
+
+TEST_CASE("Memory of the dense array and of the index", "[matrix][stats]") {
+    otus::FixedMatrix<int, 0, otus::Extents<64, 64>> dense;
+    REQUIRE(dense.memory_usage().total() == 0); // the array is allocated by the first element
+    dense[1][2] = 3;
+    const auto usage = dense.memory_usage();
+    REQUIRE(usage.keys == 0);
+    REQUIRE(usage.values == sizeof(int));
+    REQUIRE(usage.total() == 64 * 64 * sizeof(int) + 64 * 64 / 8);
+    REQUIRE(dense.stats().probe_lengths == std::vector<size_t>{0, 1});
+
+    otus::Matrix<int, 0, 2> plain;
+    otus::Matrix<int, 0, 2, otus::OrderedIndex> indexed;
+    plain[1][2] = 3;
+    indexed[1][2] = 3;
+    REQUIRE(indexed.memory_usage().overhead > plain.memory_usage().overhead);
+}
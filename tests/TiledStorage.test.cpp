@@ -0,0 +1,188 @@
+#include <catch2/catch.hpp>
+#include <otus/matrix.hpp>
+#include <otus/tiled_map.hpp>
+#include <iterator>
+#include <map>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+TEST_CASE("2D Matrix with tiled storage", "[matrix][2D][tiled]") {
+    constexpr int DEFAULT_VALUE = -1;
+    otus::Matrix<int, DEFAULT_VALUE, 2, otus::TiledStorage<>> matrix{
+        {std::make_tuple(14, 68), 52},
+        {std::make_tuple(139, 1), 871},
+        {std::make_tuple(71, 89), 51},
+    };
+
+    const auto start_size = matrix.size();
+    REQUIRE(matrix.size() == 3);
+
+    SECTION("Check operator[] for getting values from the matrix") {
+        REQUIRE(matrix[14][68] == 52);
+        REQUIRE(matrix[139][1] == 871);
+        REQUIRE(matrix[71][89] == 51);
+        REQUIRE(matrix[26][8] == DEFAULT_VALUE);
+    }
+
+    SECTION("Copy and move keep the elements") {
+        auto copyMatrix = matrix;
+        REQUIRE(copyMatrix == matrix);
+
+        auto moveMatrix = std::move(copyMatrix);
+        REQUIRE(moveMatrix == matrix);
+        REQUIRE(moveMatrix.size() == start_size);
+    }
+
+    SECTION("Assign and reset elements") {
+        matrix[100][100] = 314;
+        REQUIRE(matrix.size() == start_size + 1);
+        matrix[14][68] = DEFAULT_VALUE;
+        REQUIRE(matrix[14][68] == DEFAULT_VALUE);
+        REQUIRE(matrix.size() == start_size);
+    }
+
+    SECTION("Use for-range loop with the matrix") {
+        size_t counter = 0;
+        for (const auto element : matrix) {
+            size_t x, y;
+            int value;
+
+            std::tie(x, y, value) = element;
+            REQUIRE(matrix[x][y] == value);
+
+            ++counter;
+        }
+        REQUIRE(counter == start_size);
+    }
+
+    SECTION("Copy elements into a vector") {
+        const std::vector<std::tuple<size_t, size_t, int>> elements(matrix.begin(), matrix.end());
+        REQUIRE(elements.size() == start_size);
+        for (const auto &element : elements) {
+            REQUIRE(matrix[std::get<0>(element)][std::get<1>(element)] == std::get<2>(element));
+        }
+    }
+}
+
+TEST_CASE("TiledMap converts tiles between sparse and dense", "[tiled]") {
+    using Map = otus::TiledMap<std::tuple<size_t, size_t>, int, 8, otus::TupleHash>;
+    REQUIRE(Map::extent == 8);
+    Map map;
+
+    // fill one tile of 8x8 cells and touch the neighbour tile
+    for (size_t i = 0; i < 8; ++i) {
+        for (size_t j = 0; j < 8; ++j) {
+            map[std::make_tuple(i, j)] = static_cast<int>(i * 8 + j);
+        }
+    }
+    map[std::make_tuple(8, 0)] = 100;
+    REQUIRE(map.size() == 65);
+    REQUIRE(map.tile_count() == 2);
+    REQUIRE(map.dense_tile_count() == 1);
+    REQUIRE(map.find(std::make_tuple(3, 5))->second == 29);
+    REQUIRE(map.find(std::make_tuple(8, 1)) == map.end());
+
+    SECTION("iteration visits cells of the dense tile in order") {
+        int expected = 0;
+        size_t visited = 0;
+        for (const auto &element : map) {
+            if (std::get<0>(element.first) < 8) {
+                REQUIRE(element.second == expected++);
+            }
+            ++visited;
+        }
+        REQUIRE(visited == 65);
+    }
+
+    SECTION("erase makes the tile sparse again and removes empty tiles") {
+        for (auto iter = map.begin(); iter != map.end();) {
+            iter = iter->second % 10 != 0 ? map.erase(iter) : std::next(iter);
+        }
+        REQUIRE(map.size() == 8);
+        REQUIRE(map.tile_count() == 2);
+        REQUIRE(map.dense_tile_count() == 0);
+        REQUIRE(map.find(std::make_tuple(1, 2))->second == 10);
+
+        REQUIRE(map.erase(std::make_tuple(8, 0)) == 1);
+        REQUIRE(map.erase(std::make_tuple(8, 0)) == 0);
+        REQUIRE(map.tile_count() == 1);
+    }
+
+    SECTION("entries are copied into a vector") {
+        using Iterator = Map::const_iterator;
+        static_assert(std::is_same<std::iterator_traits<Iterator>::iterator_category,
+                                   std::input_iterator_tag>::value,
+                      "TiledMap stashes the entry in the iterator");
+        std::vector<std::pair<std::tuple<size_t, size_t>, int>> entries;
+        const Map &const_map = map;
+        for (auto iter = const_map.begin(); iter != const_map.end(); ++iter) {
+            entries.emplace_back(iter->first, iter->second);
+        }
+        REQUIRE(entries.size() == 65);
+        for (const auto &entry : entries) {
+            REQUIRE(map.find(entry.first)->second == entry.second);
+        }
+    }
+
+    SECTION("values are assigned through iterators") {
+        for (auto iter = map.begin(); iter != map.end(); ++iter) {
+            iter->second = -iter->second.get();
+        }
+        REQUIRE(map.find(std::make_tuple(3, 5))->second == -29);
+    }
+}
+
+TEST_CASE("TiledMap behaves like std::map", "[tiled]") {
+    using Key = std::tuple<size_t, size_t, size_t>;
+    otus::TiledMap<Key, int, 0, otus::MixHash> tiled;
+    std::map<Key, int> reference;
+    std::mt19937_64 random{42};
+
+    // dense cube in the corner and sparse elements far away
+    for (int i = 0; i < 40000; ++i) {
+        const bool dense = random() % 2 == 0;
+        const size_t range = dense ? 12 : 1000000;
+        const Key key{random() % range, random() % range, random() % range};
+        if (random() % 3 == 0) {
+            REQUIRE(tiled.erase(key) == reference.erase(key));
+        } else {
+            const int value = static_cast<int>(random() % 1000);
+            tiled[key] = value;
+            reference[key] = value;
+        }
+    }
+
+    REQUIRE(tiled.size() == reference.size());
+    REQUIRE(tiled.dense_tile_count() > 0);
+    for (const auto &element : reference) {
+        auto iter = tiled.find(element.first);
+        REQUIRE(iter != tiled.end());
+        REQUIRE(iter->second == element.second);
+    }
+
+    SECTION("erase while iterating visits every element once") {
+        size_t visited = 0;
+        for (auto iter = tiled.begin(); iter != tiled.end();) {
+            ++visited;
+            iter = iter->second % 2 == 0 ? tiled.erase(iter) : std::next(iter);
+        }
+        REQUIRE(visited == reference.size());
+        for (const auto &element : tiled) {
+            REQUIRE(element.second % 2 != 0);
+        }
+    }
+
+    SECTION("copies are equal and clear removes all elements") {
+        auto copy = tiled;
+        REQUIRE(copy == tiled);
+        copy.begin()->second = -1;
+        REQUIRE(copy != tiled);
+
+        tiled.clear();
+        REQUIRE(tiled.empty());
+        REQUIRE(tiled.begin() == tiled.end());
+        REQUIRE(tiled.tile_count() == 0);
+    }
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+#include <otus/matrix.hpp>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+
+TEMPLATE_TEST_CASE("Compound assignment of Matrix elements", "[matrix][update]",
+                   otus::UnorderedStorage, otus::FlatStorage, otus::TiledStorage<>) {
+    constexpr long DEFAULT_VALUE = 1;
+    otus::Matrix<long, DEFAULT_VALUE, 2, TestType> matrix{
+        {std::make_tuple(1, 2), 10},
+        {std::make_tuple(3, 4), 20},
+    };
+
+    const auto start_size = matrix.size();
+    REQUIRE(matrix.size() == 2);
+
+    SECTION("Compound assignment of an existing element") {
+        matrix[1][2] += 5;
+        REQUIRE(matrix[1][2] == 15);
+        matrix[1][2] -= 3;
+        REQUIRE(matrix[1][2] == 12);
+        matrix[1][2] *= 2;
+        REQUIRE(matrix[1][2] == 24);
+        matrix[1][2] /= 4;
+        REQUIRE(matrix[1][2] == 6);
+        matrix[1][2] %= 4;
+        REQUIRE(matrix[1][2] == 2);
+        matrix[1][2] <<= 3;
+        REQUIRE(matrix[1][2] == 16);
+        matrix[1][2] >>= 1;
+        REQUIRE(matrix[1][2] == 8);
+        matrix[1][2] |= 3;
+        REQUIRE(matrix[1][2] == 11);
+        matrix[1][2] &= 6;
+        REQUIRE(matrix[1][2] == 2);
+        matrix[1][2] ^= 7;
+        REQUIRE(matrix[1][2] == 5);
+        REQUIRE(matrix.size() == start_size);
+    }
+
+    SECTION("Compound assignment of an empty element starts from the default value") {
+        matrix[5][6] += 2;
+        REQUIRE(matrix[5][6] == DEFAULT_VALUE + 2);
+        REQUIRE(matrix.size() == start_size + 1);
+
+        ((matrix[7][8] += 1) *= 10) -= 5;
+        REQUIRE(matrix[7][8] == 15);
+        REQUIRE(matrix.size() == start_size + 2);
+    }
+
+    SECTION("Result equal to the default value erases the element") {
+        matrix[1][2] -= 9;
+        REQUIRE(matrix[1][2] == DEFAULT_VALUE);
+        REQUIRE(matrix.size() == start_size - 1);
+
+        matrix[5][6] *= 1;
+        REQUIRE(matrix.size() == start_size - 1);
+    }
+
+    SECTION("Update element by function") {
+        REQUIRE(matrix.update({3, 4}, [](long value) { return value * value; }) == 400);
+        REQUIRE(matrix[3][4] == 400);
+
+        REQUIRE(matrix.update({9, 9}, [](long value) { return value + 41; }) == 42);
+        REQUIRE(matrix(9, 9) == 42);
+        REQUIRE(matrix.size() == start_size + 1);
+
+        REQUIRE(matrix[9][9].update([](long) { return DEFAULT_VALUE; }) == DEFAULT_VALUE);
+        REQUIRE(matrix.size() == start_size);
+    }
+
+    SECTION("Throwing function does not change the matrix") {
+        const auto copy = matrix;
+        const auto fail = [](long) -> long { throw std::runtime_error("update failed"); };
+        REQUIRE_THROWS_AS(matrix.update({7, 7}, fail), std::runtime_error);
+        REQUIRE_THROWS_AS(matrix[3][4].update(fail), std::runtime_error);
+        REQUIRE(matrix.size() == start_size);
+        REQUIRE(matrix == copy);
+        REQUIRE(std::distance(matrix.begin(), matrix.end()) ==
+                static_cast<ptrdiff_t>(start_size));
+    }
+}